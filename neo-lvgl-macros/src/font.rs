@@ -0,0 +1,102 @@
+//! `include_font!`: TTF/OTF subset to pre-rasterized glyph tables
+
+use crate::{bytes, error, Args};
+use proc_macro2::TokenStream;
+use quote::quote;
+
+pub fn expand(args: &Args) -> syn::Result<TokenStream> {
+    args.check(&["size", "chars", "bpp"])?;
+    let size = args
+        .int("size")?
+        .filter(|&s| s > 0)
+        .ok_or_else(|| error("`size = <pixels>` is required"))?;
+    let bpp = args.int("bpp")?.unwrap_or(4);
+    if bpp != 4 && bpp != 8 {
+        return Err(error("`bpp` must be 4 or 8"));
+    }
+    let chars = args
+        .string("chars")?
+        .unwrap_or_else(|| (' '..='~').collect());
+
+    let path = args.path()?;
+    let data = std::fs::read(&path).map_err(|e| error(format!("{}: {}", path.display(), e)))?;
+    let px = size as f32;
+    let font = fontdue::Font::from_bytes(
+        data.as_slice(),
+        fontdue::FontSettings {
+            scale: px,
+            ..Default::default()
+        },
+    )
+    .map_err(|e| error(format!("{}: {}", path.display(), e)))?;
+
+    let mut letters: Vec<char> = chars.chars().collect();
+    letters.sort_unstable();
+    letters.dedup();
+
+    let krate = &args.krate;
+    let mut glyphs = Vec::new();
+    let mut bitmaps: Vec<u8> = Vec::new();
+    for letter in letters {
+        if font.lookup_glyph_index(letter) == 0 && !letter.is_whitespace() {
+            return Err(syn::Error::new(
+                args.file.span(),
+                format!("font has no glyph for {:?}", letter),
+            ));
+        }
+        let (metrics, coverage) = font.rasterize(letter, px);
+        let offset = bitmaps.len() as u32;
+        let (w, h) = (metrics.width, metrics.height);
+        if bpp == 8 {
+            bitmaps.extend_from_slice(&coverage);
+        } else {
+            for row in coverage.chunks(w.max(1)).take(h) {
+                for pair in row.chunks(2) {
+                    let hi = pair[0] >> 4;
+                    let lo = pair.get(1).map_or(0, |&a| a >> 4);
+                    bitmaps.push(hi << 4 | lo);
+                }
+            }
+        }
+        let letter = letter as u32;
+        let adv_w = metrics.advance_width.round() as u16;
+        let (box_w, box_h) = (w as u16, h as u16);
+        let (ofs_x, ofs_y) = (metrics.xmin as i16, metrics.ymin as i16);
+        glyphs.push(quote! {
+            #krate::font::StaticGlyph {
+                letter: #letter,
+                adv_w: #adv_w,
+                box_w: #box_w,
+                box_h: #box_h,
+                ofs_x: #ofs_x,
+                ofs_y: #ofs_y,
+                offset: #offset,
+            }
+        });
+    }
+
+    let metrics = font
+        .horizontal_line_metrics(px)
+        .ok_or_else(|| error(format!("{}: no horizontal metrics", path.display())))?;
+    let line_height = (metrics.ascent - metrics.descent).ceil() as i32;
+    let base_line = (-metrics.descent).ceil() as i32;
+    let format = if bpp == 8 {
+        quote! { #krate::font::AtlasFormat::A8 }
+    } else {
+        quote! { #krate::font::AtlasFormat::A4 }
+    };
+
+    let glyph_count = glyphs.len();
+    let bitmap_len = bitmaps.len();
+    let init = bytes(&bitmaps);
+    let track = args.track(&path);
+    Ok(quote! {{
+        #track
+        static GLYPHS: [#krate::font::StaticGlyph; #glyph_count] = [#(#glyphs),*];
+        static BITMAPS: [u8; #bitmap_len] = #init;
+        static FONT: #krate::font::StaticFont = unsafe {
+            #krate::font::StaticFont::new(#line_height, #base_line, #format, &GLYPHS, &BITMAPS)
+        };
+        &FONT
+    }})
+}
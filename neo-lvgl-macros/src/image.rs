@@ -0,0 +1,166 @@
+//! `include_image!`: PNG to `lv_image_dsc_t`
+
+use crate::{bytes, error, rle, Args};
+use proc_macro2::TokenStream;
+use quote::{format_ident, quote};
+
+/// `LV_IMAGE_COMPRESS_RLE`
+const COMPRESS_RLE: u32 = 1;
+
+#[derive(Clone, Copy, PartialEq, Eq)]
+enum Format {
+    Rgb565,
+    Rgb565A8,
+    Rgb888,
+    Argb8888,
+    Xrgb8888,
+    L8,
+    A8,
+}
+
+impl Format {
+    fn parse(name: &str) -> Option<Self> {
+        Some(match name {
+            "RGB565" => Self::Rgb565,
+            "RGB565A8" => Self::Rgb565A8,
+            "RGB888" => Self::Rgb888,
+            "ARGB8888" => Self::Argb8888,
+            "XRGB8888" => Self::Xrgb8888,
+            "L8" => Self::L8,
+            "A8" => Self::A8,
+            _ => return None,
+        })
+    }
+
+    /// Name of the `lv_color_format_t` constant
+    fn lv_name(self) -> &'static str {
+        match self {
+            Self::Rgb565 => "RGB565",
+            Self::Rgb565A8 => "RGB565A8",
+            Self::Rgb888 => "RGB888",
+            Self::Argb8888 => "ARGB8888",
+            Self::Xrgb8888 => "XRGB8888",
+            Self::L8 => "L8",
+            Self::A8 => "A8",
+        }
+    }
+
+    /// Bytes per pixel of the (first) plane
+    fn bytes_per_pixel(self) -> usize {
+        match self {
+            Self::Rgb565 | Self::Rgb565A8 => 2,
+            Self::Rgb888 => 3,
+            Self::Argb8888 | Self::Xrgb8888 => 4,
+            Self::L8 | Self::A8 => 1,
+        }
+    }
+}
+
+pub fn expand(args: &Args) -> syn::Result<TokenStream> {
+    args.check(&["format", "rle"])?;
+    let format = match args.ident("format")? {
+        None => Format::Rgb565,
+        Some(name) => Format::parse(&name.to_string()).ok_or_else(|| {
+            syn::Error::new(
+                name.span(),
+                "expected RGB565, RGB565A8, RGB888, ARGB8888, XRGB8888, L8 or A8",
+            )
+        })?,
+    };
+    let compress = args.flag("rle")?;
+    if compress && format == Format::Rgb565A8 {
+        return Err(error("`rle` is not supported for RGB565A8"));
+    }
+
+    let path = args.path()?;
+    let (width, height, rgba) = decode_png(&path)?;
+    let stride = width * format.bytes_per_pixel();
+    let mut data = convert(format, &rgba);
+
+    let mut flags = quote! { 0 };
+    let krate = &args.krate;
+    if compress {
+        let packed = rle::compress(&data, format.bytes_per_pixel());
+        let mut blob = Vec::with_capacity(12 + packed.len());
+        blob.extend_from_slice(&COMPRESS_RLE.to_le_bytes());
+        blob.extend_from_slice(&(packed.len() as u32).to_le_bytes());
+        blob.extend_from_slice(&(data.len() as u32).to_le_bytes());
+        blob.extend_from_slice(&packed);
+        data = blob;
+        flags =
+            quote! { #krate::__private::sys::lv_image_flags_t_LV_IMAGE_FLAGS_COMPRESSED as u32 };
+    }
+
+    let cf = format_ident!("lv_color_format_t_LV_COLOR_FORMAT_{}", format.lv_name());
+    let len = data.len();
+    let init = bytes(&data);
+    let track = args.track(&path);
+    let (w, h, stride) = (width as u32, height as u32, stride as u32);
+    Ok(quote! {{
+        #track
+        static DATA: [u8; #len] = #init;
+        static IMAGE: #krate::asset::ImageAsset = unsafe {
+            #krate::asset::ImageAsset::new(
+                #krate::__private::sys::#cf as u32,
+                #flags,
+                #w,
+                #h,
+                #stride,
+                &DATA,
+            )
+        };
+        &IMAGE
+    }})
+}
+
+/// Decode any PNG into 8-bit RGBA
+fn decode_png(path: &std::path::Path) -> syn::Result<(usize, usize, Vec<u8>)> {
+    let fail = |e: &dyn std::fmt::Display| error(format!("{}: {}", path.display(), e));
+    let file = std::fs::File::open(path).map_err(|e| fail(&e))?;
+    let mut decoder = png::Decoder::new(file);
+    decoder.set_transformations(png::Transformations::normalize_to_color8());
+    let mut reader = decoder.read_info().map_err(|e| fail(&e))?;
+    let mut buf = vec![0; reader.output_buffer_size()];
+    let info = reader.next_frame(&mut buf).map_err(|e| fail(&e))?;
+    let (width, height) = (info.width as usize, info.height as usize);
+    if width > 0xFFFF || height > 0xFFFF {
+        return Err(fail(&"image too large for LVGL"));
+    }
+
+    let pixels = buf[..info.buffer_size()].chunks_exact(info.color_type.samples());
+    let rgba = match info.color_type {
+        png::ColorType::Grayscale => pixels.flat_map(|p| [p[0], p[0], p[0], 0xFF]).collect(),
+        png::ColorType::GrayscaleAlpha => pixels.flat_map(|p| [p[0], p[0], p[0], p[1]]).collect(),
+        png::ColorType::Rgb => pixels.flat_map(|p| [p[0], p[1], p[2], 0xFF]).collect(),
+        png::ColorType::Rgba => pixels.flat_map(|p| [p[0], p[1], p[2], p[3]]).collect(),
+        png::ColorType::Indexed => return Err(fail(&"palette was not expanded")),
+    };
+    Ok((width, height, rgba))
+}
+
+/// Convert RGBA pixels into LVGL's little-endian layout for `format`
+fn convert(format: Format, rgba: &[u8]) -> Vec<u8> {
+    let pixels = rgba.chunks_exact(4);
+    let rgb565 = |p: &[u8]| {
+        let v = (u16::from(p[0] >> 3) << 11) | (u16::from(p[1] >> 2) << 5) | u16::from(p[2] >> 3);
+        v.to_le_bytes()
+    };
+    match format {
+        Format::Rgb565 => pixels.flat_map(rgb565).collect(),
+        Format::Rgb565A8 => {
+            // Color plane, then an A8 plane with half the stride
+            let mut out: Vec<u8> = pixels.clone().flat_map(rgb565).collect();
+            out.extend(pixels.map(|p| p[3]));
+            out
+        }
+        Format::Rgb888 => pixels.flat_map(|p| [p[2], p[1], p[0]]).collect(),
+        Format::Argb8888 => pixels.flat_map(|p| [p[2], p[1], p[0], p[3]]).collect(),
+        Format::Xrgb8888 => pixels.flat_map(|p| [p[2], p[1], p[0], 0xFF]).collect(),
+        Format::L8 => pixels
+            .map(|p| {
+                ((u32::from(p[0]) * 77 + u32::from(p[1]) * 150 + u32::from(p[2]) * 29) >> 8) as u8
+            })
+            .collect(),
+        Format::A8 => pixels.map(|p| p[3]).collect(),
+    }
+}
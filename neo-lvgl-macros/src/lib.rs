@@ -0,0 +1,206 @@
+//! Compile-time asset conversion for neo-lvgl
+//!
+//! Use the `include_image!`, `include_font!` and `include_ui!` wrappers
+//! exported by `neo-lvgl` (feature `assets`); they pass the `neo-lvgl` crate
+//! path as the first argument so the generated code works under any crate
+//! name.
+
+use proc_macro::TokenStream;
+use proc_macro2::{Literal, Span, TokenStream as TokenStream2};
+use quote::quote;
+use std::path::PathBuf;
+use syn::parse::{Parse, ParseStream};
+use syn::{Ident, LitInt, LitStr, Path, Token};
+
+mod font;
+mod image;
+mod rle;
+mod ui;
+
+/// Convert a PNG into a static `ImageAsset`
+#[proc_macro]
+pub fn include_image(input: TokenStream) -> TokenStream {
+    expand(input, image::expand)
+}
+
+/// Rasterize a font subset into a static `StaticFont`
+#[proc_macro]
+pub fn include_font(input: TokenStream) -> TokenStream {
+    expand(input, font::expand)
+}
+
+/// Compile XML components into a static `CompiledUi`
+#[proc_macro]
+pub fn include_ui(input: TokenStream) -> TokenStream {
+    expand(input, ui::expand)
+}
+
+fn expand(input: TokenStream, f: fn(&Args) -> syn::Result<TokenStream2>) -> TokenStream {
+    let args = match syn::parse::<Args>(input) {
+        Ok(args) => args,
+        Err(e) => return e.to_compile_error().into(),
+    };
+    f(&args).unwrap_or_else(|e| e.to_compile_error()).into()
+}
+
+/// `$crate; "path", key = value, flag, ...`
+pub(crate) struct Args {
+    pub krate: Path,
+    pub file: LitStr,
+    pub options: Vec<(Ident, Option<Value>)>,
+}
+
+pub(crate) enum Value {
+    Str(LitStr),
+    Int(LitInt),
+    Ident(Ident),
+}
+
+impl Parse for Args {
+    fn parse(input: ParseStream) -> syn::Result<Self> {
+        let krate = input.parse()?;
+        input.parse::<Token![;]>()?;
+        let file = input.parse()?;
+        let mut options = Vec::new();
+        while input.parse::<Option<Token![,]>>()?.is_some() && !input.is_empty() {
+            let key: Ident = input.parse()?;
+            let value = if input.parse::<Option<Token![=]>>()?.is_some() {
+                let lookahead = input.lookahead1();
+                Some(if lookahead.peek(LitStr) {
+                    Value::Str(input.parse()?)
+                } else if lookahead.peek(LitInt) {
+                    Value::Int(input.parse()?)
+                } else if lookahead.peek(Ident) {
+                    Value::Ident(input.parse()?)
+                } else {
+                    return Err(lookahead.error());
+                })
+            } else {
+                None
+            };
+            options.push((key, value));
+        }
+        if !input.is_empty() {
+            return Err(input.error("expected `,`"));
+        }
+        Ok(Self {
+            krate,
+            file,
+            options,
+        })
+    }
+}
+
+impl Args {
+    /// Asset path relative to the calling crate's manifest
+    pub fn path(&self) -> syn::Result<PathBuf> {
+        resolve(&self.file)
+    }
+
+    /// Path given by a string option, like [`Args::path`]
+    pub fn path_option(&self, name: &str) -> syn::Result<Option<PathBuf>> {
+        self.lit(name)?.map(resolve).transpose()
+    }
+
+    /// Reject options not in `known`
+    pub fn check(&self, known: &[&str]) -> syn::Result<()> {
+        for (key, _) in &self.options {
+            if !known.contains(&key.to_string().as_str()) {
+                return Err(syn::Error::new(
+                    key.span(),
+                    format!(
+                        "unknown option `{}`, expected one of: {}",
+                        key,
+                        known.join(", ")
+                    ),
+                ));
+            }
+        }
+        Ok(())
+    }
+
+    pub fn value(&self, name: &str) -> Option<(&Ident, Option<&Value>)> {
+        self.options
+            .iter()
+            .find(|(key, _)| key == name)
+            .map(|(key, value)| (key, value.as_ref()))
+    }
+
+    pub fn flag(&self, name: &str) -> syn::Result<bool> {
+        match self.value(name) {
+            None => Ok(false),
+            Some((_, None)) => Ok(true),
+            Some((key, Some(_))) => Err(syn::Error::new(
+                key.span(),
+                format!("`{}` takes no value", key),
+            )),
+        }
+    }
+
+    pub fn int(&self, name: &str) -> syn::Result<Option<u32>> {
+        match self.value(name) {
+            None => Ok(None),
+            Some((_, Some(Value::Int(lit)))) => lit.base10_parse().map(Some),
+            Some((key, _)) => Err(syn::Error::new(
+                key.span(),
+                format!("`{}` expects a number", key),
+            )),
+        }
+    }
+
+    pub fn lit(&self, name: &str) -> syn::Result<Option<&LitStr>> {
+        match self.value(name) {
+            None => Ok(None),
+            Some((_, Some(Value::Str(lit)))) => Ok(Some(lit)),
+            Some((key, _)) => Err(syn::Error::new(
+                key.span(),
+                format!("`{}` expects a string", key),
+            )),
+        }
+    }
+
+    pub fn string(&self, name: &str) -> syn::Result<Option<String>> {
+        Ok(self.lit(name)?.map(LitStr::value))
+    }
+
+    pub fn ident(&self, name: &str) -> syn::Result<Option<&Ident>> {
+        match self.value(name) {
+            None => Ok(None),
+            Some((_, Some(Value::Ident(ident)))) => Ok(Some(ident)),
+            Some((key, _)) => Err(syn::Error::new(
+                key.span(),
+                format!("`{}` expects a name", key),
+            )),
+        }
+    }
+
+    /// `include_bytes!` of the source so the caller rebuilds when it changes
+    pub fn track(&self, path: &std::path::Path) -> TokenStream2 {
+        let path = path.to_string_lossy();
+        quote! { const _: &[u8] = include_bytes!(#path); }
+    }
+}
+
+fn resolve(lit: &LitStr) -> syn::Result<PathBuf> {
+    let root = std::env::var_os("CARGO_MANIFEST_DIR")
+        .map(PathBuf::from)
+        .unwrap_or_default();
+    let path = root.join(lit.value());
+    if !path.exists() {
+        return Err(syn::Error::new(
+            lit.span(),
+            format!("asset not found: {}", path.display()),
+        ));
+    }
+    Ok(path)
+}
+
+/// A `[u8; N]` initializer
+pub(crate) fn bytes(data: &[u8]) -> TokenStream2 {
+    let lit = Literal::byte_string(data);
+    quote! { *#lit }
+}
+
+pub(crate) fn error(message: impl std::fmt::Display) -> syn::Error {
+    syn::Error::new(Span::call_site(), message)
+}
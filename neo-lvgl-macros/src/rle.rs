@@ -0,0 +1,79 @@
+//! LVGL's RLE image compression (`lv_rle.c`)
+//!
+//! The stream is a sequence of control bytes over `block`-byte pixels: with
+//! bit 7 set, the low 7 bits count literal pixels that follow; otherwise the
+//! byte counts repetitions of the one pixel that follows.
+
+/// Shortest run worth a repeat packet
+const MIN_RUN: usize = 3;
+const MAX_COUNT: usize = 127;
+
+/// Compress `data` (a whole number of `block`-byte pixels)
+pub fn compress(data: &[u8], block: usize) -> Vec<u8> {
+    let pixels: Vec<&[u8]> = data.chunks_exact(block).collect();
+    let run_at = |i: usize| {
+        pixels[i..]
+            .iter()
+            .take(MAX_COUNT)
+            .take_while(|&&p| p == pixels[i])
+            .count()
+    };
+
+    let mut out = Vec::with_capacity(data.len() / 2);
+    let mut i = 0;
+    while i < pixels.len() {
+        let run = run_at(i);
+        if run >= MIN_RUN {
+            out.push(run as u8);
+            out.extend_from_slice(pixels[i]);
+            i += run;
+            continue;
+        }
+        let start = i;
+        while i < pixels.len() && i - start < MAX_COUNT && run_at(i) < MIN_RUN {
+            i += 1;
+        }
+        out.push(0x80 | (i - start) as u8);
+        for pixel in &pixels[start..i] {
+            out.extend_from_slice(pixel);
+        }
+    }
+    out
+}
+
+#[cfg(test)]
+mod tests {
+    use super::compress;
+
+    /// Mirror of `lv_rle_decompress`
+    fn decompress(mut input: &[u8], block: usize) -> Vec<u8> {
+        let mut out = Vec::new();
+        while let Some((&ctrl, rest)) = input.split_first() {
+            let count = (ctrl & 0x7F) as usize;
+            if ctrl & 0x80 != 0 {
+                out.extend_from_slice(&rest[..count * block]);
+                input = &rest[count * block..];
+            } else {
+                for _ in 0..count {
+                    out.extend_from_slice(&rest[..block]);
+                }
+                input = &rest[block..];
+            }
+        }
+        out
+    }
+
+    #[test]
+    fn round_trip() {
+        let mut data = Vec::new();
+        for i in 0..1000u32 {
+            let v = if i % 300 < 200 { 7 } else { (i * 31) as u16 };
+            data.extend_from_slice(&v.to_le_bytes());
+        }
+        for block in [1, 2, 4] {
+            let packed = compress(&data, block);
+            assert_eq!(decompress(&packed, block), data);
+        }
+        assert!(compress(&data, 2).len() < data.len() / 2);
+    }
+}
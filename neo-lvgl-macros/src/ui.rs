@@ -0,0 +1,411 @@
+//! `include_ui!`: XML components to static node tables
+//!
+//! Each component's `<view>` is flattened into a preorder node array with
+//! constants substituted and `$props` turned into indices, so the runtime
+//! only has to call `lv_xml_create` per element. Components that use
+//! sections which need the parser's scope are passed through as XML.
+
+use crate::{error, Args};
+use proc_macro2::{Literal, TokenStream};
+use quick_xml::events::{BytesStart, Event};
+use quote::quote;
+use std::collections::BTreeMap;
+use std::ffi::CString;
+use std::path::{Path, PathBuf};
+
+/// Component sections the compiler understands
+const COMPILED_SECTIONS: &[&str] = &["consts", "api", "view", "previews"];
+
+struct Element {
+    name: String,
+    attrs: Vec<(String, String)>,
+    children: Vec<Element>,
+}
+
+impl Element {
+    fn attr(&self, name: &str) -> Option<&str> {
+        self.attrs
+            .iter()
+            .find(|(key, _)| key == name)
+            .map(|(_, value)| value.as_str())
+    }
+
+    fn child(&self, name: &str) -> Option<&Element> {
+        self.children.iter().find(|c| c.name == name)
+    }
+}
+
+struct Source {
+    name: String,
+    path: PathBuf,
+    text: String,
+    root: Element,
+}
+
+impl Source {
+    fn load(path: &Path) -> syn::Result<Self> {
+        let fail = |e: &dyn std::fmt::Display| error(format!("{}: {}", path.display(), e));
+        let text = std::fs::read_to_string(path).map_err(|e| fail(&e))?;
+        let root = parse(&text).map_err(|e| fail(&e))?;
+        let name = path
+            .file_stem()
+            .map(|s| s.to_string_lossy().into_owned())
+            .unwrap_or_default();
+        Ok(Self {
+            name,
+            path: path.to_owned(),
+            text,
+            root,
+        })
+    }
+
+    /// `name`/`value` pairs of the `<consts>` section
+    fn consts(&self) -> impl Iterator<Item = (&str, &str)> {
+        let consts = self.root.child("consts").map(|c| c.children.as_slice());
+        consts
+            .unwrap_or_default()
+            .iter()
+            .filter_map(|c| Some((c.attr("name")?, c.attr("value")?)))
+    }
+
+    /// Whether every section can be compiled
+    fn compilable(&self, allowed: &[&str]) -> bool {
+        self.root
+            .children
+            .iter()
+            .all(|c| allowed.contains(&c.name.as_str()))
+    }
+}
+
+fn parse(text: &str) -> Result<Element, String> {
+    let mut reader = quick_xml::Reader::from_str(text);
+    reader.config_mut().trim_text(true);
+    let mut stack: Vec<Element> = Vec::new();
+    let mut root = None;
+    let mut finish = |stack: &mut Vec<Element>, element: Element| match stack.last_mut() {
+        Some(parent) => parent.children.push(element),
+        None => root = Some(element),
+    };
+    loop {
+        match reader.read_event().map_err(|e| e.to_string())? {
+            Event::Start(start) => stack.push(element(&start)?),
+            Event::Empty(start) => {
+                let element = element(&start)?;
+                finish(&mut stack, element);
+            }
+            Event::End(_) => {
+                let element = stack.pop().ok_or("unbalanced end tag")?;
+                finish(&mut stack, element);
+            }
+            Event::Eof => break,
+            _ => {}
+        }
+    }
+    root.ok_or_else(|| "no root element".into())
+}
+
+fn element(start: &BytesStart) -> Result<Element, String> {
+    let mut attrs = Vec::new();
+    for attr in start.attributes() {
+        let attr = attr.map_err(|e| e.to_string())?;
+        let key = String::from_utf8_lossy(attr.key.as_ref()).into_owned();
+        let value = attr.unescape_value().map_err(|e| e.to_string())?;
+        attrs.push((key, value.into_owned()));
+    }
+    Ok(Element {
+        name: String::from_utf8_lossy(start.name().as_ref()).into_owned(),
+        attrs,
+        children: Vec::new(),
+    })
+}
+
+/// `*.xml` files below `dir`, sorted
+fn collect(dir: &Path, out: &mut Vec<PathBuf>) -> std::io::Result<()> {
+    let mut entries: Vec<PathBuf> = std::fs::read_dir(dir)?
+        .map(|e| e.map(|e| e.path()))
+        .collect::<Result<_, _>>()?;
+    entries.sort();
+    for path in entries {
+        if path.is_dir() {
+            collect(&path, out)?;
+        } else if path.extension().is_some_and(|e| e == "xml") {
+            out.push(path);
+        }
+    }
+    Ok(())
+}
+
+fn cstr(value: &str) -> syn::Result<Literal> {
+    let value = CString::new(value).map_err(|_| error(format!("NUL byte in {:?}", value)))?;
+    Ok(Literal::c_string(&value))
+}
+
+/// Names referenced by the compiled views
+#[derive(Default)]
+struct Refs {
+    fonts: Vec<String>,
+    subjects: Vec<String>,
+}
+
+impl Refs {
+    fn note(&mut self, key: &str, value: &str) {
+        if key.ends_with("_font") {
+            self.fonts.push(value.to_owned());
+        } else if key == "subject" || key.starts_with("bind_") {
+            if let Some(subject) = value.split_whitespace().next() {
+                self.subjects.push(subject.to_owned());
+            }
+        }
+    }
+}
+
+struct Compiler<'a> {
+    krate: &'a syn::Path,
+    globals: &'a BTreeMap<String, String>,
+    /// Sorted names of the compiled components
+    names: Vec<&'a str>,
+    refs: Refs,
+}
+
+impl Compiler<'_> {
+    /// The component initializer and the limit checks for it
+    fn component(&mut self, source: &Source) -> syn::Result<(TokenStream, TokenStream)> {
+        let fail = |message: String| error(format!("{}: {}", source.path.display(), message));
+        let mut consts = self.globals.clone();
+        for (name, value) in source.consts() {
+            consts.insert(name.to_owned(), value.to_owned());
+        }
+
+        let mut props = Vec::new();
+        let mut defaults = Vec::new();
+        let api = source.root.child("api").map(|a| a.children.as_slice());
+        for prop in api.unwrap_or_default().iter().filter(|c| c.name == "prop") {
+            let name = prop
+                .attr("name")
+                .ok_or_else(|| fail("<prop> without name".into()))?;
+            let default = match prop.attr("default") {
+                Some(value) => Some(resolve_const(&consts, value).map_err(&fail)?),
+                None => None,
+            };
+            props.push(name.to_owned());
+            defaults.push(default);
+        }
+
+        let view = source
+            .root
+            .child("view")
+            .ok_or_else(|| fail("no <view>".into()))?;
+        let mut nodes = Vec::new();
+        let mut max_attrs = 0;
+        self.node(view, &consts, &props, &mut nodes, &mut max_attrs)
+            .map_err(fail)?;
+
+        let krate = self.krate;
+        let name = cstr(&source.name)?;
+        let prop_count = props.len();
+        let props = props
+            .iter()
+            .zip(&defaults)
+            .map(|(name, default)| {
+                let name = cstr(name)?;
+                Ok(match default {
+                    Some(value) => {
+                        let value = cstr(value)?;
+                        quote! { (#name, Some(#value)) }
+                    }
+                    None => quote! { (#name, None) },
+                })
+            })
+            .collect::<syn::Result<Vec<_>>>()?;
+        let message = format!("{}: too many props", source.name);
+        let attrs_message = format!("{}: too many attributes on one element", source.name);
+        let checks = quote! {
+            const _: () = assert!(#prop_count <= #krate::xml::__MAX_PROPS, #message);
+            const _: () = assert!(#max_attrs <= #krate::xml::__MAX_ATTRS, #attrs_message);
+        };
+        let component = quote! {
+            #krate::xml::CompiledComponent {
+                name: #name,
+                props: &[#(#props),*],
+                nodes: &[#(#nodes),*],
+            }
+        };
+        Ok((component, checks))
+    }
+
+    /// Append `element` and its subtree in preorder
+    fn node(
+        &mut self,
+        element: &Element,
+        consts: &BTreeMap<String, String>,
+        props: &[String],
+        nodes: &mut Vec<TokenStream>,
+        max_attrs: &mut usize,
+    ) -> Result<(), String> {
+        let krate = self.krate;
+        let tag = match element.name.as_str() {
+            "view" => element.attr("extends").unwrap_or("lv_obj"),
+            name => name,
+        };
+        let tag = match self.names.binary_search(&tag) {
+            Ok(index) => {
+                let index = index as u16;
+                quote! { #krate::xml::CompiledTag::Component(#index) }
+            }
+            Err(_) => {
+                let tag = cstr(tag).map_err(|e| e.to_string())?;
+                quote! { #krate::xml::CompiledTag::Xml(#tag) }
+            }
+        };
+
+        let mut attrs = Vec::new();
+        for (key, value) in &element.attrs {
+            if element.name == "view" && key == "extends" {
+                continue;
+            }
+            let value = match value.strip_prefix('$') {
+                Some(prop) => {
+                    let index =
+                        props.iter().position(|p| p == prop).ok_or_else(|| {
+                            format!("unknown prop `${}` on <{}>", prop, element.name)
+                        })? as u16;
+                    quote! { #krate::xml::CompiledValue::Prop(#index) }
+                }
+                None => {
+                    let value = resolve_const(consts, value)?;
+                    self.refs.note(key, &value);
+                    let value = cstr(&value).map_err(|e| e.to_string())?;
+                    quote! { #krate::xml::CompiledValue::Lit(#value) }
+                }
+            };
+            let key = cstr(key).map_err(|e| e.to_string())?;
+            attrs.push(quote! { (#key, #value) });
+        }
+        *max_attrs = (*max_attrs).max(attrs.len());
+
+        let index = nodes.len();
+        nodes.push(TokenStream::new());
+        for child in &element.children {
+            self.node(child, consts, props, nodes, max_attrs)?;
+        }
+        if nodes.len() > usize::from(u16::MAX) {
+            return Err("view has too many elements".into());
+        }
+        let end = nodes.len() as u16;
+        nodes[index] = quote! {
+            #krate::xml::CompiledNode {
+                tag: #tag,
+                attrs: &[#(#attrs),*],
+                end: #end,
+            }
+        };
+        Ok(())
+    }
+}
+
+/// Substitute a `#const` reference
+fn resolve_const(consts: &BTreeMap<String, String>, value: &str) -> Result<String, String> {
+    let Some(name) = value.strip_prefix('#') else {
+        return Ok(value.to_owned());
+    };
+    match consts.get(name) {
+        Some(value) => Ok(value.clone()),
+        // `#rrggbb` colors
+        None if name.len() == 6 && name.chars().all(|c| c.is_ascii_hexdigit()) => {
+            Ok(value.to_owned())
+        }
+        None => Err(format!("unknown constant `{}`", value)),
+    }
+}
+
+pub fn expand(args: &Args) -> syn::Result<TokenStream> {
+    args.check(&["globals"])?;
+    let root = args.path()?;
+    let mut paths = Vec::new();
+    if root.is_dir() {
+        collect(&root, &mut paths).map_err(|e| error(format!("{}: {}", root.display(), e)))?;
+    } else {
+        paths.push(root.clone());
+    }
+
+    let globals_path = match args.path_option("globals")? {
+        Some(path) => Some(path),
+        None => Some(root.join("globals.xml")).filter(|p| p.is_file()),
+    };
+    let globals = globals_path.as_deref().map(Source::load).transpose()?;
+    paths.retain(|p| globals_path.as_deref() != Some(p.as_path()));
+
+    let mut const_map = BTreeMap::new();
+    let mut sources = Vec::new();
+    if let Some(globals) = &globals {
+        for (name, value) in globals.consts() {
+            const_map.insert(name.to_owned(), value.to_owned());
+        }
+        if !globals.compilable(&["consts"]) {
+            sources.push(("globals", globals.text.as_str()));
+        }
+    }
+
+    let files = paths
+        .iter()
+        .map(|p| Source::load(p))
+        .collect::<syn::Result<Vec<_>>>()?;
+    let (mut compiled, passed): (Vec<&Source>, Vec<&Source>) =
+        files.iter().partition(|s| s.compilable(COMPILED_SECTIONS));
+    compiled.sort_by(|a, b| a.name.cmp(&b.name));
+    for pair in compiled.windows(2) {
+        if pair[0].name == pair[1].name {
+            return Err(error(format!(
+                "{}: duplicate component `{}`",
+                pair[1].path.display(),
+                pair[1].name
+            )));
+        }
+    }
+    sources.extend(passed.iter().map(|s| (s.name.as_str(), s.text.as_str())));
+
+    let mut compiler = Compiler {
+        krate: &args.krate,
+        globals: &const_map,
+        names: compiled.iter().map(|s| s.name.as_str()).collect(),
+        refs: Refs::default(),
+    };
+    let (components, checks): (Vec<_>, Vec<_>) = compiled
+        .iter()
+        .map(|s| compiler.component(s))
+        .collect::<syn::Result<Vec<_>>>()?
+        .into_iter()
+        .unzip();
+
+    let mut refs = compiler.refs;
+    let names = |list: &mut Vec<String>| {
+        list.sort();
+        list.dedup();
+        list.iter()
+            .map(|n| cstr(n))
+            .collect::<syn::Result<Vec<_>>>()
+    };
+    let fonts = names(&mut refs.fonts)?;
+    let subjects = names(&mut refs.subjects)?;
+    let sources = sources
+        .iter()
+        .map(|(name, text)| {
+            let (name, text) = (cstr(name)?, cstr(text)?);
+            Ok(quote! { (#name, #text) })
+        })
+        .collect::<syn::Result<Vec<_>>>()?;
+
+    let track = globals.iter().chain(&files).map(|s| args.track(&s.path));
+    let krate = &args.krate;
+    Ok(quote! {{
+        #(#track)*
+        #(#checks)*
+        static UI: #krate::xml::CompiledUi = #krate::xml::CompiledUi::new(
+            &[#(#components),*],
+            &[#(#sources),*],
+            &[#(#fonts),*],
+            &[#(#subjects),*],
+        );
+        &UI
+    }})
+}
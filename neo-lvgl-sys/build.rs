@@ -1,5 +1,5 @@
 use std::env;
-use std::path::PathBuf;
+use std::path::{Path, PathBuf};
 
 fn main() {
     let manifest_dir = PathBuf::from(env::var("CARGO_MANIFEST_DIR").unwrap());
@@ -7,34 +7,101 @@ fn main() {
     let lv_conf_dir = manifest_dir.join("lv_conf");
     let out_dir = PathBuf::from(env::var("OUT_DIR").unwrap());
 
-    // Allow custom lv_conf.h via environment variable
+    // Allow custom lv_conf.h via environment variable; it replaces the
+    // bundled base configuration, feature-derived options still apply
+    let custom_conf = env::var_os("DEP_LV_CONF_PATH").is_some();
     let lv_conf_include = env::var("DEP_LV_CONF_PATH")
         .map(PathBuf::from)
         .unwrap_or_else(|_| lv_conf_dir.clone());
 
     println!("cargo:rerun-if-changed=wrapper.h");
-    println!("cargo:rerun-if-changed=lv_conf/lv_conf.h");
+    println!(
+        "cargo:rerun-if-changed={}",
+        lv_conf_include.join("lv_conf.h").display()
+    );
     println!("cargo:rerun-if-env-changed=DEP_LV_CONF_PATH");
+    println!("cargo:rerun-if-env-changed=NEO_LVGL_COLOR_FORMAT");
     println!("cargo:rerun-if-env-changed=ESP_TOOLCHAIN_VERSION");
+    println!("cargo:rerun-if-env-changed=NEO_LVGL_DRAW_UNITS");
+    println!("cargo:rerun-if-env-changed=NEO_LVGL_FREERTOS_INCLUDE");
+    println!("cargo:rerun-if-env-changed=NEO_LVGL_CPU");
+    println!("cargo:rerun-if-env-changed=NEO_LVGL_ARM2D_INCLUDE");
+    println!("cargo:rerun-if-env-changed=NEO_LVGL_SW_ASM_DIR");
+    println!("cargo:rerun-if-env-changed=NEO_LVGL_SW_ASM_INCLUDE");
+    println!("cargo:rerun-if-env-changed=NEO_LVGL_PLATFORM_INCLUDE");
+    println!("cargo:rerun-if-env-changed=NEO_LVGL_PLATFORM_SOURCES");
+    println!("cargo:rerun-if-env-changed=NEO_LVGL_DMA2D_HAL_INCLUDE");
+    println!("cargo:rerun-if-env-changed=NEO_LVGL_IMAGE_CACHE_SIZE");
+    println!("cargo:rerun-if-env-changed=NEO_LVGL_IMAGE_HEADER_CACHE_COUNT");
+
+    let target = env::var("TARGET").unwrap_or_default();
+
+    // lv_conf.h options derived from Cargo features, written into the
+    // generated lv_conf.h so the C build and bindgen see the same configuration
+    let mut defines: Vec<(&str, String)> = Vec::new();
+    let mut unused: Vec<PathBuf> = Vec::new();
+    let os = configure_os(&target, &mut defines);
+    let mut draw = DrawConfig::default();
+    configure_simd(&target, &mut defines, &mut draw);
+    configure_draw_units(&mut defines, &mut draw);
+    configure_modules(&mut defines, &mut unused);
+    if !custom_conf {
+        unused.extend(unused_in_bundled_conf());
+    }
+
+    let lv_conf_gen = write_lv_conf(&out_dir, &lv_conf_include.join("lv_conf.h"), &defines);
 
     // Collect LVGL source files
     let src_dir = lvgl_dir.join("src");
     let mut sources: Vec<PathBuf> = Vec::new();
 
-    collect_c_files(&src_dir, &mut sources);
+    collect_sources(&src_dir, &["c"], &mut sources);
+    // Skip sources of disabled modules instead of compiling them to empty objects
+    sources.retain(|s| {
+        s.strip_prefix(&src_dir)
+            .map_or(true, |rel| !unused.iter().any(|u| rel.starts_with(u)))
+    });
+    if draw.asm {
+        // LVGL's hand-written NEON/Helium kernels
+        collect_sources(&src_dir.join("draw/sw/blend"), &["S"], &mut sources);
+    }
+    for path in &draw.sources {
+        if path.is_file() {
+            sources.push(path.clone());
+        } else {
+            collect_sources(path, &["c", "S"], &mut sources);
+        }
+    }
 
     // Compile LVGL
     let mut build = cc::Build::new();
     build
         .include(&lvgl_dir)
+        .include(&lv_conf_gen)
+        // The base configuration may include headers next to itself
         .include(&lv_conf_include)
         .define("LV_CONF_INCLUDE_SIMPLE", None)
         // Suppress warnings from LVGL code
         .warnings(false)
         .extra_warnings(false);
 
+    if os == Os::FreeRtos {
+        // FreeRTOS headers come from the board SDK (FreeRTOSConfig.h is per-project)
+        if let Some(paths) = env::var_os("NEO_LVGL_FREERTOS_INCLUDE") {
+            for path in env::split_paths(&paths) {
+                build.include(path);
+            }
+        }
+    }
+
+    for path in &draw.includes {
+        build.include(path);
+    }
+    for flag in &draw.flags {
+        build.flag(flag);
+    }
+
     // Add platform-specific flags
-    let target = env::var("TARGET").unwrap_or_default();
     if target.contains("thumb") || target.contains("riscv") || target.contains("xtensa") {
         // Embedded targets - optimize for size
         build.opt_level_str("s");
@@ -63,16 +130,34 @@ fn main() {
         }
     }
 
-    for source in &sources {
-        build.file(source);
+    // Objects are cached by content, so unchanged sources are never rebuilt
+    // for the same target, compiler, flags and lv_conf.h
+    let cache = ObjectCache::new(&out_dir, &manifest_dir, &target, &lvgl_dir, &lv_conf_gen);
+    let mut objects = Vec::new();
+
+    // Fill/blend/transform kernels dominate frame time; with `fast-draw` they
+    // are built at -O2 and archived together with the rest of LVGL
+    if env::var_os("CARGO_FEATURE_FAST_DRAW").is_some() {
+        let mut hot = build.clone();
+        hot.opt_level(2);
+        let (hot_sources, rest): (Vec<_>, Vec<_>) =
+            sources.into_iter().partition(|s| is_hot_draw_source(s));
+        objects.extend(cache.compile(&hot, &hot_sources));
+        sources = rest;
     }
 
+    objects.extend(cache.compile(&build, &sources));
+    build.objects(objects);
+
     build.compile("lvgl");
 
     // Explicitly emit link directives (cc crate should do this, but ESP-IDF cross-compilation
     // can have issues finding the library)
     println!("cargo:rustc-link-search=native={}", out_dir.display());
     println!("cargo:rustc-link-lib=static=lvgl");
+    if os == Os::Pthread {
+        println!("cargo:rustc-link-lib=pthread");
+    }
 
     // Debug: print info about what was built
     let lib_path = out_dir.join("liblvgl.a");
@@ -89,11 +174,54 @@ fn main() {
         eprintln!("neo-lvgl-sys: TARGET_CC={}", cc);
     }
 
-    // Generate bindings
+    // Bindings are keyed on (target, LVGL commit, lv_conf.h hash); a matching
+    // file in NEO_LVGL_BINDINGS_DIR is used as-is and bindgen is skipped
+    let bindings_out = out_dir.join("bindings.rs");
+    let bindings_dir = env::var_os("NEO_LVGL_BINDINGS_DIR").map(PathBuf::from);
+    let bindings_name = format!(
+        "bindings-{}-{}-{:016x}.rs",
+        target,
+        lvgl_revision(&lvgl_dir),
+        config_hash(&[
+            &lv_conf_gen.join("lv_conf.h"),
+            &manifest_dir.join("wrapper.h")
+        ])
+    );
+    let pregenerated = bindings_dir.as_ref().map(|d| d.join(&bindings_name));
+
+    match pregenerated {
+        Some(path) if path.exists() => {
+            eprintln!("neo-lvgl-sys: Using pre-generated {}", path.display());
+            std::fs::copy(&path, &bindings_out).expect("Couldn't copy pre-generated bindings!");
+        }
+        _ => {
+            let mut include_dirs = vec![
+                lvgl_dir.clone(),
+                lv_conf_gen.clone(),
+                lv_conf_include.clone(),
+            ];
+            include_dirs.extend(draw.includes.iter().cloned());
+            generate_bindings(&target, &include_dirs, &bindings_out, &bindings_name);
+
+            // Populate the directory so later builds (e.g. other CI jobs) can skip bindgen
+            if let Some(dir) = &bindings_dir {
+                if std::fs::create_dir_all(dir).is_ok() {
+                    let _ = std::fs::copy(&bindings_out, dir.join(&bindings_name));
+                }
+            }
+        }
+    }
+
+    // Export the config path for dependent crates
+    println!("cargo:root={}", lv_conf_gen.display());
+}
+
+/// Generate bindings with bindgen
+#[cfg(feature = "bindgen")]
+fn generate_bindings(target: &str, include_dirs: &[PathBuf], out: &Path, _name: &str) {
     let mut builder = bindgen::Builder::default()
         .header("wrapper.h")
-        .clang_arg(format!("-I{}", lvgl_dir.display()))
-        .clang_arg(format!("-I{}", lv_conf_include.display()))
+        .clang_args(include_dirs.iter().map(|p| format!("-I{}", p.display())))
         .clang_arg("-DLV_CONF_INCLUDE_SIMPLE")
         // no_std compatibility
         .use_core()
@@ -103,6 +231,8 @@ fn main() {
         .allowlist_type("lv_.*")
         .allowlist_type("_lv_.*")
         .allowlist_var("LV_.*")
+        .allowlist_var("lv_font_.*")
+        .allowlist_var("lv_global")
         // Block problematic types
         .blocklist_type("max_align_t")
         // Layout hints
@@ -111,7 +241,6 @@ fn main() {
         .derive_debug(false);
 
     // Add target-specific clang arguments
-    let target = env::var("TARGET").unwrap_or_default();
     if target.contains("apple") {
         // For macOS/iOS, set the target explicitly
         builder = builder.clang_arg(format!("--target={}", target));
@@ -125,20 +254,760 @@ fn main() {
     } else if target.contains("xtensa") || target.contains("espidf") {
         // For ESP-IDF targets (Xtensa or RISC-V based ESP32)
         // We need to find the ESP toolchain sysroot for libc headers
-        builder = configure_espidf_bindgen(builder, &target);
+        builder = configure_espidf_bindgen(builder, target);
     }
 
     let bindings = builder.generate().expect("Unable to generate bindings");
 
     bindings
-        .write_to_file(out_dir.join("bindings.rs"))
+        .write_to_file(out)
         .expect("Couldn't write bindings!");
+}
 
-    // Export the config path for dependent crates
-    println!("cargo:root={}", lv_conf_include.display());
+#[cfg(not(feature = "bindgen"))]
+fn generate_bindings(_target: &str, _include_dirs: &[PathBuf], _out: &Path, name: &str) {
+    panic!(
+        "neo-lvgl-sys: built without the `bindgen` feature and no pre-generated {} in NEO_LVGL_BINDINGS_DIR",
+        name
+    );
+}
+
+/// FNV-1a hash, used for cache keys
+#[derive(Clone)]
+struct Fnv(u64);
+
+impl Fnv {
+    fn new() -> Self {
+        Fnv(0xcbf2_9ce4_8422_2325)
+    }
+
+    fn write(&mut self, bytes: &[u8]) {
+        for &b in bytes {
+            self.0 ^= b as u64;
+            self.0 = self.0.wrapping_mul(0x0100_0000_01b3);
+        }
+        // Separator so consecutive fields can't run into each other
+        self.0 ^= 0xff;
+        self.0 = self.0.wrapping_mul(0x0100_0000_01b3);
+    }
+
+    fn finish(&self) -> u64 {
+        self.0
+    }
+}
+
+/// Hash of the files that determine the generated bindings
+fn config_hash(files: &[&Path]) -> u64 {
+    let mut hash = Fnv::new();
+    for file in files {
+        hash.write(&std::fs::read(file).unwrap_or_default());
+    }
+    hash.finish()
+}
+
+/// LVGL commit from the submodule checkout, falling back to a hash of its
+/// public headers when there is no git metadata (e.g. a crates.io package)
+fn lvgl_revision(lvgl_dir: &Path) -> String {
+    git_head(lvgl_dir)
+        .map(|commit| commit[..commit.len().min(12)].to_string())
+        .unwrap_or_else(|| {
+            let mut hash = Fnv::new();
+            hash_tree(&lvgl_dir.join("src"), &["h"], &mut hash);
+            format!("{:016x}", hash.finish())
+        })
+}
+
+/// Resolve HEAD of a git checkout or submodule (`.git` may be a `gitdir:` file)
+fn git_head(repo: &Path) -> Option<String> {
+    let dot_git = repo.join(".git");
+    let git_dir = if dot_git.is_file() {
+        let link = std::fs::read_to_string(&dot_git).ok()?;
+        repo.join(link.trim().strip_prefix("gitdir:")?.trim())
+    } else {
+        dot_git
+    };
+
+    let head = std::fs::read_to_string(git_dir.join("HEAD")).ok()?;
+    let head = head.trim();
+    let Some(reference) = head.strip_prefix("ref:") else {
+        // Submodules are normally checked out detached
+        return Some(head.to_string());
+    };
+    let reference = reference.trim();
+    if let Ok(commit) = std::fs::read_to_string(git_dir.join(reference)) {
+        return Some(commit.trim().to_string());
+    }
+    let packed = std::fs::read_to_string(git_dir.join("packed-refs")).ok()?;
+    packed
+        .lines()
+        .find_map(|line| line.strip_suffix(reference).map(|c| c.trim().to_string()))
+}
+
+/// Hash every file with one of `extensions` under `dir`, in a stable order
+fn hash_tree(dir: &Path, extensions: &[&str], hash: &mut Fnv) {
+    let mut files = Vec::new();
+    collect_sources(dir, extensions, &mut files);
+    files.sort();
+    for file in files {
+        // Relative, so the hash does not depend on the checkout location
+        let name = file.strip_prefix(dir).unwrap_or(&file);
+        hash.write(name.to_string_lossy().as_bytes());
+        hash.write(&std::fs::read(&file).unwrap_or_default());
+    }
+}
+
+/// Content-addressed object cache, one directory per target.
+///
+/// An object's key covers the compiler, its argument list, the LVGL
+/// headers, the generated lv_conf.h and the source itself. Paths under
+/// `OUT_DIR` and the crate are keyed relative to those directories, so the
+/// key does not change with the feature/profile hash in `OUT_DIR` or the
+/// checkout location. Headers from vendor SDK include paths are not hashed;
+/// clear the cache when they change.
+struct ObjectCache {
+    dir: PathBuf,
+    base: Fnv,
+    lvgl_dir: PathBuf,
+    /// Build-specific path prefixes and what they stand for in keys
+    prefixes: [(String, &'static str); 2],
+}
+
+impl ObjectCache {
+    /// Cache in `NEO_LVGL_CACHE_DIR`, or next to Cargo's build directories so
+    /// it survives feature and profile changes
+    fn new(
+        out_dir: &Path,
+        manifest_dir: &Path,
+        target: &str,
+        lvgl_dir: &Path,
+        lv_conf_dir: &Path,
+    ) -> Self {
+        println!("cargo:rerun-if-env-changed=NEO_LVGL_CACHE_DIR");
+        let root = env::var_os("NEO_LVGL_CACHE_DIR")
+            .map(PathBuf::from)
+            .unwrap_or_else(|| out_dir.join("../../neo-lvgl-cache"));
+
+        let mut base = Fnv::new();
+        hash_tree(&lvgl_dir.join("src"), &["h"], &mut base);
+        base.write(&std::fs::read(lvgl_dir.join("lvgl.h")).unwrap_or_default());
+        base.write(&std::fs::read(lv_conf_dir.join("lv_conf.h")).unwrap_or_default());
+
+        ObjectCache {
+            dir: root.join(target),
+            base,
+            lvgl_dir: lvgl_dir.to_path_buf(),
+            prefixes: [
+                (out_dir.to_string_lossy().into_owned(), "$OUT_DIR"),
+                (
+                    manifest_dir.to_string_lossy().into_owned(),
+                    "$CARGO_MANIFEST_DIR",
+                ),
+            ],
+        }
+    }
+
+    /// `text` with build-specific path prefixes replaced by placeholders
+    fn stable(&self, text: &str) -> String {
+        let mut text = text.to_string();
+        for (prefix, name) in &self.prefixes {
+            text = text.replace(prefix.as_str(), name);
+        }
+        text
+    }
+
+    /// Compile `sources` with `build`, reusing cached objects. Missing
+    /// objects are compiled in one parallel batch and added to the cache.
+    fn compile(&self, build: &cc::Build, sources: &[PathBuf]) -> Vec<PathBuf> {
+        let tool = build.get_compiler();
+        let mut command = self.base.clone();
+        command.write(tool.path().to_string_lossy().as_bytes());
+        for arg in tool.args() {
+            // lv_conf.h under OUT_DIR is hashed by content in `base`
+            command.write(self.stable(&arg.to_string_lossy()).as_bytes());
+        }
+
+        let cached: Vec<PathBuf> = sources
+            .iter()
+            .map(|source| {
+                let mut hash = command.clone();
+                let name = source.strip_prefix(&self.lvgl_dir).unwrap_or(source);
+                hash.write(self.stable(&name.to_string_lossy()).as_bytes());
+                hash.write(&std::fs::read(source).unwrap_or_default());
+                self.dir.join(format!("{:016x}.o", hash.finish()))
+            })
+            .collect();
+
+        let missing: Vec<usize> = (0..sources.len())
+            .filter(|&i| !cached[i].exists())
+            .collect();
+        eprintln!(
+            "neo-lvgl-sys: {} of {} objects cached in {}",
+            sources.len() - missing.len(),
+            sources.len(),
+            self.dir.display()
+        );
+        if missing.is_empty() {
+            return cached;
+        }
+
+        let mut batch = build.clone();
+        for &i in &missing {
+            batch.file(&sources[i]);
+        }
+        let built = batch.compile_intermediates();
+
+        let _ = std::fs::create_dir_all(&self.dir);
+        let mut objects = cached;
+        for (&i, object) in missing.iter().zip(built) {
+            // Write under a temporary name and rename so concurrent builds
+            // never see a partial object; fall back to the fresh object
+            let tmp = objects[i].with_extension(format!("o.{}", std::process::id()));
+            let stored =
+                std::fs::copy(&object, &tmp).is_ok() && std::fs::rename(&tmp, &objects[i]).is_ok();
+            if !stored {
+                let _ = std::fs::remove_file(&tmp);
+                objects[i] = object;
+            }
+        }
+        objects
+    }
+}
+
+/// Extra widgets: (Cargo feature, lv_conf.h option, directory under `src/widgets`)
+const EXTRA_WIDGETS: &[(&str, &str, &str)] = &[
+    (
+        "CARGO_FEATURE_WIDGET_CALENDAR",
+        "LV_USE_CALENDAR",
+        "calendar",
+    ),
+    ("CARGO_FEATURE_WIDGET_CHART", "LV_USE_CHART", "chart"),
+    (
+        "CARGO_FEATURE_WIDGET_KEYBOARD",
+        "LV_USE_KEYBOARD",
+        "keyboard",
+    ),
+    ("CARGO_FEATURE_WIDGET_LED", "LV_USE_LED", "led"),
+    ("CARGO_FEATURE_WIDGET_LIST", "LV_USE_LIST", "list"),
+    ("CARGO_FEATURE_WIDGET_MENU", "LV_USE_MENU", "menu"),
+    ("CARGO_FEATURE_WIDGET_MSGBOX", "LV_USE_MSGBOX", "msgbox"),
+    ("CARGO_FEATURE_WIDGET_SCALE", "LV_USE_SCALE", "scale"),
+    ("CARGO_FEATURE_WIDGET_SPAN", "LV_USE_SPAN", "span"),
+    ("CARGO_FEATURE_WIDGET_SPINBOX", "LV_USE_SPINBOX", "spinbox"),
+    ("CARGO_FEATURE_WIDGET_SPINNER", "LV_USE_SPINNER", "spinner"),
+    ("CARGO_FEATURE_WIDGET_TABLE", "LV_USE_TABLE", "table"),
+    ("CARGO_FEATURE_WIDGET_TABVIEW", "LV_USE_TABVIEW", "tabview"),
+    (
+        "CARGO_FEATURE_WIDGET_TILEVIEW",
+        "LV_USE_TILEVIEW",
+        "tileview",
+    ),
+    ("CARGO_FEATURE_WIDGET_WINDOW", "LV_USE_WIN", "win"),
+];
+
+/// Montserrat fonts selectable with `font-montserrat-*` features.
+/// Size 14 is the default font and always built.
+const MONTSERRAT_FONTS: &[&str] = &[
+    "LV_FONT_MONTSERRAT_8",
+    "LV_FONT_MONTSERRAT_10",
+    "LV_FONT_MONTSERRAT_12",
+    "LV_FONT_MONTSERRAT_14",
+    "LV_FONT_MONTSERRAT_16",
+    "LV_FONT_MONTSERRAT_18",
+    "LV_FONT_MONTSERRAT_20",
+    "LV_FONT_MONTSERRAT_22",
+    "LV_FONT_MONTSERRAT_24",
+    "LV_FONT_MONTSERRAT_26",
+    "LV_FONT_MONTSERRAT_28",
+    "LV_FONT_MONTSERRAT_30",
+    "LV_FONT_MONTSERRAT_32",
+    "LV_FONT_MONTSERRAT_34",
+    "LV_FONT_MONTSERRAT_36",
+    "LV_FONT_MONTSERRAT_38",
+    "LV_FONT_MONTSERRAT_40",
+    "LV_FONT_MONTSERRAT_42",
+    "LV_FONT_MONTSERRAT_44",
+    "LV_FONT_MONTSERRAT_46",
+    "LV_FONT_MONTSERRAT_48",
+];
+
+/// Software renderer target formats and the blend source implementing each
+const SW_FORMATS: &[(&str, &str)] = &[
+    ("LV_DRAW_SW_SUPPORT_RGB565", "lv_draw_sw_blend_to_rgb565.c"),
+    (
+        "LV_DRAW_SW_SUPPORT_RGB565_SWAPPED",
+        "lv_draw_sw_blend_to_rgb565_swapped.c",
+    ),
+    (
+        "LV_DRAW_SW_SUPPORT_RGB565A8",
+        "lv_draw_sw_blend_to_rgb565.c",
+    ),
+    ("LV_DRAW_SW_SUPPORT_RGB888", "lv_draw_sw_blend_to_rgb888.c"),
+    (
+        "LV_DRAW_SW_SUPPORT_XRGB8888",
+        "lv_draw_sw_blend_to_rgb888.c",
+    ),
+    (
+        "LV_DRAW_SW_SUPPORT_ARGB8888",
+        "lv_draw_sw_blend_to_argb8888.c",
+    ),
+    (
+        "LV_DRAW_SW_SUPPORT_ARGB8888_PREMULTIPLIED",
+        "lv_draw_sw_blend_to_argb8888_premultiplied.c",
+    ),
+    ("LV_DRAW_SW_SUPPORT_L8", "lv_draw_sw_blend_to_l8.c"),
+    ("LV_DRAW_SW_SUPPORT_AL88", "lv_draw_sw_blend_to_al88.c"),
+    ("LV_DRAW_SW_SUPPORT_A8", "lv_draw_sw_blend_to_a8.c"),
+    ("LV_DRAW_SW_SUPPORT_I1", "lv_draw_sw_blend_to_i1.c"),
+];
+
+/// `NEO_LVGL_COLOR_FORMAT` values: (name, `LV_COLOR_DEPTH`, software formats).
+/// ARGB8888 (layers) and A8 (masks) are always kept.
+const COLOR_FORMATS: &[(&str, u32, &[&str])] = &[
+    ("rgb565", 16, &["LV_DRAW_SW_SUPPORT_RGB565"]),
+    (
+        "rgb565-swapped",
+        16,
+        &[
+            "LV_DRAW_SW_SUPPORT_RGB565",
+            "LV_DRAW_SW_SUPPORT_RGB565_SWAPPED",
+        ],
+    ),
+    ("rgb888", 24, &["LV_DRAW_SW_SUPPORT_RGB888"]),
+    ("xrgb8888", 32, &["LV_DRAW_SW_SUPPORT_XRGB8888"]),
+    ("argb8888", 32, &[]),
+    ("l8", 8, &["LV_DRAW_SW_SUPPORT_L8"]),
+    ("i1", 1, &["LV_DRAW_SW_SUPPORT_I1"]),
+];
+
+/// Select widgets, fonts, TinyTTF, snapshots, the profiler, the allocator and
+/// software color formats from Cargo features and `NEO_LVGL_COLOR_FORMAT`,
+/// recording sources left unused.
+fn configure_modules(defines: &mut Vec<(&'static str, String)>, unused: &mut Vec<PathBuf>) {
+    let enabled = |feature: &str| env::var_os(feature).is_some();
+    let flag = |on: bool| if on { "1" } else { "0" }.to_string();
+
+    for &(feature, option, dir) in EXTRA_WIDGETS {
+        let on = enabled(feature);
+        defines.push((option, flag(on)));
+        if !on {
+            unused.push(Path::new("widgets").join(dir));
+        }
+    }
+
+    for &option in MONTSERRAT_FONTS {
+        let on = option == "LV_FONT_MONTSERRAT_14"
+            || enabled(&format!("CARGO_FEATURE_{}", &option[3..]));
+        defines.push((option, flag(on)));
+        if !on {
+            unused.push(Path::new("font").join(format!("{}.c", option.to_lowercase())));
+        }
+    }
+
+    let ttf = enabled("CARGO_FEATURE_TTF");
+    defines.push(("LV_USE_TINY_TTF", flag(ttf)));
+    if !ttf {
+        unused.push(PathBuf::from("libs/tiny_ttf"));
+    }
+
+    let snapshot = enabled("CARGO_FEATURE_SNAPSHOT");
+    defines.push(("LV_USE_SNAPSHOT", flag(snapshot)));
+    if !snapshot {
+        unused.push(PathBuf::from("others/snapshot"));
+    }
+
+    // Timing points of LVGL's refresh and draw pipeline, recorded by the
+    // builtin profiler once neo-lvgl's `profiling::start_trace` enables it
+    let profiling = enabled("CARGO_FEATURE_PROFILING");
+    defines.push(("LV_USE_PROFILER", flag(profiling)));
+    if profiling {
+        defines.push(("LV_USE_PROFILER_BUILTIN", "1".to_string()));
+        defines.push(("LV_PROFILER_BUILTIN_DEFAULT_ENABLE", "0".to_string()));
+        // lv_init allocates the default buffer; start_trace replaces it
+        defines.push(("LV_PROFILER_BUILTIN_BUF_SIZE", "1024".to_string()));
+    }
+
+    // lv_malloc/lv_free are provided by neo-lvgl's `mem` module
+    if enabled("CARGO_FEATURE_CUSTOM_ALLOC") {
+        defines.push(("LV_USE_STDLIB_MALLOC", "LV_STDLIB_CUSTOM".to_string()));
+    }
+
+    // Initial image cache budgets; neo-lvgl's `image_cache` can resize them
+    for (var, option) in [
+        ("NEO_LVGL_IMAGE_CACHE_SIZE", "LV_CACHE_DEF_SIZE"),
+        (
+            "NEO_LVGL_IMAGE_HEADER_CACHE_COUNT",
+            "LV_IMAGE_HEADER_CACHE_DEF_CNT",
+        ),
+    ] {
+        if let Ok(value) = env::var(var) {
+            let value: u32 = value
+                .trim()
+                .parse()
+                .unwrap_or_else(|_| panic!("neo-lvgl-sys: {} must be a number", var));
+            defines.push((option, value.to_string()));
+        }
+    }
+
+    // Without a target format every software format stays as configured
+    let Ok(name) = env::var("NEO_LVGL_COLOR_FORMAT") else {
+        return;
+    };
+    let &(_, depth, formats) = COLOR_FORMATS
+        .iter()
+        .find(|(n, _, _)| n.eq_ignore_ascii_case(name.trim()))
+        .unwrap_or_else(|| {
+            let names: Vec<_> = COLOR_FORMATS.iter().map(|(n, _, _)| *n).collect();
+            panic!(
+                "neo-lvgl-sys: unknown NEO_LVGL_COLOR_FORMAT `{}` (expected one of {})",
+                name,
+                names.join(", ")
+            )
+        });
+    defines.push(("LV_COLOR_DEPTH", depth.to_string()));
+
+    let sw_enabled = |option: &str| {
+        formats.contains(&option)
+            || option == "LV_DRAW_SW_SUPPORT_ARGB8888"
+            || option == "LV_DRAW_SW_SUPPORT_A8"
+    };
+    for &(option, _) in SW_FORMATS {
+        defines.push((option, flag(sw_enabled(option))));
+    }
+    // A blend source can serve several formats; skip it only if all are off
+    for &(_, source) in SW_FORMATS {
+        let needed = SW_FORMATS
+            .iter()
+            .any(|&(option, s)| s == source && sw_enabled(option));
+        if !needed {
+            unused.push(Path::new("draw/sw/blend").join(source));
+        }
+    }
+}
+
+/// Sources under `src` that the bundled lv_conf.h always disables
+/// (drivers, unused draw backends, image/font libraries and extras)
+fn unused_in_bundled_conf() -> Vec<PathBuf> {
+    let mut dirs = vec![
+        "drivers",
+        "draw/sdl",
+        "draw/opengles",
+        "draw/vg_lite",
+        "draw/renesas",
+        "draw/nema_gfx",
+        "libs/barcode",
+        "libs/bmp",
+        "libs/ffmpeg",
+        "libs/freetype",
+        "libs/fsdrv",
+        "libs/gif",
+        "libs/libjpeg_turbo",
+        "libs/libpng",
+        "libs/libwebp",
+        "libs/lodepng",
+        "libs/lz4",
+        "libs/qrcode",
+        "libs/rlottie",
+        "libs/thorvg",
+        "libs/tjpgd",
+        "others/file_explorer",
+        "others/ime",
+        "others/monkey",
+    ];
+
+    // Hardware draw units are only built when their feature enables them
+    for (feature, dir) in [
+        ("CARGO_FEATURE_DRAW_PXP", "draw/nxp/pxp"),
+        ("CARGO_FEATURE_DRAW_VGLITE", "draw/nxp/vglite"),
+        ("CARGO_FEATURE_DRAW_DMA2D", "draw/dma2d"),
+    ] {
+        if env::var_os(feature).is_none() {
+            dirs.push(dir);
+        }
+    }
+
+    dirs.into_iter().map(PathBuf::from).collect()
+}
+
+/// Write `OUT_DIR/lv_conf/lv_conf.h`: the base configuration with each
+/// build.rs option substituted in place, options it does not mention are
+/// prepended. Returns the directory to put on the include path.
+fn write_lv_conf(out_dir: &Path, base: &Path, defines: &[(&str, String)]) -> PathBuf {
+    let template = std::fs::read_to_string(base)
+        .unwrap_or_else(|e| panic!("neo-lvgl-sys: cannot read {}: {}", base.display(), e));
+
+    let mut found = vec![false; defines.len()];
+    let mut body = String::with_capacity(template.len());
+    for line in template.lines() {
+        let index = define_name(line).and_then(|name| defines.iter().position(|(n, _)| *n == name));
+        match index {
+            Some(i) => {
+                let indent = &line[..line.len() - line.trim_start().len()];
+                body.push_str(&format!(
+                    "{}#define {} {}\n",
+                    indent, defines[i].0, defines[i].1
+                ));
+                found[i] = true;
+            }
+            None => {
+                body.push_str(line);
+                body.push('\n');
+            }
+        }
+    }
+
+    let mut conf = String::from(
+        "/* Generated by neo-lvgl-sys build.rs from lv_conf.h and Cargo features */\n\n",
+    );
+    for ((name, value), found) in defines.iter().zip(&found) {
+        if !found {
+            conf.push_str(&format!("#define {} {}\n", name, value));
+        }
+    }
+    conf.push('\n');
+    conf.push_str(&body);
+
+    let dir = out_dir.join("lv_conf");
+    std::fs::create_dir_all(&dir).expect("neo-lvgl-sys: cannot create lv_conf directory");
+    let path = dir.join("lv_conf.h");
+    // Keep the file untouched when nothing changed so C objects stay fresh
+    if std::fs::read_to_string(&path).ok().as_deref() != Some(conf.as_str()) {
+        std::fs::write(&path, conf).expect("neo-lvgl-sys: cannot write lv_conf.h");
+    }
+    dir
+}
+
+/// Name of the macro defined on a `#define` line
+fn define_name(line: &str) -> Option<&str> {
+    let rest = line.trim_start().strip_prefix('#')?.trim_start();
+    let rest = rest.strip_prefix("define")?;
+    if !rest.starts_with([' ', '\t']) {
+        return None;
+    }
+    let rest = rest.trim_start();
+    let end = rest
+        .find(|c: char| !(c.is_ascii_alphanumeric() || c == '_'))
+        .unwrap_or(rest.len());
+    Some(&rest[..end])
+}
+
+/// Operating system backend LVGL is built with
+#[derive(Clone, Copy, PartialEq, Eq)]
+enum Os {
+    None,
+    Pthread,
+    FreeRtos,
+}
+
+/// Select the OS backend from Cargo features and set the number of software
+/// draw units.
+///
+/// With an OS, LVGL renders with `NEO_LVGL_DRAW_UNITS` threads (default 2)
+/// and `lv_lock()` becomes a real mutex.
+fn configure_os(target: &str, defines: &mut Vec<(&'static str, String)>) -> Os {
+    let pthread = env::var_os("CARGO_FEATURE_OS_PTHREAD").is_some();
+    let freertos = env::var_os("CARGO_FEATURE_OS_FREERTOS").is_some();
+
+    let os = match (pthread, freertos) {
+        (true, true) => {
+            panic!("neo-lvgl-sys: features `os-pthread` and `os-freertos` are mutually exclusive")
+        }
+        (true, false) => Os::Pthread,
+        (false, true) => Os::FreeRtos,
+        (false, false) => Os::None,
+    };
+
+    match os {
+        Os::None => return os,
+        Os::Pthread => defines.push(("LV_USE_OS", "LV_OS_PTHREAD".to_string())),
+        Os::FreeRtos => defines.push(("LV_USE_OS", "LV_OS_FREERTOS".to_string())),
+    }
+
+    let draw_units = env::var("NEO_LVGL_DRAW_UNITS")
+        .ok()
+        .map(|v| {
+            v.trim()
+                .parse::<u32>()
+                .ok()
+                .filter(|&n| n >= 1)
+                .expect("neo-lvgl-sys: NEO_LVGL_DRAW_UNITS must be a positive integer")
+        })
+        .unwrap_or(2);
+    defines.push(("LV_DRAW_SW_DRAW_UNIT_CNT", draw_units.to_string()));
+
+    eprintln!(
+        "neo-lvgl-sys: OS backend enabled for {} with {} draw unit(s)",
+        target, draw_units
+    );
+
+    os
+}
+
+/// Extra compiler inputs for SIMD kernels and hardware draw units
+#[derive(Default)]
+struct DrawConfig {
+    /// Extra C compiler flags (`-march`, `-mfpu`, ...)
+    flags: Vec<String>,
+    /// Extra include directories (Arm-2D, vendor SDKs, custom kernels)
+    includes: Vec<PathBuf>,
+    /// Extra source files or directories compiled along with LVGL
+    sources: Vec<PathBuf>,
+    /// Whether LVGL's own assembly (`.S`) blend kernels are needed
+    asm: bool,
+}
+
+/// Select the vectorized fill/blend backend from Cargo features.
+///
+/// - `simd-neon`: LVGL's NEON kernels (aarch64, armv7 with NEON)
+/// - `simd-helium`: LVGL's Helium (MVE) kernels (Cortex-M55/M85)
+/// - `simd-custom`: external kernels via `LV_DRAW_SW_ASM_CUSTOM`, e.g. the
+///   ESP32-S3 PIE blend routines shipped with esp_lvgl_port
+/// - `arm2d`: Arm-2D accelerated draw on Cortex-M (Arm-2D headers from
+///   `NEO_LVGL_ARM2D_INCLUDE`, library linked by the application)
+fn configure_simd(target: &str, defines: &mut Vec<(&'static str, String)>, simd: &mut DrawConfig) {
+    let neon = env::var_os("CARGO_FEATURE_SIMD_NEON").is_some();
+    let helium = env::var_os("CARGO_FEATURE_SIMD_HELIUM").is_some();
+    let custom = env::var_os("CARGO_FEATURE_SIMD_CUSTOM").is_some();
+    let arm2d = env::var_os("CARGO_FEATURE_ARM2D").is_some();
+
+    if [neon, helium, custom].iter().filter(|&&f| f).count() > 1 {
+        panic!("neo-lvgl-sys: features `simd-neon`, `simd-helium` and `simd-custom` are mutually exclusive");
+    }
+
+    if neon {
+        if target.starts_with("aarch64") {
+            // NEON is part of the base ARMv8-A ISA
+        } else if target.starts_with("armv7") || target.starts_with("thumbv7neon") {
+            simd.flags.push("-mfpu=neon".to_string());
+        } else {
+            panic!(
+                "neo-lvgl-sys: feature `simd-neon` is not supported on {}",
+                target
+            );
+        }
+        defines.push(("LV_USE_DRAW_SW_ASM", "LV_DRAW_SW_ASM_NEON".to_string()));
+        simd.asm = true;
+    }
+
+    if helium {
+        if !target.starts_with("thumbv8m.main") {
+            panic!(
+                "neo-lvgl-sys: feature `simd-helium` requires a thumbv8m.main target, got {}",
+                target
+            );
+        }
+        // The Rust target only implies ARMv8-M Mainline; MVE needs v8.1-M and
+        // -mfpu=auto so the FPU is derived from the architecture extensions
+        let cpu = env::var("NEO_LVGL_CPU").unwrap_or_else(|_| "cortex-m55".to_string());
+        simd.flags
+            .push("-march=armv8.1-m.main+mve.fp+fp.dp".to_string());
+        simd.flags.push("-mfpu=auto".to_string());
+        simd.flags.push(format!("-mtune={}", cpu));
+        defines.push(("LV_USE_DRAW_SW_ASM", "LV_DRAW_SW_ASM_HELIUM".to_string()));
+        defines.push(("LV_USE_NATIVE_HELIUM_ASM", "1".to_string()));
+        simd.asm = true;
+    }
+
+    if custom {
+        let dir = env::var_os("NEO_LVGL_SW_ASM_DIR")
+            .map(PathBuf::from)
+            .expect("neo-lvgl-sys: feature `simd-custom` requires NEO_LVGL_SW_ASM_DIR");
+        let header = env::var("NEO_LVGL_SW_ASM_INCLUDE")
+            .expect("neo-lvgl-sys: feature `simd-custom` requires NEO_LVGL_SW_ASM_INCLUDE");
+        println!("cargo:rerun-if-changed={}", dir.display());
+        defines.push(("LV_USE_DRAW_SW_ASM", "LV_DRAW_SW_ASM_CUSTOM".to_string()));
+        defines.push(("LV_DRAW_SW_ASM_CUSTOM_INCLUDE", format!("\"{}\"", header)));
+        simd.includes.push(dir.clone());
+        simd.sources.push(dir);
+    }
+
+    if arm2d {
+        if !target.starts_with("thumb") {
+            panic!(
+                "neo-lvgl-sys: feature `arm2d` requires a Cortex-M target, got {}",
+                target
+            );
+        }
+        match env::var_os("NEO_LVGL_ARM2D_INCLUDE") {
+            Some(paths) => simd.includes.extend(env::split_paths(&paths)),
+            None => println!(
+                "cargo:warning=neo-lvgl-sys: `arm2d` enabled without NEO_LVGL_ARM2D_INCLUDE"
+            ),
+        }
+        defines.push(("LV_USE_DRAW_ARM2D_SYNC", "1".to_string()));
+    }
+}
+
+/// Enable hardware draw units from Cargo features.
+///
+/// - `draw-pxp`: NXP PXP (i.MX RT)
+/// - `draw-vglite`: NXP VGLite GPU (i.MX RT1170/RT500)
+/// - `draw-dma2d`: STM32 Chrom-ART DMA2D; `NEO_LVGL_DMA2D_HAL_INCLUDE` names
+///   the HAL header (e.g. `stm32h7xx_hal.h`), `draw-dma2d-irq` waits for
+///   transfers from the DMA2D interrupt instead of polling
+///
+/// LVGL's own draw unit sources are always built; the vendor drivers they
+/// call (fsl_pxp.c, the VGLite library, the STM32 HAL) come from
+/// `NEO_LVGL_PLATFORM_INCLUDE` and `NEO_LVGL_PLATFORM_SOURCES`.
+fn configure_draw_units(defines: &mut Vec<(&'static str, String)>, draw: &mut DrawConfig) {
+    let pxp = env::var_os("CARGO_FEATURE_DRAW_PXP").is_some();
+    let vglite = env::var_os("CARGO_FEATURE_DRAW_VGLITE").is_some();
+    let dma2d = env::var_os("CARGO_FEATURE_DRAW_DMA2D").is_some();
+    let dma2d_irq = env::var_os("CARGO_FEATURE_DRAW_DMA2D_IRQ").is_some();
+
+    if !(pxp || vglite || dma2d) {
+        return;
+    }
+
+    if pxp {
+        defines.push(("LV_USE_PXP", "1".to_string()));
+        defines.push(("LV_USE_DRAW_PXP", "1".to_string()));
+    }
+
+    if vglite {
+        defines.push(("LV_USE_DRAW_VGLITE", "1".to_string()));
+    }
+
+    if dma2d {
+        let hal = env::var("NEO_LVGL_DMA2D_HAL_INCLUDE")
+            .expect("neo-lvgl-sys: feature `draw-dma2d` requires NEO_LVGL_DMA2D_HAL_INCLUDE");
+        defines.push(("LV_USE_DRAW_DMA2D", "1".to_string()));
+        defines.push(("LV_DRAW_DMA2D_HAL_INCLUDE", format!("\"{}\"", hal)));
+        if dma2d_irq {
+            defines.push(("LV_USE_DRAW_DMA2D_INTERRUPT", "1".to_string()));
+        }
+    }
+
+    match env::var_os("NEO_LVGL_PLATFORM_INCLUDE") {
+        Some(paths) => draw.includes.extend(env::split_paths(&paths)),
+        None => println!(
+            "cargo:warning=neo-lvgl-sys: hardware draw unit enabled without NEO_LVGL_PLATFORM_INCLUDE"
+        ),
+    }
+
+    if let Some(paths) = env::var_os("NEO_LVGL_PLATFORM_SOURCES") {
+        for path in env::split_paths(&paths) {
+            println!("cargo:rerun-if-changed={}", path.display());
+            draw.sources.push(path);
+        }
+    }
+}
+
+/// Software draw sources that dominate frame time (fill, blend, transform)
+fn is_hot_draw_source(path: &Path) -> bool {
+    const HOT_FILES: &[&str] = &[
+        "lv_draw_sw_fill.c",
+        "lv_draw_sw_img.c",
+        "lv_draw_sw_mask.c",
+        "lv_draw_sw_transform.c",
+    ];
+
+    let in_blend = path.ancestors().any(|p| p.ends_with("draw/sw/blend"));
+    let name = path.file_name().and_then(|n| n.to_str()).unwrap_or("");
+    in_blend || HOT_FILES.contains(&name)
 }
 
 /// Configure bindgen for ESP-IDF targets
+#[cfg(feature = "bindgen")]
 fn configure_espidf_bindgen(builder: bindgen::Builder, target: &str) -> bindgen::Builder {
     // ESP-IDF uses newlib, we need to find the toolchain's sysroot
     // The toolchain can be in multiple locations:
@@ -219,6 +1088,7 @@ fn configure_espidf_bindgen(builder: bindgen::Builder, target: &str) -> bindgen:
 }
 
 /// Find the ESP toolchain sysroot
+#[cfg(feature = "bindgen")]
 fn find_esp_sysroot(
     toolchain_base: &PathBuf,
     toolchain_name: &str,
@@ -261,6 +1131,7 @@ fn find_esp_sysroot(
 }
 
 /// Try to find sysroot within a version directory
+#[cfg(feature = "bindgen")]
 fn try_find_sysroot_in_version(
     version_entry: &std::fs::DirEntry,
     toolchain_name: &str,
@@ -413,7 +1284,7 @@ fn find_compiler_in_embuild(tools_dir: &PathBuf, prefix: &str) -> Option<String>
     None
 }
 
-fn collect_c_files(dir: &PathBuf, sources: &mut Vec<PathBuf>) {
+fn collect_sources(dir: &Path, extensions: &[&str], sources: &mut Vec<PathBuf>) {
     if !dir.exists() {
         return;
     }
@@ -431,8 +1302,12 @@ fn collect_c_files(dir: &PathBuf, sources: &mut Vec<PathBuf>) {
             if dir_name == "demos" || dir_name == "examples" {
                 continue;
             }
-            collect_c_files(&path, sources);
-        } else if path.extension().map_or(false, |ext| ext == "c") {
+            collect_sources(&path, extensions, sources);
+        } else if path
+            .extension()
+            .and_then(|ext| ext.to_str())
+            .map_or(false, |ext| extensions.contains(&ext))
+        {
             sources.push(path);
         }
     }
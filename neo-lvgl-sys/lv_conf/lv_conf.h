@@ -11,7 +11,8 @@
    COLOR SETTINGS
  *====================*/
 
-/** Color depth: 1 (I1), 8 (L8), 16 (RGB565), 24 (RGB888), 32 (XRGB8888) */
+/** Color depth: 1 (I1), 8 (L8), 16 (RGB565), 24 (RGB888), 32 (XRGB8888)
+ *  build.rs sets it (and the software formats below) from NEO_LVGL_COLOR_FORMAT */
 #define LV_COLOR_DEPTH 16
 
 /*=========================
@@ -52,7 +53,10 @@
  * OPERATING SYSTEM
  *=================*/
 
-#define LV_USE_OS   LV_OS_NONE
+/* Overridden by build.rs with the `os-pthread` / `os-freertos` features */
+#ifndef LV_USE_OS
+    #define LV_USE_OS   LV_OS_NONE
+#endif
 
 /*========================
  * RENDERING CONFIGURATION
@@ -79,17 +83,38 @@
     #define LV_DRAW_SW_SUPPORT_A8               1
     #define LV_DRAW_SW_SUPPORT_I1               1
     #define LV_DRAW_SW_I1_LUM_THRESHOLD         127
-    #define LV_DRAW_SW_DRAW_UNIT_CNT            1
-    #define LV_USE_DRAW_ARM2D_SYNC              0
-    #define LV_USE_NATIVE_HELIUM_ASM            0
+    /* Number of software render threads; set by build.rs when an OS is enabled */
+    #ifndef LV_DRAW_SW_DRAW_UNIT_CNT
+        #define LV_DRAW_SW_DRAW_UNIT_CNT        1
+    #endif
+    /* Vectorized fill/blend kernels; selected by build.rs from the simd-* features */
+    #ifndef LV_USE_DRAW_SW_ASM
+        #define LV_USE_DRAW_SW_ASM              LV_DRAW_SW_ASM_NONE
+    #endif
+    #ifndef LV_USE_DRAW_ARM2D_SYNC
+        #define LV_USE_DRAW_ARM2D_SYNC          0
+    #endif
+    #ifndef LV_USE_NATIVE_HELIUM_ASM
+        #define LV_USE_NATIVE_HELIUM_ASM        0
+    #endif
     #define LV_DRAW_SW_COMPLEX                  1
     #define LV_DRAW_SW_SHADOW_CACHE_SIZE        0
     #define LV_DRAW_SW_CIRCLE_CACHE_SIZE        4
 #endif
 
-/* GPU/VG acceleration - disabled for embedded */
-#define LV_USE_DRAW_VGLITE 0
-#define LV_USE_DRAW_PXP 0
+/* GPU/VG acceleration - disabled by default, enabled by build.rs from the draw-* features */
+#ifndef LV_USE_DRAW_VGLITE
+    #define LV_USE_DRAW_VGLITE 0
+#endif
+#ifndef LV_USE_PXP
+    #define LV_USE_PXP 0
+#endif
+#ifndef LV_USE_DRAW_PXP
+    #define LV_USE_DRAW_PXP 0
+#endif
+#ifndef LV_USE_DRAW_DMA2D
+    #define LV_USE_DRAW_DMA2D 0
+#endif
 #define LV_USE_DRAW_DAVE2D 0
 #define LV_USE_DRAW_SDL 0
 #define LV_USE_DRAW_VG_LITE 0
@@ -120,6 +145,7 @@
 #define LV_USE_USER_DATA 1
 
 #define LV_USE_SYSMON 0
+/* build.rs sets LV_USE_PROFILER from the profiling feature */
 #define LV_USE_PROFILER 0
 
 #define LV_ENABLE_GLOBAL_CUSTOM 0
@@ -140,6 +166,7 @@
  *  FONT CONFIGURATION
  *=====================*/
 
+/* Set by build.rs from font-montserrat-* features (14 is always on) */
 #define LV_FONT_MONTSERRAT_8  0
 #define LV_FONT_MONTSERRAT_10 0
 #define LV_FONT_MONTSERRAT_12 0
@@ -179,7 +206,7 @@
 #define LV_USE_FONT_SUBPX       0
 #define LV_USE_FONT_PLACEHOLDER 1
 
-/* FreeType/TinyTTF - TinyTTF enabled for runtime font loading */
+/* FreeType/TinyTTF - build.rs sets LV_USE_TINY_TTF from the ttf feature */
 #define LV_USE_FREETYPE 0
 #define LV_USE_TINY_TTF 1
 #if LV_USE_TINY_TTF
@@ -231,7 +258,7 @@
     #define LV_TEXTAREA_DEF_PWD_SHOW_TIME 1500
 #endif
 
-/* Extra widgets - enabled for Rust bindings (gated by Cargo features) */
+/* Extra widgets - build.rs sets the ones with Rust bindings from widget-* features */
 #define LV_USE_ANIMIMG    1
 #define LV_USE_ARCLABEL   0
 #define LV_USE_CALENDAR   1
@@ -289,6 +316,7 @@
 
 #define LV_USE_FRAGMENT 1
 #define LV_USE_OBSERVER 1
+/* build.rs sets LV_USE_SNAPSHOT from the snapshot feature */
 #define LV_USE_SNAPSHOT 0
 #define LV_USE_MONKEY   0
 
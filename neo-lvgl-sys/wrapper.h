@@ -4,3 +4,17 @@
  */
 
 #include "lvgl/lvgl.h"
+
+/* Draw unit/task internals, needed to implement custom draw units */
+#include "lvgl/src/draw/lv_draw_private.h"
+
+/* Image cache and decoder internals, used by neo-lvgl's image_cache */
+#include "lvgl/src/core/lv_global.h"
+#include "lvgl/src/misc/cache/lv_cache_private.h"
+#include "lvgl/src/draw/lv_image_decoder_private.h"
+
+/* Timer fields, used to free closures of neo-lvgl timers */
+#include "lvgl/src/misc/lv_timer_private.h"
+
+/* Builtin profiler trace buffer, used by neo-lvgl's profiling */
+#include "lvgl/src/misc/lv_profiler_builtin.h"
@@ -0,0 +1,254 @@
+//! Host benchmarks of common UI workloads
+//!
+//! Every scenario renders into a headless 480x320 RGB565 display whose flush
+//! drops the pixels, so the numbers are LVGL and binding cost only:
+//!
+//! ```text
+//! cargo bench -p neo-lvgl --bench ui [filter]
+//! cargo bench -p neo-lvgl --bench ui --features profiling
+//! ```
+//!
+//! With `profiling` each result also shows the average layout, render and
+//! flush time of the frames it drew.
+
+use neo_lvgl::display::BufferConfig;
+use neo_lvgl::prelude::*;
+use neo_lvgl::runloop;
+use neo_lvgl::widgets::extra::{Chart, ChartAxis, ChartType};
+use neo_lvgl::widgets::{RowSource, VirtualList};
+use std::ffi::{CStr, CString};
+use std::hint::black_box;
+use std::sync::OnceLock;
+use std::time::{Duration, Instant};
+
+const WIDTH: i32 = 480;
+const HEIGHT: i32 = 320;
+
+/// Display driver that discards every flush
+struct NullDisplay;
+
+impl DisplayDriver for NullDisplay {
+    fn size(&self) -> (i32, i32) {
+        (WIDTH, HEIGHT)
+    }
+
+    fn flush(&mut self, _area: &Area, pixels: &[u8]) {
+        black_box(pixels);
+    }
+}
+
+fn start() -> Instant {
+    static START: OnceLock<Instant> = OnceLock::new();
+    *START.get_or_init(Instant::now)
+}
+
+struct HostClock;
+
+impl runloop::Clock for HostClock {
+    fn now_ms() -> u32 {
+        start().elapsed().as_millis() as u32
+    }
+
+    fn now_us() -> u64 {
+        start().elapsed().as_micros() as u64
+    }
+}
+
+/// Iterations timed one by one after a short warm-up
+struct Runner {
+    filter: Option<String>,
+}
+
+impl Runner {
+    fn from_args() -> Self {
+        // cargo passes `--bench`; anything else selects scenarios by name
+        let filter = std::env::args().skip(1).find(|arg| !arg.starts_with('-'));
+        Self { filter }
+    }
+
+    fn run(&self, name: &str, iterations: usize, mut f: impl FnMut()) {
+        if self
+            .filter
+            .as_deref()
+            .is_some_and(|filter| !name.contains(filter))
+        {
+            return;
+        }
+        for _ in 0..iterations.div_ceil(10) {
+            f();
+        }
+        #[cfg(feature = "profiling")]
+        neo_lvgl::profiling::report();
+
+        let mut samples: Vec<Duration> = (0..iterations)
+            .map(|_| {
+                let start = Instant::now();
+                f();
+                start.elapsed()
+            })
+            .collect();
+        samples.sort_unstable();
+        let mean = samples.iter().sum::<Duration>() / iterations as u32;
+        print!(
+            "{:<32} median {:>10.1?}  mean {:>10.1?}  min {:>10.1?}  ({} iterations)",
+            name,
+            samples[iterations / 2],
+            mean,
+            samples[0],
+            iterations,
+        );
+        #[cfg(feature = "profiling")]
+        {
+            let report = neo_lvgl::profiling::report();
+            print!(
+                "  layout {} us, render {} us, flush {} us, heap peak {} B",
+                report.avg.layout_us, report.avg.render_us, report.avg.flush_us, report.mem.peak,
+            );
+        }
+        println!();
+    }
+}
+
+fn refresh(display: &Display) {
+    unsafe { neo_lvgl_sys::lv_refr_now(display.raw()) };
+}
+
+/// A screen that is not loaded yet
+fn new_screen<'a>() -> Obj<'a> {
+    unsafe { Obj::from_raw(neo_lvgl_sys::lv_obj_create(core::ptr::null_mut())).unwrap() }
+}
+
+/// Create and lay out a wrapping grid of labelled buttons, then delete it
+fn widget_storm(display: &Display, screen: &Screen<'_>, count: usize) {
+    let grid = Obj::new(screen).unwrap();
+    grid.set_size(WIDTH, HEIGHT);
+    grid.set_flex_flow(FlexFlow::RowWrap);
+    for _ in 0..count {
+        let button = Button::new(&grid).unwrap();
+        Label::new(&button).unwrap().set_text(c"Button");
+    }
+    refresh(display);
+    unsafe { grid.delete() };
+}
+
+struct Rows(Vec<CString>);
+
+impl RowSource for Rows {
+    fn row_count(&self) -> usize {
+        self.0.len()
+    }
+
+    fn cell(&self, row: usize, _col: usize) -> &CStr {
+        &self.0[row]
+    }
+}
+
+fn main() {
+    neo_lvgl::init();
+    runloop::set_clock::<HostClock>();
+    let managed = ManagedDisplay::with_buffer_config(
+        NullDisplay,
+        ColorFormat::Rgb565,
+        RenderMode::Partial,
+        BufferConfig::lines(40, false),
+    )
+    .unwrap();
+    let display = managed.display();
+    display.set_default();
+    #[cfg(feature = "profiling")]
+    neo_lvgl::profiling::attach(display);
+    let screen = display.active_screen();
+    let runner = Runner::from_args();
+
+    runner.run("create/100 buttons", 200, || {
+        widget_storm(display, &screen, 100)
+    });
+    runner.run("create/1000 buttons", 20, || {
+        widget_storm(display, &screen, 1000)
+    });
+
+    {
+        let chart = Chart::new(&screen).unwrap();
+        chart.set_size(WIDTH, HEIGHT);
+        chart.set_type(ChartType::Line);
+        chart.set_point_count(240);
+        chart.set_range(ChartAxis::PrimaryY, 0, 1000);
+        let series = [
+            chart
+                .add_series(Color::hex(0xE53935), ChartAxis::PrimaryY)
+                .unwrap(),
+            chart
+                .add_series(Color::hex(0x1E88E5), ChartAxis::PrimaryY)
+                .unwrap(),
+        ];
+        let mut phase = 0i32;
+        runner.run("chart/stream 2x240 points", 500, || {
+            for _ in 0..8 {
+                phase = (phase + 37) % 1000;
+                chart.set_next(&series[0], phase);
+                chart.set_next(&series[1], 1000 - phase);
+            }
+            refresh(display);
+        });
+        unsafe { chart.delete() };
+    }
+
+    {
+        let style: &'static mut Style = Box::leak(Box::new(Style::new()));
+        style.set_bg_color(Color::hex(0x263238));
+        let grid = Obj::new(&screen).unwrap();
+        grid.set_size(WIDTH, HEIGHT);
+        grid.set_flex_flow(FlexFlow::RowWrap);
+        for _ in 0..400 {
+            let button = Button::new(&grid).unwrap();
+            button.set_size(40, 20);
+            button.add_style(style, StyleSelector::default());
+        }
+        refresh(display);
+        let mut dark = false;
+        runner.run("style/re-theme 400 buttons", 200, || {
+            dark = !dark;
+            style.set_bg_color(Color::hex(if dark { 0x263238 } else { 0xECEFF1 }));
+            unsafe { neo_lvgl_sys::lv_obj_report_style_change(style.raw_mut()) };
+            refresh(display);
+        });
+        unsafe { grid.delete() };
+    }
+
+    {
+        let rows = (0..1000)
+            .map(|i| CString::new(format!("Row {}", i)).unwrap())
+            .collect();
+        let list = VirtualList::new(&screen, Rows(rows), 24).unwrap();
+        list.set_size(WIDTH, HEIGHT);
+        refresh(display);
+        let mut row = 0;
+        runner.run("scroll/1000-row list", 1000, || {
+            row = (row + 7) % 1000;
+            list.scroll_to_row(row, false);
+            refresh(display);
+        });
+        unsafe { list.delete() };
+    }
+
+    {
+        let screens = [new_screen(), new_screen()];
+        for (i, screen) in screens.iter().enumerate() {
+            screen.set_flex_flow(FlexFlow::Column);
+            for _ in 0..20 {
+                let label = Label::new(screen).unwrap();
+                label.set_text(if i == 0 {
+                    c"First screen"
+                } else {
+                    c"Second screen"
+                });
+            }
+        }
+        let mut next = 0;
+        runner.run("screen/switch", 500, || {
+            next ^= 1;
+            unsafe { neo_lvgl_sys::lv_screen_load(screens[next].raw()) };
+            refresh(display);
+        });
+    }
+}
@@ -5,6 +5,7 @@
 //! - `Anim` - Animation builder with fluent API
 //! - `AnimHandle` - Handle to a running animation
 //! - `AnimTimeline` - Sequencing multiple animations
+//! - `AnimProperty` - Built-in exec callbacks for common widget properties
 //! - `AnimPath` - Easing functions
 //!
 //! # Example
@@ -27,6 +28,7 @@
 //! // });
 //! ```
 
+use crate::widgets::Widget;
 use core::ffi::c_void;
 use core::mem::MaybeUninit;
 use core::ptr::NonNull;
@@ -127,6 +129,88 @@ impl Default for Progress {
     }
 }
 
+/// Widget property with a built-in exec callback
+///
+/// Animating a property with [`Anim::set_property`] or
+/// [`AnimTimeline::add_property`] calls the LVGL setter directly, without a
+/// closure or trampoline. Style properties are set on the main part.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum AnimProperty {
+    /// X position
+    X,
+    /// Y position
+    Y,
+    /// Width
+    Width,
+    /// Height
+    Height,
+    /// Opacity (values are clamped to 0-255)
+    Opa,
+    /// Horizontal translation
+    TranslateX,
+    /// Vertical translation
+    TranslateY,
+    /// Uniform transform scale (256 = 100%)
+    Scale,
+    /// Transform rotation in 0.1 degree units
+    Rotation,
+}
+
+impl AnimProperty {
+    fn exec_cb(self) -> unsafe extern "C" fn(*mut c_void, i32) {
+        match self {
+            AnimProperty::X => exec_x,
+            AnimProperty::Y => exec_y,
+            AnimProperty::Width => exec_width,
+            AnimProperty::Height => exec_height,
+            AnimProperty::Opa => exec_opa,
+            AnimProperty::TranslateX => exec_translate_x,
+            AnimProperty::TranslateY => exec_translate_y,
+            AnimProperty::Scale => exec_scale,
+            AnimProperty::Rotation => exec_rotation,
+        }
+    }
+}
+
+unsafe extern "C" fn exec_x(var: *mut c_void, value: i32) {
+    neo_lvgl_sys::lv_obj_set_x(var as *mut neo_lvgl_sys::lv_obj_t, value);
+}
+
+unsafe extern "C" fn exec_y(var: *mut c_void, value: i32) {
+    neo_lvgl_sys::lv_obj_set_y(var as *mut neo_lvgl_sys::lv_obj_t, value);
+}
+
+unsafe extern "C" fn exec_width(var: *mut c_void, value: i32) {
+    neo_lvgl_sys::lv_obj_set_width(var as *mut neo_lvgl_sys::lv_obj_t, value);
+}
+
+unsafe extern "C" fn exec_height(var: *mut c_void, value: i32) {
+    neo_lvgl_sys::lv_obj_set_height(var as *mut neo_lvgl_sys::lv_obj_t, value);
+}
+
+unsafe extern "C" fn exec_opa(var: *mut c_void, value: i32) {
+    let opa = value.clamp(0, 255) as neo_lvgl_sys::lv_opa_t;
+    neo_lvgl_sys::lv_obj_set_style_opa(var as *mut neo_lvgl_sys::lv_obj_t, opa, 0);
+}
+
+unsafe extern "C" fn exec_translate_x(var: *mut c_void, value: i32) {
+    neo_lvgl_sys::lv_obj_set_style_translate_x(var as *mut neo_lvgl_sys::lv_obj_t, value, 0);
+}
+
+unsafe extern "C" fn exec_translate_y(var: *mut c_void, value: i32) {
+    neo_lvgl_sys::lv_obj_set_style_translate_y(var as *mut neo_lvgl_sys::lv_obj_t, value, 0);
+}
+
+unsafe extern "C" fn exec_scale(var: *mut c_void, value: i32) {
+    let obj = var as *mut neo_lvgl_sys::lv_obj_t;
+    neo_lvgl_sys::lv_obj_set_style_transform_scale_x(obj, value, 0);
+    neo_lvgl_sys::lv_obj_set_style_transform_scale_y(obj, value, 0);
+}
+
+unsafe extern "C" fn exec_rotation(var: *mut c_void, value: i32) {
+    neo_lvgl_sys::lv_obj_set_style_transform_rotation(var as *mut neo_lvgl_sys::lv_obj_t, value, 0);
+}
+
 /// Animation builder
 ///
 /// Use the builder pattern to configure an animation, then call `start()` or
@@ -256,6 +340,18 @@ impl Anim {
         self
     }
 
+    /// Animate a property of `widget` with a built-in exec callback
+    ///
+    /// Sets the animated variable to the widget; no closure is involved.
+    pub fn set_property<'a>(
+        &mut self,
+        widget: &impl Widget<'a>,
+        property: AnimProperty,
+    ) -> &mut Self {
+        self.set_var(widget.raw() as *mut c_void)
+            .set_exec_cb(Some(property.exec_cb()))
+    }
+
     /// Set the custom exec callback (receives anim pointer)
     ///
     /// The callback receives (anim_ptr, current_value).
@@ -347,6 +443,8 @@ mod closure_support {
 
     /// Trampoline for exec callback closures
     unsafe extern "C" fn exec_trampoline(anim: *mut neo_lvgl_sys::lv_anim_t, value: i32) {
+        #[cfg(feature = "profiling")]
+        let _span = crate::profiling::Span::enter(crate::profiling::Site::Anim);
         let user_data = neo_lvgl_sys::lv_anim_get_user_data(anim);
         if !user_data.is_null() {
             let callbacks = &mut *(user_data as *mut AnimCallbacks);
@@ -358,6 +456,8 @@ mod closure_support {
 
     /// Trampoline for completed callback closures
     unsafe extern "C" fn completed_trampoline(anim: *mut neo_lvgl_sys::lv_anim_t) {
+        #[cfg(feature = "profiling")]
+        let _span = crate::profiling::Span::enter(crate::profiling::Site::Anim);
         let user_data = neo_lvgl_sys::lv_anim_get_user_data(anim);
         if !user_data.is_null() {
             let callbacks = &mut *(user_data as *mut AnimCallbacks);
@@ -369,6 +469,8 @@ mod closure_support {
 
     /// Trampoline for start callback closures
     unsafe extern "C" fn start_trampoline(anim: *mut neo_lvgl_sys::lv_anim_t) {
+        #[cfg(feature = "profiling")]
+        let _span = crate::profiling::Span::enter(crate::profiling::Site::Anim);
         let user_data = neo_lvgl_sys::lv_anim_get_user_data(anim);
         if !user_data.is_null() {
             let callbacks = &mut *(user_data as *mut AnimCallbacks);
@@ -477,7 +579,12 @@ mod closure_support {
                 self.anim.set_completed_cb(Some(completed_trampoline));
             }
 
-            self.anim.start()
+            let handle = self.anim.start();
+            if handle.is_none() {
+                // Not started, so the deleted callback never runs
+                drop(unsafe { Box::from_raw(raw_callbacks) });
+            }
+            handle
         }
     }
 
@@ -506,11 +613,119 @@ mod closure_support {
         ///     widget.set_x(value);
         /// });
         /// ```
-        pub fn start_with_exec<F>(self, exec: F) -> Option<AnimHandle>
+        pub fn start_with_exec<F>(mut self, exec: F) -> Option<AnimHandle>
         where
             F: FnMut(i32) + 'static,
         {
-            self.with_callbacks().on_exec(exec).start()
+            // One allocation holding just the closure, freed on delete
+            let raw_exec = Box::into_raw(Box::new(exec));
+            self.set_user_data(raw_exec as *mut c_void);
+            self.set_custom_exec_cb(Some(exec_only_trampoline::<F>));
+            self.set_deleted_cb(Some(drop_user_data::<F>));
+            let handle = self.start();
+            if handle.is_none() {
+                // Not started, so the deleted callback never runs
+                drop(unsafe { Box::from_raw(raw_exec) });
+            }
+            handle
+        }
+    }
+
+    /// Exec trampoline for animations whose user data is just the closure
+    unsafe extern "C" fn exec_only_trampoline<F: FnMut(i32)>(
+        anim: *mut neo_lvgl_sys::lv_anim_t,
+        value: i32,
+    ) {
+        #[cfg(feature = "profiling")]
+        let _span = crate::profiling::Span::enter(crate::profiling::Site::Anim);
+        let user_data = neo_lvgl_sys::lv_anim_get_user_data(anim);
+        if !user_data.is_null() {
+            (*(user_data as *mut F))(value);
+        }
+    }
+
+    unsafe extern "C" fn drop_user_data<F>(anim: *mut neo_lvgl_sys::lv_anim_t) {
+        let user_data = neo_lvgl_sys::lv_anim_get_user_data(anim);
+        if !user_data.is_null() {
+            drop(Box::from_raw(user_data as *mut F));
+        }
+    }
+
+    /// Exec trampoline for timeline tracks sharing one closure
+    ///
+    /// `var` is the closure and the user data is the track index.
+    pub(super) unsafe extern "C" fn track_trampoline<F: FnMut(usize, i32)>(
+        anim: *mut neo_lvgl_sys::lv_anim_t,
+        value: i32,
+    ) {
+        #[cfg(feature = "profiling")]
+        let _span = crate::profiling::Span::enter(crate::profiling::Site::Anim);
+        let exec = (*anim).var as *mut F;
+        if !exec.is_null() {
+            (*exec)(neo_lvgl_sys::lv_anim_get_user_data(anim) as usize, value);
+        }
+    }
+
+    unsafe fn drop_exec<F>(exec: *mut c_void) {
+        drop(Box::from_raw(exec as *mut F));
+    }
+
+    /// Shared exec closure of a timeline
+    pub(super) struct TrackExec {
+        pub(super) exec: *mut c_void,
+        pub(super) trampoline: unsafe extern "C" fn(*mut neo_lvgl_sys::lv_anim_t, i32),
+        pub(super) drop: unsafe fn(*mut c_void),
+    }
+
+    impl AnimTimeline {
+        /// Create a timeline whose closure tracks share `exec`
+        ///
+        /// `exec` receives the track index given to [`add_track`](Self::add_track)
+        /// and the current value. It is the timeline's only allocation for
+        /// callbacks, however many tracks are added, and is freed with the
+        /// timeline.
+        ///
+        /// # Example
+        ///
+        /// ```ignore
+        /// let mut tl = AnimTimeline::with_tracks(move |track, value| {
+        ///     cards[track].set_y(value);
+        /// })?;
+        /// for i in 0..cards.len() {
+        ///     tl.add_track(i as u32 * 30, &slide_in, i);
+        /// }
+        /// tl.start();
+        /// ```
+        pub fn with_tracks<F>(exec: F) -> Option<Self>
+        where
+            F: FnMut(usize, i32) + 'static,
+        {
+            let mut timeline = Self::new()?;
+            timeline.tracks = Some(TrackExec {
+                exec: Box::into_raw(Box::new(exec)) as *mut c_void,
+                trampoline: track_trampoline::<F>,
+                drop: drop_exec::<F>,
+            });
+            Some(timeline)
+        }
+
+        /// Add a track driven by the shared exec closure
+        ///
+        /// Does nothing if the timeline was not created with
+        /// [`with_tracks`](Self::with_tracks).
+        pub fn add_track(&mut self, start_time: u32, anim: &Anim, track: usize) -> &mut Self {
+            let Some(tracks) = &self.tracks else {
+                return self;
+            };
+            let mut raw = unsafe { core::ptr::read(&anim.raw) };
+            unsafe {
+                neo_lvgl_sys::lv_anim_set_var(&mut raw, tracks.exec);
+                neo_lvgl_sys::lv_anim_set_user_data(&mut raw, track as *mut c_void);
+                neo_lvgl_sys::lv_anim_set_exec_cb(&mut raw, None);
+                neo_lvgl_sys::lv_anim_set_custom_exec_cb(&mut raw, Some(tracks.trampoline));
+                neo_lvgl_sys::lv_anim_timeline_add(self.raw.as_ptr(), start_time, &raw);
+            }
+            self
         }
     }
 }
@@ -572,15 +787,26 @@ impl AnimHandle {
 /// Animation timeline for sequencing multiple animations
 ///
 /// Timelines allow you to coordinate multiple animations with precise timing.
+///
+/// All tracks are driven from the timeline's single animation, so one tick
+/// updates every track. Use [`add_property`](Self::add_property) for common
+/// widget properties and, with `alloc`, [`with_tracks`](Self::with_tracks)
+/// for closure tracks sharing one allocation.
 pub struct AnimTimeline {
     raw: NonNull<neo_lvgl_sys::lv_anim_timeline_t>,
+    #[cfg(feature = "alloc")]
+    tracks: Option<closure_support::TrackExec>,
 }
 
 impl AnimTimeline {
     /// Create a new animation timeline
     pub fn new() -> Option<Self> {
         let ptr = unsafe { neo_lvgl_sys::lv_anim_timeline_create() };
-        NonNull::new(ptr).map(|raw| Self { raw })
+        NonNull::new(ptr).map(|raw| Self {
+            raw,
+            #[cfg(feature = "alloc")]
+            tracks: None,
+        })
     }
 
     /// Add an animation to the timeline
@@ -596,6 +822,23 @@ impl AnimTimeline {
         self
     }
 
+    /// Add a track animating a property of `widget` with a built-in exec callback
+    pub fn add_property<'a>(
+        &mut self,
+        start_time: u32,
+        anim: &Anim,
+        widget: &impl Widget<'a>,
+        property: AnimProperty,
+    ) -> &mut Self {
+        let mut raw = unsafe { core::ptr::read(&anim.raw) };
+        unsafe {
+            neo_lvgl_sys::lv_anim_set_var(&mut raw, widget.raw() as *mut c_void);
+            neo_lvgl_sys::lv_anim_set_exec_cb(&mut raw, Some(property.exec_cb()));
+            neo_lvgl_sys::lv_anim_timeline_add(self.raw.as_ptr(), start_time, &raw);
+        }
+        self
+    }
+
     /// Start the timeline
     ///
     /// Returns the total playtime in milliseconds.
@@ -709,6 +952,10 @@ impl Drop for AnimTimeline {
     fn drop(&mut self) {
         unsafe {
             neo_lvgl_sys::lv_anim_timeline_delete(self.raw.as_ptr());
+            #[cfg(feature = "alloc")]
+            if let Some(tracks) = self.tracks.take() {
+                (tracks.drop)(tracks.exec);
+            }
         }
     }
 }
@@ -0,0 +1,165 @@
+//! Compile-time image and font assets (requires `assets` feature)
+//!
+//! [`include_image!`](crate::include_image) converts a PNG and
+//! [`include_font!`](crate::include_font) rasterizes a TTF/OTF font while
+//! the crate compiles. The results are `static` LVGL images and fonts in
+//! flash: nothing is decoded or rasterized at runtime, and fonts only carry
+//! the glyphs that were asked for. Paths are relative to the crate's
+//! `Cargo.toml`, and the crate rebuilds when an asset changes.
+//!
+//! # Example
+//!
+//! ```ignore
+//! use lvgl::{include_font, include_image};
+//!
+//! static WIFI: &ImageAsset = include_image!("assets/wifi.png", format = RGB565A8);
+//! static SPLASH: &ImageAsset = include_image!("assets/splash.png", format = RGB565, rle);
+//! static DIGITS: &StaticFont = include_font!(
+//!     "assets/Roboto-Medium.ttf",
+//!     size = 48,
+//!     chars = "0123456789.,-+ °C%",
+//!     bpp = 4,
+//! );
+//!
+//! let icon = Image::new(&screen).unwrap();
+//! icon.set_src_static(WIFI.src());
+//! label.set_style_text_font(&DIGITS.font());
+//! ```
+//!
+//! `include_image!` options:
+//!
+//! - `format = ` `RGB565` (default), `RGB565A8`, `RGB888`, `ARGB8888`,
+//!   `XRGB8888`, `L8` or `A8`
+//! - `rle` - compress with LVGL's RLE (`LV_USE_RLE`); decoded on first draw
+//!   (keep it in the [`image_cache`](crate::image_cache))
+//!
+//! `include_font!` options: `size` in pixels (required), `chars` to include
+//! (default printable ASCII), `bpp = 4` (default) or `8`.
+//!
+//! XML components are compiled the same way with
+//! [`include_ui!`](crate::include_ui).
+
+use crate::image_cache::ImageSrc;
+use core::ffi::c_void;
+
+#[doc(hidden)]
+pub use neo_lvgl_macros::{
+    include_font as __include_font, include_image as __include_image, include_ui as __include_ui,
+};
+
+/// Convert a PNG into a static [`ImageAsset`] at compile time; see the
+/// [module docs](crate::asset).
+#[macro_export]
+macro_rules! include_image {
+    ($($args:tt)*) => {
+        $crate::asset::__include_image!($crate; $($args)*)
+    };
+}
+
+/// Rasterize a font subset into a static
+/// [`StaticFont`](crate::font::StaticFont) at compile time; see the
+/// [module docs](crate::asset).
+#[macro_export]
+macro_rules! include_font {
+    ($($args:tt)*) => {
+        $crate::asset::__include_font!($crate; $($args)*)
+    };
+}
+
+/// Compile a directory (or file) of XML components into a static
+/// [`CompiledUi`](crate::xml::CompiledUi); see the
+/// [`xml` module docs](crate::xml#precompiled-components).
+///
+/// A `globals.xml` next to the components, or the file given as
+/// `globals = "..."`, supplies the global constants.
+#[macro_export]
+macro_rules! include_ui {
+    ($($args:tt)*) => {
+        $crate::asset::__include_ui!($crate; $($args)*)
+    };
+}
+
+/// An image stored in flash, laid out as `lv_image_dsc_t`
+#[repr(C)]
+pub struct ImageAsset {
+    header: [u32; 3],
+    data_size: u32,
+    data: *const u8,
+    reserved: *const c_void,
+    reserved_2: *const c_void,
+}
+
+// SAFETY: immutable, and only points to 'static data
+unsafe impl Sync for ImageAsset {}
+
+// The descriptor is built by hand so it can be `const`; keep it in step
+// with LVGL's
+const _: () = {
+    use core::mem::{align_of, offset_of, size_of};
+    use neo_lvgl_sys::{lv_image_dsc_t, lv_image_header_t};
+
+    assert!(size_of::<lv_image_header_t>() == 12);
+    assert!(size_of::<ImageAsset>() == size_of::<lv_image_dsc_t>());
+    assert!(align_of::<ImageAsset>() == align_of::<lv_image_dsc_t>());
+    assert!(offset_of!(ImageAsset, header) == offset_of!(lv_image_dsc_t, header));
+    assert!(offset_of!(ImageAsset, data_size) == offset_of!(lv_image_dsc_t, data_size));
+    assert!(offset_of!(ImageAsset, data) == offset_of!(lv_image_dsc_t, data));
+    assert!(offset_of!(ImageAsset, reserved) == offset_of!(lv_image_dsc_t, reserved));
+    assert!(offset_of!(ImageAsset, reserved_2) == offset_of!(lv_image_dsc_t, reserved_2));
+};
+
+impl ImageAsset {
+    /// Create an image descriptor from generated pixel data
+    ///
+    /// # Safety
+    ///
+    /// `data` must hold `h` rows of `stride` bytes in color format `cf`
+    /// (with the RLE prefix if `flags` marks it compressed).
+    #[doc(hidden)]
+    pub const unsafe fn new(
+        cf: u32,
+        flags: u32,
+        w: u32,
+        h: u32,
+        stride: u32,
+        data: &'static [u8],
+    ) -> Self {
+        Self {
+            header: [
+                neo_lvgl_sys::LV_IMAGE_HEADER_MAGIC | (cf & 0xFF) << 8 | (flags & 0xFFFF) << 16,
+                (w & 0xFFFF) | (h & 0xFFFF) << 16,
+                stride & 0xFFFF,
+            ],
+            data_size: data.len() as u32,
+            data: data.as_ptr(),
+            reserved: core::ptr::null(),
+            reserved_2: core::ptr::null(),
+        }
+    }
+
+    /// Image width in pixels
+    pub const fn width(&self) -> u32 {
+        self.header[1] & 0xFFFF
+    }
+
+    /// Image height in pixels
+    pub const fn height(&self) -> u32 {
+        self.header[1] >> 16
+    }
+
+    /// Size of the stored (possibly compressed) data in bytes
+    pub const fn data_size(&self) -> u32 {
+        self.data_size
+    }
+
+    /// Get the raw image descriptor
+    pub const fn raw(&'static self) -> *const neo_lvgl_sys::lv_image_dsc_t {
+        self as *const Self as *const neo_lvgl_sys::lv_image_dsc_t
+    }
+
+    /// Use as an image source, e.g. for [`image_cache`](crate::image_cache)
+    /// or [`Image::set_src_static`](crate::widgets::Image::set_src_static)
+    pub const fn src(&'static self) -> ImageSrc {
+        unsafe { ImageSrc::from_raw(self.raw() as *const c_void) }
+    }
+}
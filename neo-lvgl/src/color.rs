@@ -34,9 +34,20 @@ impl Color {
         Self(neo_lvgl_sys::lv_color_t { blue: 255, green: 255, red: 255 })
     }
 
+    /// Create a color from a hex value (0xRRGGBB) in a const context
+    ///
+    /// Use this for [`ConstStyle`](crate::style::ConstStyle) properties.
+    pub const fn const_hex(hex: u32) -> Self {
+        Self(neo_lvgl_sys::lv_color_t {
+            blue: hex as u8,
+            green: (hex >> 8) as u8,
+            red: (hex >> 16) as u8,
+        })
+    }
+
     /// Get the raw LVGL color value
     #[inline]
-    pub(crate) fn raw(self) -> neo_lvgl_sys::lv_color_t {
+    pub(crate) const fn raw(self) -> neo_lvgl_sys::lv_color_t {
         self.0
     }
 
@@ -98,7 +109,7 @@ impl Opacity {
 
     /// Get the raw value
     #[inline]
-    pub(crate) fn raw(self) -> u8 {
+    pub(crate) const fn raw(self) -> u8 {
         self.0
     }
 
@@ -1,5 +1,7 @@
 //! Display management
 
+use crate::pixel::Pixel;
+use core::alloc::Layout;
 use core::ptr::NonNull;
 
 #[cfg(feature = "alloc")]
@@ -190,7 +192,7 @@ pub enum ColorFormat {
 }
 
 impl ColorFormat {
-    fn to_raw(self) -> neo_lvgl_sys::lv_color_format_t {
+    pub(crate) fn to_raw(self) -> neo_lvgl_sys::lv_color_format_t {
         match self {
             ColorFormat::L8 => neo_lvgl_sys::lv_color_format_t_LV_COLOR_FORMAT_L8,
             ColorFormat::A1 => neo_lvgl_sys::lv_color_format_t_LV_COLOR_FORMAT_A1,
@@ -211,7 +213,7 @@ impl ColorFormat {
         }
     }
 
-    fn from_raw(raw: neo_lvgl_sys::lv_color_format_t) -> Self {
+    pub(crate) fn from_raw(raw: neo_lvgl_sys::lv_color_format_t) -> Self {
         match raw {
             neo_lvgl_sys::lv_color_format_t_LV_COLOR_FORMAT_L8 => ColorFormat::L8,
             neo_lvgl_sys::lv_color_format_t_LV_COLOR_FORMAT_A1 => ColorFormat::A1,
@@ -269,10 +271,163 @@ pub trait DisplayDriver {
     /// * `pixels` - The pixel data in the display's color format
     fn flush(&mut self, area: &Area, pixels: &[u8]);
 
+    /// Flush pixels to the display with deferred completion.
+    ///
+    /// Override this to start a non-blocking transfer (e.g. SPI DMA) and
+    /// return immediately. LVGL keeps ownership of `pixels` away from the
+    /// renderer until `token` is completed, so with double buffering the next
+    /// strip is rendered into the other buffer while this one is on the wire.
+    ///
+    /// The default implementation calls [`flush`](Self::flush) and completes
+    /// the token right away.
+    ///
+    /// # Arguments
+    ///
+    /// * `area` - The rectangular area to update
+    /// * `pixels` - The pixel data in the display's color format
+    /// * `token` - Completion token; call [`FlushToken::complete`] when the
+    ///   transfer has finished (typically from the DMA-complete interrupt)
+    fn flush_async(&mut self, area: &Area, pixels: &[u8], token: FlushToken) {
+        self.flush(area, pixels);
+        token.complete();
+    }
+
+    /// Flush all areas of a frame from a full-screen buffer.
+    ///
+    /// Only used when flush batching is enabled on a [`ManagedDisplay`] in
+    /// [`RenderMode::Direct`]. `areas` are merged according to the display's
+    /// [`FlushCostModel`] and ordered top-to-bottom; the last entry is the
+    /// last area of the frame.
+    ///
+    /// In [`RenderMode::Partial`] this is never called: LVGL renders one area
+    /// at a time into the strip buffer, so batching can only merge areas as
+    /// they are invalidated. Each merged area still reaches
+    /// [`flush_async`](Self::flush_async) on its own, and the end of the frame
+    /// is only visible through [`FlushToken::is_last`].
+    ///
+    /// The default implementation calls [`flush`](Self::flush) once per area
+    /// with the area's pixels packed by [`FrameBuffer::area_pixels`]. Drivers
+    /// that stream line by line can use [`FrameBuffer::line`] instead.
+    fn flush_batch(&mut self, areas: &[Area], frame: &mut FrameBuffer<'_>, token: FlushToken) {
+        for area in areas {
+            self.flush(area, frame.area_pixels(area));
+        }
+        token.complete();
+    }
+
     /// Called when flush is complete (optional)
     fn flush_ready(&mut self) {}
 }
 
+/// Full-screen frame buffer handed to [`DisplayDriver::flush_batch`]
+pub struct FrameBuffer<'a> {
+    pixels: &'a [u8],
+    stride: usize,
+    bytes_per_pixel: usize,
+    scratch: &'a mut [u8],
+}
+
+impl<'a> FrameBuffer<'a> {
+    /// Get the whole frame buffer
+    #[inline]
+    pub fn pixels(&self) -> &'a [u8] {
+        self.pixels
+    }
+
+    /// Get the number of bytes per line
+    #[inline]
+    pub fn stride(&self) -> usize {
+        self.stride
+    }
+
+    /// Get the number of bytes per pixel
+    #[inline]
+    pub fn bytes_per_pixel(&self) -> usize {
+        self.bytes_per_pixel
+    }
+
+    /// Get the pixels of line `y` within `area`
+    pub fn line(&self, area: &Area, y: i16) -> &'a [u8] {
+        let start = (y as usize) * self.stride + (area.x1 as usize) * self.bytes_per_pixel;
+        let len = (area.width() as usize) * self.bytes_per_pixel;
+        &self.pixels[start..start + len]
+    }
+
+    /// Get the pixels of `area` as one contiguous block
+    ///
+    /// Single lines and areas spanning whole lines are borrowed from the
+    /// frame; anything else is packed into a scratch buffer owned by the
+    /// display, which is sized for the largest area of the batch.
+    pub fn area_pixels(&mut self, area: &Area) -> &[u8] {
+        let (pixels, stride) = (self.pixels, self.stride);
+        let x = (area.x1 as usize) * self.bytes_per_pixel;
+        let len = (area.width() as usize) * self.bytes_per_pixel;
+        let height = area.height() as usize;
+        if height == 1 || (x == 0 && len == stride) {
+            let start = (area.y1 as usize) * stride + x;
+            return &pixels[start..start + len * height];
+        }
+
+        let packed = &mut self.scratch[..len * height];
+        for (y, row) in (area.y1..=area.y2).zip(packed.chunks_exact_mut(len)) {
+            let start = (y as usize) * stride + x;
+            row.copy_from_slice(&pixels[start..start + len]);
+        }
+        packed
+    }
+}
+
+/// Completion token for a deferred flush.
+///
+/// Handed to [`DisplayDriver::flush_async`]. The pixel buffer passed alongside
+/// it must not be reused by LVGL until [`complete`](Self::complete) is called,
+/// so the token can be moved into an interrupt handler and completed when the
+/// transfer finishes.
+///
+/// Dropping the token without completing it leaves the display waiting for
+/// the flush forever.
+#[must_use = "the flush must be completed or LVGL will wait forever"]
+pub struct FlushToken {
+    disp: NonNull<neo_lvgl_sys::lv_display_t>,
+}
+
+// SAFETY: `lv_display_flush_ready` only clears the display's flushing flags
+// and is safe to call from an interrupt or another thread.
+unsafe impl Send for FlushToken {}
+
+impl FlushToken {
+    /// Create a token for the given display.
+    ///
+    /// # Safety
+    ///
+    /// A flush must be in progress on `disp`, and the token must be completed
+    /// at most once for that flush.
+    pub unsafe fn from_raw(disp: *mut neo_lvgl_sys::lv_display_t) -> Option<Self> {
+        NonNull::new(disp).map(|disp| Self { disp })
+    }
+
+    /// Check if this is the last area flushed for the current frame.
+    pub fn is_last(&self) -> bool {
+        unsafe { neo_lvgl_sys::lv_display_flush_is_last(self.disp.as_ptr()) }
+    }
+
+    /// Signal LVGL that the transfer is done and the buffer can be reused.
+    ///
+    /// This is interrupt-safe.
+    #[inline]
+    pub fn complete(self) {
+        unsafe {
+            neo_lvgl_sys::lv_display_flush_ready(self.disp.as_ptr());
+        }
+    }
+
+    /// Get the raw display pointer
+    #[inline]
+    pub fn raw(&self) -> *mut neo_lvgl_sys::lv_display_t {
+        self.disp.as_ptr()
+    }
+}
+
 /// Rectangular area
 #[derive(Clone, Copy, Debug)]
 pub struct Area {
@@ -284,6 +439,7 @@ pub struct Area {
 
 impl Area {
     /// Create from raw LVGL area
+    #[inline]
     pub fn from_raw(raw: &neo_lvgl_sys::lv_area_t) -> Self {
         Self {
             x1: raw.x1 as i16,
@@ -310,6 +466,376 @@ impl Area {
     pub fn pixel_count(&self) -> usize {
         (self.width() as usize) * (self.height() as usize)
     }
+
+    /// Create an area from its corner coordinates (inclusive)
+    #[inline]
+    pub const fn new(x1: i16, y1: i16, x2: i16, y2: i16) -> Self {
+        Self { x1, y1, x2, y2 }
+    }
+
+    /// Convert to a raw LVGL area
+    pub fn to_raw(&self) -> neo_lvgl_sys::lv_area_t {
+        neo_lvgl_sys::lv_area_t {
+            x1: self.x1 as i32,
+            y1: self.y1 as i32,
+            x2: self.x2 as i32,
+            y2: self.y2 as i32,
+        }
+    }
+
+    /// Get the smallest area containing both areas
+    pub fn union(&self, other: &Area) -> Area {
+        Area {
+            x1: self.x1.min(other.x1),
+            y1: self.y1.min(other.y1),
+            x2: self.x2.max(other.x2),
+            y2: self.y2.max(other.y2),
+        }
+    }
+}
+
+/// Maximum number of areas tracked per frame by an [`AreaBatch`].
+///
+/// Matches LVGL's default `LV_INV_BUF_SIZE`.
+pub const MAX_BATCH_AREAS: usize = 32;
+
+/// Cost model for merging flush areas
+///
+/// Every flush transaction has a fixed overhead (address window setup,
+/// command bytes, DMA start latency) on top of the pixels it transfers.
+/// Two areas are merged when flushing their bounding box is no more
+/// expensive than flushing both separately.
+#[derive(Clone, Copy, Debug, PartialEq, Eq, Default)]
+pub struct FlushCostModel {
+    /// Fixed cost of one flush transaction, expressed in pixels
+    pub transaction_cost_px: u32,
+}
+
+impl FlushCostModel {
+    /// Create a cost model with the given per-transaction overhead in pixels
+    pub const fn new(transaction_cost_px: u32) -> Self {
+        Self {
+            transaction_cost_px,
+        }
+    }
+
+    /// Get the cost of flushing `area` as one transaction
+    #[inline]
+    pub fn cost(&self, area: &Area) -> u64 {
+        self.transaction_cost_px as u64 + area.pixel_count() as u64
+    }
+
+    /// Check if flushing `a` and `b` as one transaction is not more expensive
+    #[inline]
+    pub fn should_merge(&self, a: &Area, b: &Area) -> bool {
+        self.cost(&a.union(b)) <= self.cost(a) + self.cost(b)
+    }
+}
+
+/// Fixed-capacity set of areas merged according to a [`FlushCostModel`]
+#[derive(Clone, Debug)]
+pub struct AreaBatch {
+    model: FlushCostModel,
+    areas: [Area; MAX_BATCH_AREAS],
+    len: usize,
+}
+
+impl AreaBatch {
+    /// Create an empty batch
+    pub const fn new(model: FlushCostModel) -> Self {
+        Self {
+            model,
+            areas: [Area::new(0, 0, 0, 0); MAX_BATCH_AREAS],
+            len: 0,
+        }
+    }
+
+    /// Get the cost model used for merging
+    pub fn model(&self) -> FlushCostModel {
+        self.model
+    }
+
+    /// Add an area, merging it with batched areas where that is cheaper.
+    ///
+    /// Returns the area as stored, which covers `area` and everything it
+    /// was merged with. When the batch is full, the area is merged with the
+    /// entry whose bounding box grows the least.
+    pub fn add(&mut self, area: Area) -> Area {
+        let mut merged = area;
+        let mut i = 0;
+        while i < self.len {
+            if self.model.should_merge(&merged, &self.areas[i]) {
+                merged = merged.union(&self.areas[i]);
+                self.remove(i);
+                // The grown area may now be worth merging with earlier entries
+                i = 0;
+            } else {
+                i += 1;
+            }
+        }
+
+        if self.len == MAX_BATCH_AREAS {
+            let closest = (0..self.len)
+                .min_by_key(|&i| {
+                    let existing = &self.areas[i];
+                    existing.union(&merged).pixel_count() - existing.pixel_count()
+                })
+                .unwrap_or(0);
+            merged = merged.union(&self.areas[closest]);
+            self.remove(closest);
+            return self.add(merged);
+        }
+
+        self.areas[self.len] = merged;
+        self.len += 1;
+        merged
+    }
+
+    /// Get the batched areas
+    pub fn areas(&self) -> &[Area] {
+        &self.areas[..self.len]
+    }
+
+    /// Get the number of batched areas
+    pub fn len(&self) -> usize {
+        self.len
+    }
+
+    /// Check if the batch is empty
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+
+    /// Remove all areas
+    pub fn clear(&mut self) {
+        self.len = 0;
+    }
+
+    /// Order areas top-to-bottom, then left-to-right
+    pub fn sort(&mut self) {
+        self.areas[..self.len].sort_unstable_by_key(|a| (a.y1, a.x1));
+    }
+
+    fn remove(&mut self, index: usize) {
+        self.areas.copy_within(index + 1..self.len, index);
+        self.len -= 1;
+    }
+}
+
+/// Stride alignment of draw buffers (`LV_DRAW_BUF_STRIDE_ALIGN` in `lv_conf.h`)
+const STRIDE_ALIGN: usize = neo_lvgl_sys::LV_DRAW_BUF_STRIDE_ALIGN as usize;
+
+/// Start address alignment of draw buffers (`LV_DRAW_BUF_ALIGN` in `lv_conf.h`)
+const BUF_ALIGN: usize = neo_lvgl_sys::LV_DRAW_BUF_ALIGN as usize;
+
+/// Round `value` up to a multiple of `align`
+#[inline]
+const fn align_up(value: usize, align: usize) -> usize {
+    if align <= 1 {
+        value
+    } else {
+        value.div_ceil(align) * align
+    }
+}
+
+/// Copy `height` lines of `line` bytes, `stride` bytes apart, to `dst`
+///
+/// Lines are moved front to back, so `dst` may be `src` itself to squeeze the
+/// line padding out of a buffer in place.
+#[cfg(feature = "alloc")]
+unsafe fn gather_lines(src: *const u8, stride: usize, line: usize, height: usize, dst: *mut u8) {
+    for y in 0..height {
+        core::ptr::copy(src.add(y * stride), dst.add(y * line), line);
+    }
+}
+
+/// Requested size of each display buffer
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum BufferSize {
+    /// The whole screen (required for Direct and Full render modes)
+    FullScreen,
+    /// A strip of this many lines per buffer (Partial mode only)
+    Lines(u32),
+    /// As many lines as fit in this many bytes across all buffers (Partial mode only)
+    Budget(usize),
+}
+
+/// Memory capabilities requested for a display buffer
+///
+/// Interpreted by the [`BufferAllocator`]; the default heap allocator
+/// ignores them.
+#[derive(Clone, Copy, Debug, PartialEq, Eq, Default)]
+pub enum MemoryCaps {
+    /// Any memory the allocator sees fit
+    #[default]
+    Default,
+    /// Internal RAM the display peripheral can DMA from
+    InternalDma,
+    /// External RAM such as PSRAM (large, but slower and not always DMA-capable)
+    External,
+}
+
+/// Allocator for display buffers
+///
+/// Implement this to place buffers in specific memory regions, e.g. with
+/// `heap_caps_aligned_alloc` on ESP-IDF.
+pub trait BufferAllocator: Sync {
+    /// Allocate memory for `layout` with the requested capabilities.
+    ///
+    /// Returns `None` if no such memory is available.
+    fn allocate(&self, layout: Layout, caps: MemoryCaps) -> Option<NonNull<u8>>;
+
+    /// Free memory returned by [`allocate`](Self::allocate).
+    ///
+    /// # Safety
+    ///
+    /// `ptr` must have been returned by `allocate` on this allocator with the
+    /// same `layout` and `caps`, and must not be used afterwards.
+    unsafe fn deallocate(&self, ptr: NonNull<u8>, layout: Layout, caps: MemoryCaps);
+}
+
+/// Buffer allocator backed by the global allocator
+///
+/// Memory capabilities are ignored.
+#[cfg(feature = "alloc")]
+pub struct HeapBufferAllocator;
+
+#[cfg(feature = "alloc")]
+impl BufferAllocator for HeapBufferAllocator {
+    fn allocate(&self, layout: Layout, _caps: MemoryCaps) -> Option<NonNull<u8>> {
+        if layout.size() == 0 {
+            return None;
+        }
+        NonNull::new(unsafe { alloc::alloc::alloc_zeroed(layout) })
+    }
+
+    unsafe fn deallocate(&self, ptr: NonNull<u8>, layout: Layout, _caps: MemoryCaps) {
+        alloc::alloc::dealloc(ptr.as_ptr(), layout);
+    }
+}
+
+/// Size and count of display buffers worked out for a display
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub struct BufferLayout {
+    /// Bytes per line, padded to `LV_DRAW_BUF_STRIDE_ALIGN`
+    pub stride: usize,
+    /// Lines per buffer
+    pub lines: u32,
+    /// Bytes per buffer
+    pub buf_size: usize,
+    /// Number of buffers (1 or 2)
+    pub buffers: u8,
+}
+
+impl BufferLayout {
+    /// Work out the buffer layout for a display.
+    ///
+    /// Buffers hold whole, stride-aligned lines. With [`BufferSize::Budget`]
+    /// and `double_buffer`, the budget is split between two buffers; if it
+    /// cannot hold two lines, a single buffer is used instead.
+    ///
+    /// Sub-byte formats are sized at one byte per pixel.
+    ///
+    /// Returns `None` if the size is invalid for the render mode (Direct and
+    /// Full need [`BufferSize::FullScreen`]) or the budget is below one line.
+    pub fn plan(
+        width: i32,
+        height: i32,
+        color_format: ColorFormat,
+        render_mode: RenderMode,
+        size: BufferSize,
+        double_buffer: bool,
+    ) -> Option<Self> {
+        if width <= 0 || height <= 0 {
+            return None;
+        }
+
+        let stride = align_up(width as usize * color_format.bytes_per_pixel(), STRIDE_ALIGN);
+        let height = height as u32;
+        let mut buffers: u8 = if double_buffer { 2 } else { 1 };
+
+        let lines = match (render_mode, size) {
+            (_, BufferSize::FullScreen) => height,
+            (RenderMode::Partial, BufferSize::Lines(lines)) => lines.clamp(1, height),
+            (RenderMode::Partial, BufferSize::Budget(bytes)) => {
+                let mut lines = bytes / buffers as usize / stride;
+                if lines == 0 && buffers == 2 {
+                    buffers = 1;
+                    lines = bytes / stride;
+                }
+                if lines == 0 {
+                    return None;
+                }
+                (lines as u32).min(height)
+            }
+            // Direct and Full modes always render into a full-screen buffer
+            _ => return None,
+        };
+
+        Some(Self {
+            stride,
+            lines,
+            buf_size: stride * lines as usize,
+            buffers,
+        })
+    }
+}
+
+/// Buffer configuration for [`ManagedDisplay::with_buffer_config`]
+#[cfg(feature = "alloc")]
+#[derive(Clone, Copy)]
+pub struct BufferConfig {
+    /// Size of each buffer
+    pub size: BufferSize,
+    /// Whether to allocate a second buffer
+    pub double_buffer: bool,
+    /// Memory capabilities of the first buffer
+    pub buf1_caps: MemoryCaps,
+    /// Memory capabilities of the second buffer
+    pub buf2_caps: MemoryCaps,
+    /// Allocator the buffers come from
+    pub allocator: &'static dyn BufferAllocator,
+}
+
+#[cfg(feature = "alloc")]
+impl BufferConfig {
+    /// Full-screen buffers from the global allocator
+    pub fn full_screen(double_buffer: bool) -> Self {
+        Self::new(BufferSize::FullScreen, double_buffer)
+    }
+
+    /// Strips of `lines` lines from the global allocator
+    pub fn lines(lines: u32, double_buffer: bool) -> Self {
+        Self::new(BufferSize::Lines(lines), double_buffer)
+    }
+
+    /// As many lines as fit in `bytes` from the global allocator
+    pub fn budget(bytes: usize, double_buffer: bool) -> Self {
+        Self::new(BufferSize::Budget(bytes), double_buffer)
+    }
+
+    /// Set the memory capabilities of each buffer
+    pub fn with_caps(mut self, buf1: MemoryCaps, buf2: MemoryCaps) -> Self {
+        self.buf1_caps = buf1;
+        self.buf2_caps = buf2;
+        self
+    }
+
+    /// Set the allocator the buffers come from
+    pub fn with_allocator(mut self, allocator: &'static dyn BufferAllocator) -> Self {
+        self.allocator = allocator;
+        self
+    }
+
+    fn new(size: BufferSize, double_buffer: bool) -> Self {
+        Self {
+            size,
+            double_buffer,
+            buf1_caps: MemoryCaps::Default,
+            buf2_caps: MemoryCaps::Default,
+            allocator: &HeapBufferAllocator,
+        }
+    }
 }
 
 /// A display that owns its driver and manages the flush callback automatically.
@@ -332,6 +858,14 @@ impl Area {
 ///     fn flush(&mut self, area: &Area, pixels: &[u8]) {
 ///         // Send pixels to your display hardware
 ///     }
+///
+///     // Optional: start a DMA transfer and complete the token from the
+///     // DMA-complete interrupt so LVGL can render into the other buffer
+///     // in the meantime (use `double_buffer = true`).
+///     fn flush_async(&mut self, area: &Area, pixels: &[u8], token: FlushToken) {
+///         self.spi.start_dma(area, pixels);
+///         PENDING_FLUSH.put(token); // the ISR calls `token.complete()`
+///     }
 /// }
 ///
 /// // Easy way - let ManagedDisplay create and manage buffers
@@ -352,10 +886,58 @@ impl Area {
 pub struct ManagedDisplay<D: DisplayDriver> {
     display: Display,
     // Boxed so we have a stable address for the pointer stored in user_data
-    driver: Box<D>,
+    state: Box<DriverState<D>>,
     // Optional owned buffers (when using with_buffers constructor)
-    _buf1: Option<Vec<u8>>,
-    _buf2: Option<Vec<u8>>,
+    _buf1: Option<DisplayBuffer>,
+    _buf2: Option<DisplayBuffer>,
+}
+
+/// Display buffer owned by a [`ManagedDisplay`]
+#[cfg(feature = "alloc")]
+struct DisplayBuffer {
+    ptr: NonNull<u8>,
+    layout: Layout,
+    caps: MemoryCaps,
+    allocator: &'static dyn BufferAllocator,
+}
+
+#[cfg(feature = "alloc")]
+impl DisplayBuffer {
+    fn new(
+        allocator: &'static dyn BufferAllocator,
+        size: usize,
+        align: usize,
+        caps: MemoryCaps,
+    ) -> Option<Self> {
+        let layout = Layout::from_size_align(size, align).ok()?;
+        let ptr = allocator.allocate(layout, caps)?;
+        Some(Self {
+            ptr,
+            layout,
+            caps,
+            allocator,
+        })
+    }
+}
+
+#[cfg(feature = "alloc")]
+impl Drop for DisplayBuffer {
+    fn drop(&mut self) {
+        unsafe {
+            self.allocator.deallocate(self.ptr, self.layout, self.caps);
+        }
+    }
+}
+
+/// Driver plus the per-display state the trampolines need
+#[cfg(feature = "alloc")]
+struct DriverState<D> {
+    driver: D,
+    render_mode: RenderMode,
+    batch: Option<AreaBatch>,
+    batch_hooks: bool,
+    /// Packing buffer for [`FrameBuffer::area_pixels`]
+    scratch: Vec<u8>,
 }
 
 #[cfg(feature = "alloc")]
@@ -370,7 +952,8 @@ impl<D: DisplayDriver> ManagedDisplay<D> {
     /// * `driver` - Your display driver implementation
     /// * `color_format` - The pixel format for the buffers
     /// * `render_mode` - The rendering mode to use
-    /// * `double_buffer` - Whether to use double buffering (smoother but uses 2x memory)
+    /// * `double_buffer` - Whether to use double buffering (smoother but uses 2x memory;
+    ///   combine with [`DisplayDriver::flush_async`] to render while flushing)
     ///
     /// # Example
     ///
@@ -387,48 +970,102 @@ impl<D: DisplayDriver> ManagedDisplay<D> {
         color_format: ColorFormat,
         render_mode: RenderMode,
         double_buffer: bool,
+    ) -> Option<Self> {
+        Self::with_buffer_config(
+            driver,
+            color_format,
+            render_mode,
+            BufferConfig::full_screen(double_buffer),
+        )
+    }
+
+    /// Create a managed display with buffers sized and placed by `config`.
+    ///
+    /// In [`RenderMode::Partial`] the buffers can be strips of a few lines
+    /// ([`BufferSize::Lines`]) or whatever fits a byte budget
+    /// ([`BufferSize::Budget`]); see [`BufferLayout::plan`]. Each buffer is
+    /// allocated from `config.allocator` with its own [`MemoryCaps`].
+    ///
+    /// Returns `None` if the layout is invalid for the render mode or an
+    /// allocation fails.
+    ///
+    /// # Example
+    ///
+    /// ```ignore
+    /// // Two 40-line strips in internal DMA-capable RAM
+    /// let config = BufferConfig::lines(40, true)
+    ///     .with_caps(MemoryCaps::InternalDma, MemoryCaps::InternalDma)
+    ///     .with_allocator(&MY_HEAP_CAPS_ALLOCATOR);
+    /// let display = ManagedDisplay::with_buffer_config(
+    ///     driver,
+    ///     ColorFormat::Rgb565,
+    ///     RenderMode::Partial,
+    ///     config,
+    /// ).unwrap();
+    /// ```
+    pub fn with_buffer_config(
+        driver: D,
+        color_format: ColorFormat,
+        render_mode: RenderMode,
+        config: BufferConfig,
     ) -> Option<Self> {
         let (width, height) = driver.size();
+        let layout = BufferLayout::plan(
+            width,
+            height,
+            color_format,
+            render_mode,
+            config.size,
+            config.double_buffer,
+        )?;
         let display = Display::new(width, height)?;
 
-        // Calculate buffer size
-        let buf_size = (width as usize) * (height as usize) * color_format.bytes_per_pixel();
-
         // Allocate buffers
-        let mut buf1 = alloc::vec![0u8; buf_size];
-        let mut buf2 = if double_buffer {
-            Some(alloc::vec![0u8; buf_size])
+        let buf1 = DisplayBuffer::new(
+            config.allocator,
+            layout.buf_size,
+            BUF_ALIGN,
+            config.buf1_caps,
+        )?;
+        let buf2 = if layout.buffers == 2 {
+            Some(DisplayBuffer::new(
+                config.allocator,
+                layout.buf_size,
+                BUF_ALIGN,
+                config.buf2_caps,
+            )?)
         } else {
             None
         };
 
         // Box the driver so it has a stable address
-        let driver = Box::new(driver);
+        let state = Box::new(DriverState::new(driver, render_mode));
 
-        // Store pointer to driver in display's user_data
-        let driver_ptr = &*driver as *const D as *mut core::ffi::c_void;
+        // Store pointer to driver state in display's user_data
+        let state_ptr = &*state as *const DriverState<D> as *mut core::ffi::c_void;
         unsafe {
-            neo_lvgl_sys::lv_display_set_user_data(display.raw(), driver_ptr);
+            neo_lvgl_sys::lv_display_set_user_data(display.raw(), state_ptr);
         }
 
-        // Set up buffers - we pass raw pointers since we're keeping the Vecs alive
+        // The color format must be set before the buffers so LVGL checks
+        // their size against the right stride
+        display.set_color_format(color_format);
+
+        // Set up buffers - we pass raw pointers since we're keeping the buffers alive
         let buf2_ptr = buf2
-            .as_mut()
-            .map(|b| b.as_mut_ptr())
+            .as_ref()
+            .map(|b| b.ptr.as_ptr())
             .unwrap_or(core::ptr::null_mut());
         unsafe {
             neo_lvgl_sys::lv_display_set_buffers(
                 display.raw(),
-                buf1.as_mut_ptr() as *mut _,
+                buf1.ptr.as_ptr() as *mut _,
                 buf2_ptr as *mut _,
-                buf_size as u32,
+                layout.buf_size as u32,
                 render_mode.to_raw(),
             );
         }
 
-        // Set color format
-        display.set_color_format(color_format);
-
         // Set up the flush callback trampoline
         unsafe {
             neo_lvgl_sys::lv_display_set_flush_cb(display.raw(), Some(Self::flush_trampoline));
@@ -436,7 +1073,7 @@ impl<D: DisplayDriver> ManagedDisplay<D> {
 
         Some(Self {
             display,
-            driver,
+            state,
             _buf1: Some(buf1),
             _buf2: buf2,
         })
@@ -467,11 +1104,11 @@ impl<D: DisplayDriver> ManagedDisplay<D> {
         let display = Display::new(width, height)?;
 
         // Box the driver so it has a stable address
-        let driver = Box::new(driver);
+        let state = Box::new(DriverState::new(driver, render_mode));
 
-        // Store pointer to driver in display's user_data
-        let driver_ptr = &*driver as *const D as *mut core::ffi::c_void;
-        neo_lvgl_sys::lv_display_set_user_data(display.raw(), driver_ptr);
+        // Store pointer to driver state in display's user_data
+        let state_ptr = &*state as *const DriverState<D> as *mut core::ffi::c_void;
+        neo_lvgl_sys::lv_display_set_user_data(display.raw(), state_ptr);
 
         // Set up buffers
         display.set_buffers(buf1, buf2, render_mode);
@@ -481,7 +1118,7 @@ impl<D: DisplayDriver> ManagedDisplay<D> {
 
         Some(Self {
             display,
-            driver,
+            state,
             _buf1: None,
             _buf2: None,
         })
@@ -511,12 +1148,49 @@ impl<D: DisplayDriver> ManagedDisplay<D> {
 
     /// Get a reference to the driver.
     pub fn driver(&self) -> &D {
-        &self.driver
+        &self.state.driver
     }
 
     /// Get a mutable reference to the driver.
     pub fn driver_mut(&mut self) -> &mut D {
-        &mut self.driver
+        &mut self.state.driver
+    }
+
+    /// Enable or disable flush batching.
+    ///
+    /// With batching enabled, areas refreshed in the same frame are merged
+    /// whenever `model` says one larger transaction is cheaper than several
+    /// small ones. In [`RenderMode::Direct`] the merged areas of a frame are
+    /// handed to [`DisplayDriver::flush_batch`] in a single call. In
+    /// [`RenderMode::Partial`] areas are merged as they are invalidated but
+    /// each merged area is still flushed on its own through
+    /// [`DisplayDriver::flush_async`]; see [`DisplayDriver::flush_batch`].
+    ///
+    /// Pass `None` to disable batching.
+    pub fn set_flush_batching(&mut self, model: Option<FlushCostModel>) {
+        self.state.batch = model.map(AreaBatch::new);
+
+        if self.state.batch.is_some()
+            && self.state.render_mode == RenderMode::Partial
+            && !self.state.batch_hooks
+        {
+            let state_ptr = &mut *self.state as *mut DriverState<D> as *mut core::ffi::c_void;
+            unsafe {
+                neo_lvgl_sys::lv_display_add_event_cb(
+                    self.display.raw(),
+                    Some(Self::batch_event_trampoline),
+                    neo_lvgl_sys::lv_event_code_t_LV_EVENT_INVALIDATE_AREA,
+                    state_ptr,
+                );
+                neo_lvgl_sys::lv_display_add_event_cb(
+                    self.display.raw(),
+                    Some(Self::batch_event_trampoline),
+                    neo_lvgl_sys::lv_event_code_t_LV_EVENT_REFR_READY,
+                    state_ptr,
+                );
+            }
+            self.state.batch_hooks = true;
+        }
     }
 
     /// Set this display as the default.
@@ -555,27 +1229,505 @@ impl<D: DisplayDriver> ManagedDisplay<D> {
         area: *const neo_lvgl_sys::lv_area_t,
         px_map: *mut u8,
     ) {
-        // Get driver pointer from user_data
-        let driver_ptr = neo_lvgl_sys::lv_display_get_user_data(disp) as *mut D;
-        if driver_ptr.is_null() {
+        // Get driver state pointer from user_data
+        let state_ptr = neo_lvgl_sys::lv_display_get_user_data(disp) as *mut DriverState<D>;
+        if state_ptr.is_null() {
             return;
         }
 
-        let driver = &mut *driver_ptr;
+        let DriverState {
+            driver,
+            render_mode,
+            batch,
+            scratch,
+            ..
+        } = &mut *state_ptr;
         let area_ref = &*area;
         let rust_area = Area::from_raw(area_ref);
-
-        // Calculate buffer size based on area and color format
         let color_format = ColorFormat::from_raw(neo_lvgl_sys::lv_display_get_color_format(disp));
-        let pixel_count = rust_area.pixel_count();
-        let buf_size = pixel_count * color_format.bytes_per_pixel();
+        let token = FlushToken {
+            disp: NonNull::new_unchecked(disp),
+        };
+
+        if let (Some(batch), RenderMode::Direct) = (batch.as_mut(), *render_mode) {
+            // The buffer holds the whole screen, so collect the frame's areas
+            // and flush them together once LVGL has rendered the last one
+            batch.add(rust_area);
+            if !neo_lvgl_sys::lv_display_flush_is_last(disp) {
+                token.complete();
+                return;
+            }
+
+            batch.sort();
+            let largest = batch
+                .areas()
+                .iter()
+                .map(|area| area.pixel_count() * color_format.bytes_per_pixel())
+                .max()
+                .unwrap_or(0);
+            let mut frame = screen_frame(disp, px_map, color_format, scratch, largest);
+            driver.flush_batch(batch.areas(), &mut frame, token);
+            batch.clear();
+            return;
+        }
+
+        // LVGL pads every line to the draw buffer stride; drivers get the
+        // area's lines back to back
+        let line = (rust_area.width() as usize) * color_format.bytes_per_pixel();
+        let height = rust_area.height() as usize;
+
+        // Call the Rust driver; it signals completion through the token,
+        // either immediately or later from its transfer-complete handler
+        if *render_mode == RenderMode::Partial {
+            // The strip holds just this area and is rendered over next, so
+            // the padding can be squeezed out in place
+            let stride = neo_lvgl_sys::lv_draw_buf_width_to_stride(
+                rust_area.width() as u32,
+                color_format.to_raw(),
+            ) as usize;
+            if stride != line {
+                gather_lines(px_map, stride, line, height, px_map);
+            }
+            let pixels = core::slice::from_raw_parts(px_map as *const u8, line * height);
+            driver.flush_async(&rust_area, pixels, token);
+        } else {
+            // The buffer is the whole screen and has to stay intact
+            let mut frame = screen_frame(disp, px_map, color_format, scratch, line * height);
+            driver.flush_async(&rust_area, frame.area_pixels(&rust_area), token);
+        }
+    }
+
+    /// Display event trampoline that merges invalidated areas (partial mode)
+    unsafe extern "C" fn batch_event_trampoline(e: *mut neo_lvgl_sys::lv_event_t) {
+        let state_ptr = neo_lvgl_sys::lv_event_get_user_data(e) as *mut DriverState<D>;
+        if state_ptr.is_null() {
+            return;
+        }
+
+        if let Some(batch) = (*state_ptr).batch.as_mut() {
+            match neo_lvgl_sys::lv_event_get_code(e) {
+                neo_lvgl_sys::lv_event_code_t_LV_EVENT_INVALIDATE_AREA => {
+                    // LVGL lets us grow the area before it is stored; areas it
+                    // already holds that end up inside it are joined later
+                    let area = neo_lvgl_sys::lv_event_get_param(e) as *mut neo_lvgl_sys::lv_area_t;
+                    if !area.is_null() {
+                        let merged = batch.add(Area::from_raw(&*area));
+                        *area = merged.to_raw();
+                    }
+                }
+                neo_lvgl_sys::lv_event_code_t_LV_EVENT_REFR_READY => batch.clear(),
+                _ => {}
+            }
+        }
+    }
+}
+
+/// The whole-screen buffer of a Direct or Full mode display
+///
+/// `scratch` is grown to `largest` bytes so every area up to that size can be
+/// packed by [`FrameBuffer::area_pixels`].
+#[cfg(feature = "alloc")]
+unsafe fn screen_frame<'a>(
+    disp: *mut neo_lvgl_sys::lv_display_t,
+    px_map: *mut u8,
+    color_format: ColorFormat,
+    scratch: &'a mut Vec<u8>,
+    largest: usize,
+) -> FrameBuffer<'a> {
+    let width = neo_lvgl_sys::lv_display_get_horizontal_resolution(disp);
+    let height = neo_lvgl_sys::lv_display_get_vertical_resolution(disp);
+    let stride =
+        neo_lvgl_sys::lv_draw_buf_width_to_stride(width as u32, color_format.to_raw()) as usize;
+    if scratch.len() < largest {
+        scratch.resize(largest, 0);
+    }
+    FrameBuffer {
+        pixels: core::slice::from_raw_parts(px_map, stride * (height as usize)),
+        stride,
+        bytes_per_pixel: color_format.bytes_per_pixel(),
+        scratch,
+    }
+}
+
+#[cfg(feature = "alloc")]
+impl<D> DriverState<D> {
+    fn new(driver: D, render_mode: RenderMode) -> Self {
+        Self {
+            driver,
+            render_mode,
+            batch: None,
+            batch_hooks: false,
+            scratch: Vec::new(),
+        }
+    }
+}
+
+/// Display driver with a pixel format fixed at compile time
+///
+/// The typed counterpart of [`DisplayDriver`]: the color format and bytes per
+/// pixel come from [`Self::Pixel`], so [`TypedDisplay`] does not have to query
+/// them on every flush, and the driver receives a typed pixel slice its copy
+/// loops can work on directly.
+///
+/// # Example
+///
+/// ```ignore
+/// use lvgl::pixel::Rgb565;
+///
+/// impl TypedDisplayDriver for MyDriver {
+///     type Pixel = Rgb565;
+///
+///     fn size(&self) -> (i32, i32) {
+///         (320, 240)
+///     }
+///
+///     fn flush(&mut self, area: &Area, pixels: &[Rgb565]) {
+///         self.spi.write_pixels(area, pixels);
+///     }
+/// }
+///
+/// let display = TypedDisplay::with_buffers(MyDriver::new(), RenderMode::Partial, true).unwrap();
+/// ```
+pub trait TypedDisplayDriver {
+    /// The pixel type of the display buffers
+    type Pixel: Pixel;
+
+    /// Get display dimensions (width, height)
+    fn size(&self) -> (i32, i32);
+
+    /// Flush pixels to the display
+    ///
+    /// `pixels` holds exactly `area.pixel_count()` pixels.
+    fn flush(&mut self, area: &Area, pixels: &[Self::Pixel]);
+
+    /// Flush pixels to the display with deferred completion.
+    ///
+    /// See [`DisplayDriver::flush_async`].
+    fn flush_async(&mut self, area: &Area, pixels: &[Self::Pixel], token: FlushToken) {
+        self.flush(area, pixels);
+        token.complete();
+    }
+}
+
+/// A display that owns a [`TypedDisplayDriver`] and its typed buffers.
+///
+/// Like [`ManagedDisplay`], but the pixel format is part of the type: the
+/// color format is set once at construction and the flush path only casts the
+/// buffer to `&[D::Pixel]`.
+#[cfg(feature = "alloc")]
+pub struct TypedDisplay<D: TypedDisplayDriver> {
+    display: Display,
+    // Boxed so we have a stable address for the pointer stored in user_data
+    state: Box<TypedState<D>>,
+    // Optional owned buffers (when using with_buffers constructor)
+    _buf1: Option<DisplayBuffer>,
+    _buf2: Option<DisplayBuffer>,
+}
+
+/// Driver state shared with the flush callback of a [`TypedDisplay`]
+#[cfg(feature = "alloc")]
+struct TypedState<D: TypedDisplayDriver> {
+    driver: D,
+    render_mode: RenderMode,
+    /// Packing buffer for areas of a whole-screen buffer
+    scratch: Vec<D::Pixel>,
+}
+
+#[cfg(feature = "alloc")]
+impl<D: TypedDisplayDriver> TypedDisplay<D> {
+    /// Create a typed display that allocates and owns its buffers.
+    ///
+    /// # Arguments
+    ///
+    /// * `driver` - Your display driver implementation
+    /// * `render_mode` - The rendering mode to use
+    /// * `double_buffer` - Whether to use double buffering
+    pub fn with_buffers(driver: D, render_mode: RenderMode, double_buffer: bool) -> Option<Self> {
+        Self::with_buffer_config(
+            driver,
+            render_mode,
+            BufferConfig::full_screen(double_buffer),
+        )
+    }
+
+    /// Create a typed display with buffers sized and placed by `config`.
+    ///
+    /// See [`ManagedDisplay::with_buffer_config`].
+    pub fn with_buffer_config(
+        driver: D,
+        render_mode: RenderMode,
+        config: BufferConfig,
+    ) -> Option<Self> {
+        let (width, height) = driver.size();
+        let layout = BufferLayout::plan(
+            width,
+            height,
+            <D::Pixel as Pixel>::FORMAT,
+            render_mode,
+            config.size,
+            config.double_buffer,
+        )?;
+
+        // The flush path reads the buffers as `[D::Pixel]`
+        let align = BUF_ALIGN.max(core::mem::align_of::<D::Pixel>());
+        let buf1 = DisplayBuffer::new(config.allocator, layout.buf_size, align, config.buf1_caps)?;
+        let buf2 = if layout.buffers == 2 {
+            Some(DisplayBuffer::new(
+                config.allocator,
+                layout.buf_size,
+                align,
+                config.buf2_caps,
+            )?)
+        } else {
+            None
+        };
+
+        let buf2_ptr = buf2
+            .as_ref()
+            .map(|b| b.ptr.as_ptr())
+            .unwrap_or(core::ptr::null_mut());
+        let display = unsafe {
+            Self::init(
+                driver,
+                buf1.ptr.as_ptr(),
+                buf2_ptr,
+                layout.buf_size,
+                render_mode,
+            )?
+        };
+
+        Some(Self {
+            _buf1: Some(buf1),
+            _buf2: buf2,
+            ..display
+        })
+    }
+
+    /// Create a typed display with static buffers you provide.
+    ///
+    /// # Safety
+    ///
+    /// The buffers must remain valid for the lifetime of the display.
+    pub unsafe fn from_static_buffers(
+        driver: D,
+        buf1: &'static mut [D::Pixel],
+        buf2: Option<&'static mut [D::Pixel]>,
+        render_mode: RenderMode,
+    ) -> Option<Self> {
+        let buf2_ptr = buf2
+            .map(|b| b.as_mut_ptr() as *mut u8)
+            .unwrap_or(core::ptr::null_mut());
+        let buf_size = core::mem::size_of_val(buf1);
+        Self::init(
+            driver,
+            buf1.as_mut_ptr() as *mut u8,
+            buf2_ptr,
+            buf_size,
+            render_mode,
+        )
+    }
+
+    unsafe fn init(
+        driver: D,
+        buf1: *mut u8,
+        buf2: *mut u8,
+        buf_size: usize,
+        render_mode: RenderMode,
+    ) -> Option<Self> {
+        let (width, height) = driver.size();
+        let display = Display::new(width, height)?;
+
+        // Box the driver so it has a stable address
+        let state = Box::new(TypedState {
+            driver,
+            render_mode,
+            scratch: Vec::new(),
+        });
+        let state_ptr = &*state as *const TypedState<D> as *mut core::ffi::c_void;
+        neo_lvgl_sys::lv_display_set_user_data(display.raw(), state_ptr);
+
+        // The color format must be set before the buffers so LVGL validates
+        // their size against the right stride
+        display.set_color_format(<D::Pixel as Pixel>::FORMAT);
+        neo_lvgl_sys::lv_display_set_buffers(
+            display.raw(),
+            buf1 as *mut _,
+            buf2 as *mut _,
+            buf_size as u32,
+            render_mode.to_raw(),
+        );
+        neo_lvgl_sys::lv_display_set_flush_cb(display.raw(), Some(Self::flush_trampoline));
+
+        Some(Self {
+            display,
+            state,
+            _buf1: None,
+            _buf2: None,
+        })
+    }
+
+    /// Get a reference to the underlying display.
+    pub fn display(&self) -> &Display {
+        &self.display
+    }
+
+    /// Get a reference to the driver.
+    pub fn driver(&self) -> &D {
+        &self.state.driver
+    }
+
+    /// Get a mutable reference to the driver.
+    pub fn driver_mut(&mut self) -> &mut D {
+        &mut self.state.driver
+    }
+
+    /// Set this display as the default.
+    pub fn set_default(&self) {
+        self.display.set_default();
+    }
+
+    /// Get the currently active screen for this display.
+    pub fn active_screen(&self) -> crate::widgets::Screen<'_> {
+        self.display.active_screen()
+    }
 
-        let pixels = core::slice::from_raw_parts(px_map, buf_size);
+    /// Get display width.
+    pub fn width(&self) -> i32 {
+        self.display.width()
+    }
 
-        // Call the Rust driver
-        driver.flush(&rust_area, pixels);
+    /// Get display height.
+    pub fn height(&self) -> i32 {
+        self.display.height()
+    }
 
-        // Signal flush complete
-        neo_lvgl_sys::lv_display_flush_ready(disp);
+    /// The C trampoline that calls our Rust driver
+    ///
+    /// Monomorphized per driver type, so the pixel size and stride are
+    /// computed in Rust and in Partial mode the only FFI call on this path is
+    /// the user_data lookup.
+    unsafe extern "C" fn flush_trampoline(
+        disp: *mut neo_lvgl_sys::lv_display_t,
+        area: *const neo_lvgl_sys::lv_area_t,
+        px_map: *mut u8,
+    ) {
+        let state_ptr = neo_lvgl_sys::lv_display_get_user_data(disp) as *mut TypedState<D>;
+        if state_ptr.is_null() {
+            return;
+        }
+
+        let TypedState {
+            driver,
+            render_mode,
+            scratch,
+        } = &mut *state_ptr;
+        let rust_area = Area::from_raw(&*area);
+        let bytes_per_pixel = <D::Pixel as Pixel>::BYTES_PER_PIXEL;
+        let line = (rust_area.width() as usize) * bytes_per_pixel;
+        let height = rust_area.height() as usize;
+
+        // LVGL pads every line to the draw buffer stride; drivers get the
+        // area's lines back to back
+        let start = if *render_mode == RenderMode::Partial {
+            // The strip holds just this area and is rendered over next, so
+            // the padding can be squeezed out in place
+            let stride = align_up(line, STRIDE_ALIGN);
+            if stride != line {
+                gather_lines(px_map, stride, line, height, px_map);
+            }
+            px_map as *const D::Pixel
+        } else {
+            // The buffer is the whole screen and has to stay intact
+            let width = neo_lvgl_sys::lv_display_get_horizontal_resolution(disp) as usize;
+            let stride = align_up(width * bytes_per_pixel, STRIDE_ALIGN);
+            let first = px_map
+                .add((rust_area.y1 as usize) * stride + (rust_area.x1 as usize) * bytes_per_pixel);
+            if height == 1 || line == stride {
+                first as *const D::Pixel
+            } else {
+                let count = rust_area.pixel_count();
+                scratch.clear();
+                scratch.reserve(count);
+                let spare = scratch.spare_capacity_mut();
+                gather_lines(first, stride, line, height, spare.as_mut_ptr() as *mut u8);
+                // SAFETY: all `count` pixels were just written, and any bytes
+                // are a valid `Pixel`
+                scratch.set_len(count);
+                scratch.as_ptr()
+            }
+        };
+
+        let pixels = core::slice::from_raw_parts(start, rust_area.pixel_count());
+        let token = FlushToken {
+            disp: NonNull::new_unchecked(disp),
+        };
+        driver.flush_async(&rust_area, pixels, token);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_area_batch_merges_by_cost() {
+        // Two 10x10 areas with a 10px gap: the bounding box (30x10) costs 300px
+        // against 200px + one transaction
+        let a = Area::new(0, 0, 9, 9);
+        let b = Area::new(20, 0, 29, 9);
+
+        let mut batch = AreaBatch::new(FlushCostModel::new(50));
+        batch.add(a);
+        batch.add(b);
+        assert_eq!(batch.len(), 2);
+
+        let mut batch = AreaBatch::new(FlushCostModel::new(100));
+        batch.add(a);
+        let merged = batch.add(b);
+        assert_eq!(batch.len(), 1);
+        assert_eq!((merged.x1, merged.x2), (0, 29));
+    }
+
+    #[test]
+    fn test_frame_buffer_packs_areas() {
+        // 4x3 frame, one byte per pixel, lines padded to 8 bytes
+        let pixels: [u8; 24] = core::array::from_fn(|i| i as u8);
+        let mut scratch = [0u8; 12];
+        let mut frame = FrameBuffer {
+            pixels: &pixels,
+            stride: 8,
+            bytes_per_pixel: 1,
+            scratch: &mut scratch,
+        };
+        assert_eq!(frame.area_pixels(&Area::new(1, 1, 2, 2)), &[9, 10, 17, 18]);
+        assert_eq!(frame.area_pixels(&Area::new(0, 2, 3, 2)), &[16, 17, 18, 19]);
+    }
+
+    #[test]
+    fn test_buffer_layout_budget() {
+        // 480x320 RGB565, 100 kB split over two buffers
+        let layout = BufferLayout::plan(
+            480,
+            320,
+            ColorFormat::Rgb565,
+            RenderMode::Partial,
+            BufferSize::Budget(100 * 1024),
+            true,
+        )
+        .unwrap();
+        assert_eq!(layout.buffers, 2);
+        assert_eq!(layout.lines, 53);
+        assert_eq!(layout.buf_size, layout.stride * 53);
+
+        // Partial strips are not allowed in Direct mode
+        let direct = BufferLayout::plan(
+            480,
+            320,
+            ColorFormat::Rgb565,
+            RenderMode::Direct,
+            BufferSize::Lines(40),
+            false,
+        );
+        assert_eq!(direct, None);
     }
 }
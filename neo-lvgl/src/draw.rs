@@ -0,0 +1,343 @@
+//! Draw units
+//!
+//! LVGL renders through draw units: the software renderer plus any hardware
+//! units enabled at build time (`draw-pxp`, `draw-vglite`, `draw-dma2d`).
+//! This module lets an application register its own blitter as an extra
+//! draw unit.
+//!
+//! Every draw task is offered to each unit's [`DrawUnit::evaluate`], and the
+//! unit with the lowest score executes it. The software renderer scores
+//! [`SW_SCORE`], so returning a lower score takes the task over.
+//!
+//! # Example
+//!
+//! ```ignore
+//! use lvgl::draw::{self, DrawTarget, DrawTask, DrawTaskKind, DrawUnit};
+//!
+//! struct Blitter;
+//!
+//! impl DrawUnit for Blitter {
+//!     fn evaluate(&mut self, task: &DrawTask<'_>) -> Option<u8> {
+//!         match task.fill() {
+//!             Some(fill) if fill.radius == 0 => Some(50),
+//!             _ => None,
+//!         }
+//!     }
+//!
+//!     fn draw(&mut self, task: &DrawTask<'_>, target: &DrawTarget<'_>) {
+//!         // Program the blitter with target.data(), target.stride(), ...
+//!     }
+//! }
+//!
+//! lvgl::init();
+//! draw::register_unit(Blitter, c"blitter");
+//! ```
+
+use crate::color::{Color, Opacity};
+use crate::display::{Area, ColorFormat};
+use core::ffi::CStr;
+use core::marker::PhantomData;
+use core::ptr::NonNull;
+
+/// Score the software renderer gives tasks it can draw (lower wins)
+pub const SW_SCORE: u8 = 100;
+
+/// Returned by `dispatch_cb` when a unit has nothing to do
+const DRAW_UNIT_IDLE: i32 = -1;
+
+/// Kind of a draw task
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum DrawTaskKind {
+    Fill,
+    Border,
+    BoxShadow,
+    Label,
+    Image,
+    Layer,
+    Line,
+    Arc,
+    Triangle,
+    /// Any other task type, by raw value
+    Other(u32),
+}
+
+impl DrawTaskKind {
+    fn from_raw(raw: neo_lvgl_sys::lv_draw_task_type_t) -> Self {
+        match raw {
+            neo_lvgl_sys::lv_draw_task_type_t_LV_DRAW_TASK_TYPE_FILL => DrawTaskKind::Fill,
+            neo_lvgl_sys::lv_draw_task_type_t_LV_DRAW_TASK_TYPE_BORDER => DrawTaskKind::Border,
+            neo_lvgl_sys::lv_draw_task_type_t_LV_DRAW_TASK_TYPE_BOX_SHADOW => {
+                DrawTaskKind::BoxShadow
+            }
+            neo_lvgl_sys::lv_draw_task_type_t_LV_DRAW_TASK_TYPE_LABEL => DrawTaskKind::Label,
+            neo_lvgl_sys::lv_draw_task_type_t_LV_DRAW_TASK_TYPE_IMAGE => DrawTaskKind::Image,
+            neo_lvgl_sys::lv_draw_task_type_t_LV_DRAW_TASK_TYPE_LAYER => DrawTaskKind::Layer,
+            neo_lvgl_sys::lv_draw_task_type_t_LV_DRAW_TASK_TYPE_LINE => DrawTaskKind::Line,
+            neo_lvgl_sys::lv_draw_task_type_t_LV_DRAW_TASK_TYPE_ARC => DrawTaskKind::Arc,
+            neo_lvgl_sys::lv_draw_task_type_t_LV_DRAW_TASK_TYPE_TRIANGLE => DrawTaskKind::Triangle,
+            other => DrawTaskKind::Other(other as u32),
+        }
+    }
+}
+
+/// Parameters of a solid or gradient fill task
+#[derive(Clone, Copy)]
+pub struct Fill {
+    /// Fill color (the first gradient stop for gradient fills)
+    pub color: Color,
+    /// Fill opacity
+    pub opa: Opacity,
+    /// Corner radius, 0 for plain rectangles
+    pub radius: i32,
+    /// Whether a gradient is set
+    pub gradient: bool,
+}
+
+/// A draw task offered to or executed by a draw unit
+pub struct DrawTask<'a> {
+    raw: NonNull<neo_lvgl_sys::lv_draw_task_t>,
+    _marker: PhantomData<&'a mut neo_lvgl_sys::lv_draw_task_t>,
+}
+
+impl<'a> DrawTask<'a> {
+    /// Create from raw pointer
+    ///
+    /// # Safety
+    ///
+    /// The pointer must be a valid draw task for `'a`.
+    pub unsafe fn from_raw(raw: *mut neo_lvgl_sys::lv_draw_task_t) -> Option<Self> {
+        NonNull::new(raw).map(|raw| Self {
+            raw,
+            _marker: PhantomData,
+        })
+    }
+
+    /// Kind of the task
+    pub fn kind(&self) -> DrawTaskKind {
+        DrawTaskKind::from_raw(unsafe { (*self.raw.as_ptr()).type_ })
+    }
+
+    /// Area covered by the task, in screen coordinates
+    pub fn area(&self) -> Area {
+        Area::from_raw(unsafe { &(*self.raw.as_ptr()).area })
+    }
+
+    /// Area the task may draw into, in screen coordinates
+    pub fn clip_area(&self) -> Area {
+        Area::from_raw(unsafe { &(*self.raw.as_ptr()).clip_area })
+    }
+
+    /// Fill parameters if this is a fill task
+    pub fn fill(&self) -> Option<Fill> {
+        if self.kind() != DrawTaskKind::Fill {
+            return None;
+        }
+        unsafe {
+            let dsc = (*self.raw.as_ptr()).draw_dsc as *const neo_lvgl_sys::lv_draw_fill_dsc_t;
+            let dsc = dsc.as_ref()?;
+            Some(Fill {
+                color: Color::from_raw(dsc.color),
+                opa: Opacity::new(dsc.opa),
+                radius: dsc.radius,
+                gradient: dsc.grad.dir != neo_lvgl_sys::lv_grad_dir_t_LV_GRAD_DIR_NONE as _,
+            })
+        }
+    }
+
+    /// Get the raw task pointer (e.g. to read other descriptor types)
+    pub fn raw(&self) -> *mut neo_lvgl_sys::lv_draw_task_t {
+        self.raw.as_ptr()
+    }
+}
+
+/// The layer buffer a draw unit renders into
+pub struct DrawTarget<'a> {
+    layer: NonNull<neo_lvgl_sys::lv_layer_t>,
+    _marker: PhantomData<&'a mut neo_lvgl_sys::lv_layer_t>,
+}
+
+impl<'a> DrawTarget<'a> {
+    /// Start of the layer's pixel data
+    pub fn data(&self) -> *mut u8 {
+        unsafe {
+            let buf = (*self.layer.as_ptr()).draw_buf;
+            if buf.is_null() {
+                core::ptr::null_mut()
+            } else {
+                (*buf).data
+            }
+        }
+    }
+
+    /// Bytes per line of the layer buffer
+    pub fn stride(&self) -> u32 {
+        unsafe {
+            let buf = (*self.layer.as_ptr()).draw_buf;
+            if buf.is_null() {
+                0
+            } else {
+                (*buf).header.stride() as u32
+            }
+        }
+    }
+
+    /// Color format of the layer buffer
+    pub fn color_format(&self) -> ColorFormat {
+        ColorFormat::from_raw(unsafe { (*self.layer.as_ptr()).color_format })
+    }
+
+    /// Screen area the buffer's first pixel and extent correspond to
+    ///
+    /// Task areas are in screen coordinates; subtract `buf_area().x1`/`y1`
+    /// to get buffer coordinates.
+    pub fn buf_area(&self) -> Area {
+        Area::from_raw(unsafe { &(*self.layer.as_ptr()).buf_area })
+    }
+
+    /// Get the raw layer pointer
+    pub fn raw(&self) -> *mut neo_lvgl_sys::lv_layer_t {
+        self.layer.as_ptr()
+    }
+}
+
+/// A custom draw unit
+///
+/// Both methods run on LVGL's render path (the render thread when an OS
+/// backend is enabled). `draw` is synchronous: the task counts as finished
+/// when it returns, so a DMA blitter should wait for its transfer there.
+pub trait DrawUnit: 'static {
+    /// Score a task; lower is better, [`SW_SCORE`] is the software renderer.
+    ///
+    /// Return `None` for tasks this unit cannot draw.
+    fn evaluate(&mut self, task: &DrawTask<'_>) -> Option<u8>;
+
+    /// Draw a task previously claimed in `evaluate`
+    fn draw(&mut self, task: &DrawTask<'_>, target: &DrawTarget<'_>);
+}
+
+/// LVGL allocates draw units itself; the Rust unit lives right after the
+/// LVGL header so no extra allocation is needed.
+#[repr(C)]
+struct UnitSlot<U> {
+    base: neo_lvgl_sys::lv_draw_unit_t,
+    unit: U,
+}
+
+/// Index of a registered draw unit
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub struct DrawUnitId(pub i32);
+
+/// Register a custom draw unit.
+///
+/// The unit lives until `lv_deinit()`, which drops it.
+///
+/// # Arguments
+///
+/// * `unit` - The draw unit implementation
+/// * `name` - Name of the unit (shown in LVGL debug output)
+///
+/// Returns `None` if LVGL could not allocate the unit.
+pub fn register_unit<U: DrawUnit>(unit: U, name: &'static CStr) -> Option<DrawUnitId> {
+    // lv_malloc only guarantees pointer alignment
+    assert!(core::mem::align_of::<UnitSlot<U>>() <= core::mem::align_of::<usize>());
+
+    unsafe {
+        // Allocates zeroed memory and links it into LVGL's unit list
+        let slot = neo_lvgl_sys::lv_draw_create_unit(core::mem::size_of::<UnitSlot<U>>())
+            as *mut UnitSlot<U>;
+        if slot.is_null() {
+            return None;
+        }
+
+        core::ptr::addr_of_mut!((*slot).unit).write(unit);
+        let base = &mut (*slot).base;
+        base.name = name.as_ptr();
+        base.evaluate_cb = Some(evaluate_trampoline::<U>);
+        base.dispatch_cb = Some(dispatch_trampoline::<U>);
+        base.delete_cb = Some(delete_trampoline::<U>);
+
+        Some(DrawUnitId(base.idx))
+    }
+}
+
+unsafe extern "C" fn evaluate_trampoline<U: DrawUnit>(
+    draw_unit: *mut neo_lvgl_sys::lv_draw_unit_t,
+    task: *mut neo_lvgl_sys::lv_draw_task_t,
+) -> i32 {
+    let slot = draw_unit as *mut UnitSlot<U>;
+    let Some(wrapped) = DrawTask::from_raw(task) else {
+        return 0;
+    };
+
+    if let Some(score) = (*slot).unit.evaluate(&wrapped) {
+        if (score as u32) < (*task).preference_score as u32 {
+            (*task).preference_score = score as _;
+            (*task).preferred_draw_unit_id = (*slot).base.idx as _;
+        }
+    }
+    0
+}
+
+unsafe extern "C" fn dispatch_trampoline<U: DrawUnit>(
+    draw_unit: *mut neo_lvgl_sys::lv_draw_unit_t,
+    layer: *mut neo_lvgl_sys::lv_layer_t,
+) -> i32 {
+    let slot = draw_unit as *mut UnitSlot<U>;
+
+    let task = neo_lvgl_sys::lv_draw_get_next_available_task(
+        layer,
+        core::ptr::null_mut(),
+        (*slot).base.idx as _,
+    );
+    if task.is_null() {
+        return DRAW_UNIT_IDLE;
+    }
+
+    // Make sure the layer has a buffer before drawing into it
+    if neo_lvgl_sys::lv_draw_layer_alloc_buf(layer).is_null() {
+        return DRAW_UNIT_IDLE;
+    }
+
+    core::ptr::write_volatile(
+        core::ptr::addr_of_mut!((*task).state),
+        neo_lvgl_sys::lv_draw_task_state_t_LV_DRAW_TASK_STATE_IN_PROGRESS as _,
+    );
+    (*slot).base.target_layer = layer;
+    (*slot).base.clip_area = &(*task).clip_area;
+
+    let wrapped = DrawTask {
+        raw: NonNull::new_unchecked(task),
+        _marker: PhantomData,
+    };
+    let target = DrawTarget {
+        layer: NonNull::new_unchecked(layer),
+        _marker: PhantomData,
+    };
+    (*slot).unit.draw(&wrapped, &target);
+
+    core::ptr::write_volatile(
+        core::ptr::addr_of_mut!((*task).state),
+        neo_lvgl_sys::lv_draw_task_state_t_LV_DRAW_TASK_STATE_READY as _,
+    );
+    neo_lvgl_sys::lv_draw_dispatch_request();
+    1
+}
+
+unsafe extern "C" fn delete_trampoline<U: DrawUnit>(
+    draw_unit: *mut neo_lvgl_sys::lv_draw_unit_t,
+) -> i32 {
+    // LVGL frees the slot itself after this returns
+    let slot = draw_unit as *mut UnitSlot<U>;
+    core::ptr::drop_in_place(core::ptr::addr_of_mut!((*slot).unit));
+    0
+}
+
+/// Signal DMA2D transfer completion from the DMA2D interrupt handler
+///
+/// Only needed with the `draw-dma2d-irq` feature.
+#[cfg(feature = "draw-dma2d-irq")]
+pub fn dma2d_transfer_complete_isr() {
+    unsafe {
+        neo_lvgl_sys::lv_draw_dma2d_transfer_complete_interrupt_handler();
+    }
+}
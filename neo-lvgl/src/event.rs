@@ -5,7 +5,7 @@
 //! - `EventCode` - Type-safe event codes
 //! - `Event` - Wrapper for accessing event data
 //! - Static function callbacks (always available)
-//! - Closure callbacks (requires `alloc` feature)
+//! - Closure callbacks (requires `alloc` feature), freed with their object
 
 use core::ffi::c_void;
 
@@ -50,6 +50,12 @@ pub enum EventCode {
     ChildDeleted = neo_lvgl_sys::lv_event_code_t_LV_EVENT_CHILD_DELETED,
     /// Child changed
     ChildChanged = neo_lvgl_sys::lv_event_code_t_LV_EVENT_CHILD_CHANGED,
+    /// Scrolling started
+    ScrollBegin = neo_lvgl_sys::lv_event_code_t_LV_EVENT_SCROLL_BEGIN,
+    /// Scrolling ended
+    ScrollEnd = neo_lvgl_sys::lv_event_code_t_LV_EVENT_SCROLL_END,
+    /// Scroll position changed
+    Scroll = neo_lvgl_sys::lv_event_code_t_LV_EVENT_SCROLL,
     /// Screen load started
     ScreenLoadStart = neo_lvgl_sys::lv_event_code_t_LV_EVENT_SCREEN_LOAD_START,
     /// Screen loaded
@@ -87,6 +93,9 @@ impl EventCode {
             neo_lvgl_sys::lv_event_code_t_LV_EVENT_CHILD_CREATED => Some(Self::ChildCreated),
             neo_lvgl_sys::lv_event_code_t_LV_EVENT_CHILD_DELETED => Some(Self::ChildDeleted),
             neo_lvgl_sys::lv_event_code_t_LV_EVENT_CHILD_CHANGED => Some(Self::ChildChanged),
+            neo_lvgl_sys::lv_event_code_t_LV_EVENT_SCROLL_BEGIN => Some(Self::ScrollBegin),
+            neo_lvgl_sys::lv_event_code_t_LV_EVENT_SCROLL_END => Some(Self::ScrollEnd),
+            neo_lvgl_sys::lv_event_code_t_LV_EVENT_SCROLL => Some(Self::Scroll),
             neo_lvgl_sys::lv_event_code_t_LV_EVENT_SCREEN_LOAD_START => Some(Self::ScreenLoadStart),
             neo_lvgl_sys::lv_event_code_t_LV_EVENT_SCREEN_LOADED => Some(Self::ScreenLoaded),
             neo_lvgl_sys::lv_event_code_t_LV_EVENT_SCREEN_UNLOAD_START => Some(Self::ScreenUnloadStart),
@@ -164,6 +173,44 @@ impl Event {
         self.raw
     }
 
+    /// Get the index of the direct child of the current target the event
+    /// originated from.
+    ///
+    /// Walks up from the target, so events from a row's nested label
+    /// resolve to the row.
+    pub fn delegate_index(&self) -> Option<usize> {
+        let current = self.current_target_raw();
+        let mut obj = self.target_raw();
+        unsafe {
+            while !obj.is_null() && obj != current {
+                let parent = neo_lvgl_sys::lv_obj_get_parent(obj);
+                if parent == current {
+                    return Some(neo_lvgl_sys::lv_obj_get_index(obj) as usize);
+                }
+                obj = parent;
+            }
+        }
+        None
+    }
+
+    /// Get the key of the delegated child the event originated from.
+    ///
+    /// The key is the one set with [`EventHandler::set_delegate_key`], read
+    /// from the current target's key table by [child
+    /// index](Self::delegate_index). If no child of the current target was
+    /// given a key, the child index itself is the key.
+    pub fn delegate_key(&self) -> Option<usize> {
+        let index = self.delegate_index()?;
+        #[cfg(feature = "alloc")]
+        unsafe {
+            if let Some(keys) = delegate_keys::find(self.current_target_raw()) {
+                let key = (*keys).get(index).copied();
+                return key.filter(|&key| key != delegate_keys::NONE);
+            }
+        }
+        Some(index)
+    }
+
     /// Stop event propagation
     pub fn stop_bubbling(&self) {
         unsafe {
@@ -182,6 +229,61 @@ impl Event {
 /// Static event callback type
 pub type EventCb = unsafe extern "C" fn(*mut neo_lvgl_sys::lv_event_t);
 
+/// Delegate keys of a parent's children (requires alloc feature)
+///
+/// A parent has at most one key table, indexed by child index and freed
+/// with the parent.
+#[cfg(feature = "alloc")]
+pub(crate) mod delegate_keys {
+    use super::*;
+    use alloc::vec::Vec;
+
+    /// Table entry of a child without a key
+    pub(crate) const NONE: usize = usize::MAX;
+
+    /// Frees the key table in the user data on `LV_EVENT_DELETE`
+    unsafe extern "C" fn free_keys(e: *mut neo_lvgl_sys::lv_event_t) {
+        if neo_lvgl_sys::lv_event_get_target(e) == neo_lvgl_sys::lv_event_get_current_target(e) {
+            let keys = neo_lvgl_sys::lv_event_get_user_data(e) as *mut Vec<usize>;
+            drop(Box::from_raw(keys));
+        }
+    }
+
+    /// Find the key table of `parent`
+    ///
+    /// Scans the parent's own event descriptors, not its children.
+    pub(crate) unsafe fn find(parent: *mut neo_lvgl_sys::lv_obj_t) -> Option<*mut Vec<usize>> {
+        let free = free_keys as EventCb as usize;
+        (0..neo_lvgl_sys::lv_obj_get_event_count(parent))
+            .map(|i| neo_lvgl_sys::lv_obj_get_event_dsc(parent, i))
+            .find(|&dsc| {
+                neo_lvgl_sys::lv_event_dsc_get_cb(dsc).map_or(false, |cb| cb as usize == free)
+            })
+            .map(|dsc| neo_lvgl_sys::lv_event_dsc_get_user_data(dsc) as *mut Vec<usize>)
+    }
+
+    /// Set the key of the child at `index` of `parent`
+    pub(crate) unsafe fn set(parent: *mut neo_lvgl_sys::lv_obj_t, index: usize, key: usize) {
+        let keys = match find(parent) {
+            Some(keys) => &mut *keys,
+            None => {
+                let keys = Box::into_raw(Box::new(Vec::new()));
+                neo_lvgl_sys::lv_obj_add_event_cb(
+                    parent,
+                    Some(free_keys),
+                    neo_lvgl_sys::lv_event_code_t_LV_EVENT_DELETE,
+                    keys as *mut c_void,
+                );
+                &mut *keys
+            }
+        };
+        if keys.len() <= index {
+            keys.resize(index + 1, NONE);
+        }
+        keys[index] = key;
+    }
+}
+
 /// Trait for adding event handlers to widgets
 pub trait EventHandler {
     /// Get the raw object pointer
@@ -228,34 +330,182 @@ pub trait EventHandler {
     fn on_all_events(&self, cb: EventCb) {
         self.on_event(EventCode::All, cb);
     }
+
+    /// Make this object report its events to a delegating parent as `key`.
+    ///
+    /// Stores the key in the parent's key table at this object's index, so
+    /// the object needs no event descriptor and its LVGL user data stays
+    /// free for the application, and sets `LV_OBJ_FLAG_EVENT_BUBBLE`. The
+    /// parent's handler reads it back with [`Event::delegate_key`]; keys
+    /// usually index a side table of row data. Keys belong to child
+    /// positions: set them again after moving or deleting children.
+    #[cfg(feature = "alloc")]
+    fn set_delegate_key(&self, key: usize) {
+        unsafe {
+            let obj = self.obj_raw();
+            let parent = neo_lvgl_sys::lv_obj_get_parent(obj);
+            if !parent.is_null() {
+                let index = neo_lvgl_sys::lv_obj_get_index(obj) as usize;
+                delegate_keys::set(parent, index, key);
+                neo_lvgl_sys::lv_obj_add_flag(
+                    obj,
+                    neo_lvgl_sys::lv_obj_flag_t_LV_OBJ_FLAG_EVENT_BUBBLE,
+                );
+            }
+        }
+    }
+
+    /// Let every current child report its events to this object, keyed by
+    /// child index.
+    ///
+    /// Sets `LV_OBJ_FLAG_EVENT_BUBBLE` on the children; see
+    /// [`Event::delegate_key`].
+    fn delegate_children(&self) {
+        unsafe {
+            let obj = self.obj_raw();
+            for i in 0..neo_lvgl_sys::lv_obj_get_child_count(obj) {
+                let child = neo_lvgl_sys::lv_obj_get_child(obj, i as i32);
+                neo_lvgl_sys::lv_obj_add_flag(
+                    child,
+                    neo_lvgl_sys::lv_obj_flag_t_LV_OBJ_FLAG_EVENT_BUBBLE,
+                );
+            }
+        }
+    }
 }
 
 // Closure support (requires alloc feature)
 #[cfg(feature = "alloc")]
 mod closure_support {
     use super::*;
+    use crate::widgets::Obj;
+    use core::ptr;
+
+    /// Header of a stored closure, linking all closures of one object
+    #[repr(C)]
+    struct Node {
+        next: *mut Node,
+        drop: unsafe fn(*mut Node),
+    }
+
+    /// A closure and its header in a single allocation
+    #[repr(C)]
+    struct Closure<F> {
+        node: Node,
+        handler: F,
+    }
 
-    /// Trampoline function for closure callbacks
-    unsafe extern "C" fn closure_trampoline(e: *mut neo_lvgl_sys::lv_event_t) {
+    unsafe fn drop_closure<F>(node: *mut Node) {
+        drop(Box::from_raw(node as *mut Closure<F>));
+    }
+
+    /// Calls a `Fn` closure stored in the event's user data
+    unsafe extern "C" fn closure_trampoline<F: Fn(&Event)>(e: *mut neo_lvgl_sys::lv_event_t) {
+        #[cfg(feature = "profiling")]
+        let _span = crate::profiling::Span::enter(crate::profiling::Site::Event);
         let user_data = neo_lvgl_sys::lv_event_get_user_data(e);
         if !user_data.is_null() {
-            let closure = &mut *(user_data as *mut Box<dyn Fn(&Event)>);
+            let closure = &*(user_data as *const Closure<F>);
             let event = Event::from_raw(e);
-            closure(&event);
+            (closure.handler)(&event);
         }
     }
 
-    /// Trampoline for FnMut closures
-    unsafe extern "C" fn closure_trampoline_mut(e: *mut neo_lvgl_sys::lv_event_t) {
+    /// Calls a `FnMut` closure stored in the event's user data
+    unsafe extern "C" fn closure_trampoline_mut<F: FnMut(&Event)>(
+        e: *mut neo_lvgl_sys::lv_event_t,
+    ) {
+        #[cfg(feature = "profiling")]
+        let _span = crate::profiling::Span::enter(crate::profiling::Site::Event);
         let user_data = neo_lvgl_sys::lv_event_get_user_data(e);
         if !user_data.is_null() {
-            let closure = &mut *(user_data as *mut Box<dyn FnMut(&Event)>);
+            let closure = &mut *(user_data as *mut Closure<F>);
             let event = Event::from_raw(e);
-            closure(&event);
+            (closure.handler)(&event);
+        }
+    }
+
+    /// Frees every closure of an object on `LV_EVENT_DELETE`
+    ///
+    /// The user data is the object's first closure; later ones are linked
+    /// behind it.
+    unsafe extern "C" fn cleanup_trampoline(e: *mut neo_lvgl_sys::lv_event_t) {
+        if neo_lvgl_sys::lv_event_get_target(e) != neo_lvgl_sys::lv_event_get_current_target(e) {
+            return;
         }
+        let mut node = neo_lvgl_sys::lv_event_get_user_data(e) as *mut Node;
+        while !node.is_null() {
+            let next = (*node).next;
+            ((*node).drop)(node);
+            node = next;
+        }
+    }
+
+    /// Find the object's cleanup handler
+    unsafe fn find_cleanup(
+        obj: *mut neo_lvgl_sys::lv_obj_t,
+    ) -> Option<*mut neo_lvgl_sys::lv_event_dsc_t> {
+        let cleanup = cleanup_trampoline as EventCb as usize;
+        (0..neo_lvgl_sys::lv_obj_get_event_count(obj))
+            .rev()
+            .map(|i| neo_lvgl_sys::lv_obj_get_event_dsc(obj, i))
+            .find(|&dsc| {
+                neo_lvgl_sys::lv_event_dsc_get_cb(dsc).map_or(false, |cb| cb as usize == cleanup)
+            })
+    }
+
+    /// Store `handler` in one allocation and register `cb` for it.
+    ///
+    /// The closure is linked into the object's cleanup list, so it is freed
+    /// together with the object.
+    unsafe fn add_closure<F>(
+        obj: *mut neo_lvgl_sys::lv_obj_t,
+        event: EventCode,
+        cb: EventCb,
+        handler: F,
+    ) {
+        let closure = Box::into_raw(Box::new(Closure {
+            node: Node {
+                next: ptr::null_mut(),
+                drop: drop_closure::<F>,
+            },
+            handler,
+        }));
+        let node = closure as *mut Node;
+        neo_lvgl_sys::lv_obj_add_event_cb(obj, Some(cb), event.to_raw(), closure as *mut c_void);
+
+        match find_cleanup(obj) {
+            Some(dsc) => {
+                // Link behind the head so the cleanup's user data stays valid
+                let head = neo_lvgl_sys::lv_event_dsc_get_user_data(dsc) as *mut Node;
+                (*node).next = (*head).next;
+                (*head).next = node;
+
+                // Delete handlers must run before their closures are freed,
+                // so keep the cleanup handler last
+                if matches!(event, EventCode::Delete | EventCode::All) {
+                    neo_lvgl_sys::lv_obj_remove_event_dsc(obj, dsc);
+                    add_cleanup(obj, head);
+                }
+            }
+            None => add_cleanup(obj, node),
+        }
+    }
+
+    unsafe fn add_cleanup(obj: *mut neo_lvgl_sys::lv_obj_t, head: *mut Node) {
+        neo_lvgl_sys::lv_obj_add_event_cb(
+            obj,
+            Some(cleanup_trampoline),
+            neo_lvgl_sys::lv_event_code_t_LV_EVENT_DELETE,
+            head as *mut c_void,
+        );
     }
 
     /// Extension trait for closure-based event handlers
+    ///
+    /// Each closure is stored in a single allocation and freed when LVGL
+    /// deletes the object. A closure must not delete its own object
+    /// synchronously; use `lv_obj_delete_async` instead.
     pub trait ClosureEventHandler: EventHandler {
         /// Add a click handler using a closure.
         ///
@@ -315,22 +565,13 @@ mod closure_support {
 
         /// Add an event handler using a closure.
         ///
-        /// This allocates the closure on the heap.
+        /// The closure is stored inline in one heap allocation, which is
+        /// freed when the object is deleted.
         fn on_event_closure<F>(&self, event: EventCode, handler: F)
         where
             F: Fn(&Event) + 'static,
         {
-            let boxed: Box<Box<dyn Fn(&Event)>> = Box::new(Box::new(handler));
-            let raw = Box::into_raw(boxed);
-
-            unsafe {
-                neo_lvgl_sys::lv_obj_add_event_cb(
-                    self.obj_raw(),
-                    Some(closure_trampoline),
-                    event.to_raw(),
-                    raw as *mut c_void,
-                );
-            }
+            unsafe { add_closure(self.obj_raw(), event, closure_trampoline::<F>, handler) }
         }
 
         /// Add an event handler using a mutable closure.
@@ -338,17 +579,62 @@ mod closure_support {
         where
             F: FnMut(&Event) + 'static,
         {
-            let boxed: Box<Box<dyn FnMut(&Event)>> = Box::new(Box::new(handler));
-            let raw = Box::into_raw(boxed);
+            unsafe { add_closure(self.obj_raw(), event, closure_trampoline_mut::<F>, handler) }
+        }
 
-            unsafe {
-                neo_lvgl_sys::lv_obj_add_event_cb(
-                    self.obj_raw(),
-                    Some(closure_trampoline_mut),
-                    event.to_raw(),
-                    raw as *mut c_void,
-                );
-            }
+        /// Handle `event` for all children with one handler on this object.
+        ///
+        /// The handler receives the object the event originated from. Events
+        /// of this object itself are ignored. Children must have
+        /// [`Flag::EVENT_BUBBLE`](crate::widgets::Flag::EVENT_BUBBLE) set so
+        /// their events reach the parent (see
+        /// [`delegate_children`](EventHandler::delegate_children)).
+        ///
+        /// # Example
+        ///
+        /// ```ignore
+        /// list.on_delegated(EventCode::Clicked, |_event, row| {
+        ///     row.add_state(State::CHECKED);
+        /// });
+        /// ```
+        fn on_delegated<F>(&self, event: EventCode, handler: F)
+        where
+            F: Fn(&Event, Obj<'_>) + 'static,
+        {
+            self.on_event_closure(event, move |e| {
+                let target = e.target_raw();
+                if target != e.current_target_raw() {
+                    if let Some(child) = unsafe { Obj::from_raw(target) } {
+                        handler(e, child);
+                    }
+                }
+            });
+        }
+
+        /// Handle `event` for keyed children with one handler on this object.
+        ///
+        /// The handler gets the key of the child the event came from (see
+        /// [`EventHandler::set_delegate_key`]). Events from children without a
+        /// key and from this object itself are ignored.
+        ///
+        /// # Example
+        ///
+        /// ```ignore
+        /// for (i, item) in items.iter().enumerate() {
+        ///     let row = list.add_button(&item.name).unwrap();
+        ///     row.set_delegate_key(i);
+        /// }
+        /// list.on_child_key(EventCode::Clicked, move |_event, i| open(&items[i]));
+        /// ```
+        fn on_child_key<F>(&self, event: EventCode, handler: F)
+        where
+            F: Fn(&Event, usize) + 'static,
+        {
+            self.on_event_closure(event, move |e| {
+                if let Some(key) = e.delegate_key() {
+                    handler(e, key);
+                }
+            });
         }
     }
 
@@ -4,11 +4,13 @@
 //!
 //! - `Font` - Reference to a built-in font
 //! - `TtfFont` - Runtime-loaded TTF/OTF font (requires `ttf` feature)
+//! - `GlyphAtlas` - Pre-rasterized glyphs shared by several fonts (requires
+//!   `alloc` feature)
 //!
 //! # Built-in Fonts
 //!
-//! LVGL includes Montserrat fonts at various sizes. The availability depends
-//! on your `lv_conf.h` configuration.
+//! LVGL includes Montserrat fonts at various sizes. Size 14 is always built;
+//! other sizes are enabled with `font-montserrat-*` features.
 //!
 //! ```ignore
 //! use lvgl::font::Font;
@@ -25,9 +27,29 @@
 //! let font = TtfFont::from_file(c"/fonts/roboto.ttf", 24)?;
 //! style.set_text_font(font.as_font());
 //! ```
+//!
+//! # Glyph atlas (requires alloc feature)
+//!
+//! TinyTTF rasterizes glyphs on first use, which stalls the frame where a
+//! readout first shows a new digit. Rasterize the charsets up front instead:
+//!
+//! ```ignore
+//! use lvgl::font::{AtlasFormat, GlyphAtlas, TtfFont};
+//!
+//! let mut ttf = TtfFont::from_data(ROBOTO, 48)?;
+//! let mut atlas = GlyphAtlas::new(AtlasFormat::A4).with_budget(32 * 1024);
+//! let big = atlas.add(&ttf.as_font(), "0123456789.-°C%", None)?;
+//! ttf.set_size(16);
+//! let small = atlas.add(&ttf.as_font(), "0123456789.-°C%", Some(ttf.as_font()))?;
+//!
+//! value_label.set_style_text_font(&big);
+//! ```
 
+use core::cell::UnsafeCell;
 #[cfg(feature = "ttf")]
 use core::ffi::CStr;
+use core::mem::MaybeUninit;
+use core::sync::atomic::{AtomicBool, Ordering};
 
 /// Reference to an LVGL font
 ///
@@ -62,6 +84,49 @@ impl Font {
     pub fn default() -> Self {
         unsafe { Self::from_raw(neo_lvgl_sys::lv_font_get_default()) }
     }
+
+    /// Montserrat 14 (the default font, always available)
+    pub fn montserrat_14() -> Self {
+        unsafe { Self::from_raw(core::ptr::addr_of!(neo_lvgl_sys::lv_font_montserrat_14)) }
+    }
+}
+
+/// Accessors for the feature-gated Montserrat sizes
+macro_rules! montserrat_fonts {
+    ($($feature:literal => $name:ident, $sym:ident;)*) => {
+        impl Font {
+            $(
+                #[doc = concat!("Montserrat font (requires `", $feature, "` feature)")]
+                #[cfg(feature = $feature)]
+                pub fn $name() -> Self {
+                    unsafe { Self::from_raw(core::ptr::addr_of!(neo_lvgl_sys::$sym)) }
+                }
+            )*
+        }
+    };
+}
+
+montserrat_fonts! {
+    "font-montserrat-8" => montserrat_8, lv_font_montserrat_8;
+    "font-montserrat-10" => montserrat_10, lv_font_montserrat_10;
+    "font-montserrat-12" => montserrat_12, lv_font_montserrat_12;
+    "font-montserrat-16" => montserrat_16, lv_font_montserrat_16;
+    "font-montserrat-18" => montserrat_18, lv_font_montserrat_18;
+    "font-montserrat-20" => montserrat_20, lv_font_montserrat_20;
+    "font-montserrat-22" => montserrat_22, lv_font_montserrat_22;
+    "font-montserrat-24" => montserrat_24, lv_font_montserrat_24;
+    "font-montserrat-26" => montserrat_26, lv_font_montserrat_26;
+    "font-montserrat-28" => montserrat_28, lv_font_montserrat_28;
+    "font-montserrat-30" => montserrat_30, lv_font_montserrat_30;
+    "font-montserrat-32" => montserrat_32, lv_font_montserrat_32;
+    "font-montserrat-34" => montserrat_34, lv_font_montserrat_34;
+    "font-montserrat-36" => montserrat_36, lv_font_montserrat_36;
+    "font-montserrat-38" => montserrat_38, lv_font_montserrat_38;
+    "font-montserrat-40" => montserrat_40, lv_font_montserrat_40;
+    "font-montserrat-42" => montserrat_42, lv_font_montserrat_42;
+    "font-montserrat-44" => montserrat_44, lv_font_montserrat_44;
+    "font-montserrat-46" => montserrat_46, lv_font_montserrat_46;
+    "font-montserrat-48" => montserrat_48, lv_font_montserrat_48;
 }
 
 /// Error type for font operations
@@ -73,6 +138,8 @@ pub enum FontError {
     InvalidData,
     /// Feature not enabled in lv_conf.h
     NotSupported,
+    /// A glyph atlas budget would be exceeded
+    OutOfBudget,
 }
 
 /// TTF font loaded at runtime
@@ -158,3 +225,415 @@ impl Drop for TtfFont {
         }
     }
 }
+
+/// Pixel format of pre-rasterized glyph bitmaps
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum AtlasFormat {
+    /// 4 bits per pixel, half the memory of A8
+    A4,
+    /// 8 bits per pixel, exactly what the rasterizer produced
+    A8,
+}
+
+/// A pre-rasterized glyph; `offset` indexes the bitmap store
+///
+/// Rows are `box_w` pixels, packed two per byte (high nibble first) for
+/// [`AtlasFormat::A4`].
+#[derive(Clone, Copy, Debug)]
+pub struct StaticGlyph {
+    /// Unicode code point
+    pub letter: u32,
+    /// Advance width in pixels
+    pub adv_w: u16,
+    /// Bitmap width
+    pub box_w: u16,
+    /// Bitmap height
+    pub box_h: u16,
+    /// Bitmap x offset from the pen position
+    pub ofs_x: i16,
+    /// Bitmap bottom above the baseline
+    pub ofs_y: i16,
+    /// Start of the bitmap in the store
+    pub offset: u32,
+}
+
+/// Fill `dsc` from a letter-sorted glyph table
+unsafe fn lookup_glyph(
+    glyphs: &[StaticGlyph],
+    letter: u32,
+    dsc: *mut neo_lvgl_sys::lv_font_glyph_dsc_t,
+) -> bool {
+    let Ok(index) = glyphs.binary_search_by_key(&letter, |g| g.letter) else {
+        return false;
+    };
+    let glyph = &glyphs[index];
+    let dsc = &mut *dsc;
+    dsc.adv_w = glyph.adv_w;
+    dsc.box_w = glyph.box_w;
+    dsc.box_h = glyph.box_h;
+    dsc.ofs_x = glyph.ofs_x;
+    dsc.ofs_y = glyph.ofs_y;
+    dsc.format = neo_lvgl_sys::lv_font_glyph_format_t_LV_FONT_GLYPH_FORMAT_A8;
+    dsc.gid.index = index as u32;
+    true
+}
+
+/// Expand a stored glyph into LVGL's A8 glyph buffer; no rasterization
+unsafe fn expand_glyph(
+    format: AtlasFormat,
+    bitmaps: &[u8],
+    glyph: &StaticGlyph,
+    draw_buf: *mut neo_lvgl_sys::lv_draw_buf_t,
+) -> *const core::ffi::c_void {
+    if draw_buf.is_null() {
+        return core::ptr::null();
+    }
+    let (w, h) = (glyph.box_w as usize, glyph.box_h as usize);
+    let dst_stride = (*draw_buf).header.stride() as usize;
+    let data = (*draw_buf).data;
+    let base = glyph.offset as usize;
+    for y in 0..h {
+        let dst = core::slice::from_raw_parts_mut(data.add(y * dst_stride), w);
+        match format {
+            AtlasFormat::A8 => dst.copy_from_slice(&bitmaps[base + y * w..base + (y + 1) * w]),
+            AtlasFormat::A4 => {
+                let row = &bitmaps[base + y * w.div_ceil(2)..];
+                for (x, px) in dst.iter_mut().enumerate() {
+                    let nibble = if x % 2 == 0 {
+                        row[x / 2] >> 4
+                    } else {
+                        row[x / 2] & 0x0F
+                    };
+                    *px = nibble * 17;
+                }
+            }
+        }
+    }
+    draw_buf as *const core::ffi::c_void
+}
+
+/// A font compiled into flash by [`include_font!`](crate::include_font)
+///
+/// Glyphs are stored pre-rasterized, so drawing never decodes or
+/// rasterizes. Call [`font`](Self::font) to use it with widgets and styles.
+pub struct StaticFont {
+    font: UnsafeCell<MaybeUninit<neo_lvgl_sys::lv_font_t>>,
+    ready: AtomicBool,
+    line_height: i32,
+    base_line: i32,
+    format: AtlasFormat,
+    glyphs: &'static [StaticGlyph],
+    bitmaps: &'static [u8],
+}
+
+// SAFETY: the lv_font_t is written once, on first use from the LVGL thread
+unsafe impl Sync for StaticFont {}
+
+impl StaticFont {
+    /// Create a font from generated tables
+    ///
+    /// `glyphs` must be sorted by letter and their bitmaps must lie inside
+    /// `bitmaps`; [`include_font!`](crate::include_font) guarantees both.
+    #[doc(hidden)]
+    pub const unsafe fn new(
+        line_height: i32,
+        base_line: i32,
+        format: AtlasFormat,
+        glyphs: &'static [StaticGlyph],
+        bitmaps: &'static [u8],
+    ) -> Self {
+        Self {
+            font: UnsafeCell::new(MaybeUninit::uninit()),
+            ready: AtomicBool::new(false),
+            line_height,
+            base_line,
+            format,
+            glyphs,
+            bitmaps,
+        }
+    }
+
+    /// Get as a Font reference for use with widgets
+    pub fn font(&'static self) -> Font {
+        let raw = unsafe { (*self.font.get()).as_mut_ptr() };
+        if !self.ready.load(Ordering::Acquire) {
+            unsafe {
+                raw.write(core::mem::zeroed());
+                (*raw).get_glyph_dsc = Some(static_glyph_dsc);
+                (*raw).get_glyph_bitmap = Some(static_glyph_bitmap);
+                (*raw).line_height = self.line_height;
+                (*raw).base_line = self.base_line;
+                (*raw).dsc = self as *const Self as *const core::ffi::c_void;
+            }
+            self.ready.store(true, Ordering::Release);
+        }
+        unsafe { Font::from_raw(raw) }
+    }
+
+    /// Number of glyphs in the font
+    pub fn glyph_count(&self) -> usize {
+        self.glyphs.len()
+    }
+
+    /// Bitmap bytes in flash
+    pub fn bitmap_size(&self) -> usize {
+        self.bitmaps.len()
+    }
+}
+
+unsafe extern "C" fn static_glyph_dsc(
+    font: *const neo_lvgl_sys::lv_font_t,
+    dsc: *mut neo_lvgl_sys::lv_font_glyph_dsc_t,
+    letter: u32,
+    _letter_next: u32,
+) -> bool {
+    let this = &*((*font).dsc as *const StaticFont);
+    lookup_glyph(this.glyphs, letter, dsc)
+}
+
+unsafe extern "C" fn static_glyph_bitmap(
+    dsc: *mut neo_lvgl_sys::lv_font_glyph_dsc_t,
+    draw_buf: *mut neo_lvgl_sys::lv_draw_buf_t,
+) -> *const core::ffi::c_void {
+    let this = &*((*(*dsc).resolved_font).dsc as *const StaticFont);
+    let glyph = &this.glyphs[(*dsc).gid.index as usize];
+    expand_glyph(this.format, this.bitmaps, glyph, draw_buf)
+}
+
+#[cfg(feature = "alloc")]
+pub use atlas::{AtlasStats, GlyphAtlas};
+
+#[cfg(feature = "alloc")]
+mod atlas {
+    use super::{expand_glyph, lookup_glyph, AtlasFormat, Font, FontError, StaticGlyph};
+    use alloc::boxed::Box;
+    use alloc::vec::Vec;
+    use core::ffi::c_void;
+    use core::sync::atomic::{AtomicU32, Ordering};
+
+    /// Size and lookup counters of a [`GlyphAtlas`]
+    #[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+    pub struct AtlasStats {
+        /// Glyphs stored
+        pub glyphs: usize,
+        /// Bitmap bytes used
+        pub bytes: usize,
+        /// Glyph lookups served from the atlas
+        pub hits: u32,
+        /// Glyph lookups not in the atlas (sent to the fallback font)
+        pub misses: u32,
+    }
+
+    /// One font size; `font.dsc` points back at the face
+    struct Face {
+        font: neo_lvgl_sys::lv_font_t,
+        glyphs: Vec<StaticGlyph>,
+        shared: *const Shared,
+    }
+
+    struct Shared {
+        format: AtlasFormat,
+        bitmaps: Vec<u8>,
+        budget: usize,
+        hits: AtomicU32,
+        misses: AtomicU32,
+    }
+
+    /// Pre-rasterized glyphs for a fixed charset, shared across sizes
+    ///
+    /// Each [`add`](Self::add) rasterizes a charset from a source font once
+    /// and returns a font drawing those glyphs straight from the atlas. All
+    /// sizes share one bitmap store, and [`with_budget`](Self::with_budget)
+    /// caps its size. Letters outside the charset go to the fallback font.
+    ///
+    /// Fonts returned by `add` are valid until the atlas is dropped.
+    pub struct GlyphAtlas {
+        shared: Box<Shared>,
+        faces: Vec<Box<Face>>,
+    }
+
+    impl GlyphAtlas {
+        /// Create an empty atlas storing bitmaps in `format`
+        pub fn new(format: AtlasFormat) -> Self {
+            Self {
+                shared: Box::new(Shared {
+                    format,
+                    bitmaps: Vec::new(),
+                    budget: usize::MAX,
+                    hits: AtomicU32::new(0),
+                    misses: AtomicU32::new(0),
+                }),
+                faces: Vec::new(),
+            }
+        }
+
+        /// Limit the bitmap store to `bytes`
+        pub fn with_budget(mut self, bytes: usize) -> Self {
+            self.shared.budget = bytes;
+            self
+        }
+
+        /// Rasterize `charset` from `source` and return a font serving it.
+        ///
+        /// Line metrics are taken from `source` as it is now, so a TTF font
+        /// can be resized between calls. `fallback` draws any other letter.
+        /// Fails with [`FontError::OutOfBudget`] (adding nothing) if the
+        /// glyphs don't fit, or [`FontError::InvalidData`] if the source
+        /// produced a non-alpha bitmap.
+        pub fn add(
+            &mut self,
+            source: &Font,
+            charset: &str,
+            fallback: Option<Font>,
+        ) -> Result<Font, FontError> {
+            let start = self.shared.bitmaps.len();
+            let mut glyphs: Vec<StaticGlyph> = Vec::new();
+            for letter in charset.chars().map(u32::from) {
+                if glyphs.iter().any(|g| g.letter == letter) {
+                    continue;
+                }
+                match unsafe { self.rasterize(source.raw(), letter) } {
+                    Ok(Some(glyph)) => glyphs.push(glyph),
+                    Ok(None) => {}
+                    Err(e) => {
+                        self.shared.bitmaps.truncate(start);
+                        return Err(e);
+                    }
+                }
+            }
+            glyphs.sort_unstable_by_key(|g| g.letter);
+            self.shared.bitmaps.shrink_to_fit();
+
+            let mut font = unsafe { *source.raw() };
+            font.get_glyph_dsc = Some(atlas_glyph_dsc);
+            font.get_glyph_bitmap = Some(atlas_glyph_bitmap);
+            font.release_glyph = None;
+            font.fallback = fallback.map_or(core::ptr::null(), |f| f.raw());
+            font.user_data = core::ptr::null_mut();
+
+            let mut face = Box::new(Face {
+                font,
+                glyphs,
+                shared: &*self.shared,
+            });
+            face.font.dsc = &*face as *const Face as *const c_void;
+            let raw = &face.font as *const neo_lvgl_sys::lv_font_t;
+            self.faces.push(face);
+            Ok(unsafe { Font::from_raw(raw) })
+        }
+
+        /// Rasterize one letter into the bitmap store
+        unsafe fn rasterize(
+            &mut self,
+            source: *const neo_lvgl_sys::lv_font_t,
+            letter: u32,
+        ) -> Result<Option<StaticGlyph>, FontError> {
+            let mut dsc: neo_lvgl_sys::lv_font_glyph_dsc_t = core::mem::zeroed();
+            if !neo_lvgl_sys::lv_font_get_glyph_dsc(source, &mut dsc, letter, 0)
+                || dsc.is_placeholder() != 0
+            {
+                return Ok(None);
+            }
+            let (w, h) = (dsc.box_w as usize, dsc.box_h as usize);
+            let stride = match self.shared.format {
+                AtlasFormat::A4 => w.div_ceil(2),
+                AtlasFormat::A8 => w,
+            };
+            let offset = self.shared.bitmaps.len();
+            if offset + stride * h > self.shared.budget {
+                return Err(FontError::OutOfBudget);
+            }
+            let glyph = StaticGlyph {
+                letter,
+                adv_w: dsc.adv_w,
+                box_w: dsc.box_w,
+                box_h: dsc.box_h,
+                ofs_x: dsc.ofs_x,
+                ofs_y: dsc.ofs_y,
+                offset: offset as u32,
+            };
+            if w == 0 || h == 0 {
+                return Ok(Some(glyph));
+            }
+            if dsc.format > neo_lvgl_sys::lv_font_glyph_format_t_LV_FONT_GLYPH_FORMAT_A8 {
+                return Err(FontError::InvalidData);
+            }
+
+            let tmp = neo_lvgl_sys::lv_draw_buf_create(
+                w as u32,
+                h as u32,
+                neo_lvgl_sys::lv_color_format_t_LV_COLOR_FORMAT_A8,
+                neo_lvgl_sys::LV_STRIDE_AUTO,
+            );
+            if tmp.is_null() {
+                return Err(FontError::LoadFailed);
+            }
+            // Alpha glyphs come back as an A8 draw buffer (usually `tmp`)
+            let out = neo_lvgl_sys::lv_font_get_glyph_bitmap(&mut dsc, tmp)
+                as *const neo_lvgl_sys::lv_draw_buf_t;
+            let result = if out.is_null() {
+                Err(FontError::LoadFailed)
+            } else {
+                let src_stride = (*out).header.stride() as usize;
+                let bitmaps = &mut self.shared.bitmaps;
+                bitmaps.resize(offset + stride * h, 0);
+                for y in 0..h {
+                    let row = core::slice::from_raw_parts((*out).data.add(y * src_stride), w);
+                    let dst = &mut bitmaps[offset + y * stride..offset + (y + 1) * stride];
+                    match self.shared.format {
+                        AtlasFormat::A8 => dst.copy_from_slice(row),
+                        AtlasFormat::A4 => {
+                            for (x, &a) in row.iter().enumerate() {
+                                dst[x / 2] |= (a >> 4) << if x % 2 == 0 { 4 } else { 0 };
+                            }
+                        }
+                    }
+                }
+                Ok(Some(glyph))
+            };
+            neo_lvgl_sys::lv_font_glyph_release_draw_data(&mut dsc);
+            neo_lvgl_sys::lv_draw_buf_destroy(tmp);
+            result
+        }
+
+        /// Size and lookup counters
+        pub fn stats(&self) -> AtlasStats {
+            AtlasStats {
+                glyphs: self.faces.iter().map(|f| f.glyphs.len()).sum(),
+                bytes: self.shared.bitmaps.len(),
+                hits: self.shared.hits.load(Ordering::Relaxed),
+                misses: self.shared.misses.load(Ordering::Relaxed),
+            }
+        }
+
+        /// Reset the lookup counters
+        pub fn reset_stats(&self) {
+            self.shared.hits.store(0, Ordering::Relaxed);
+            self.shared.misses.store(0, Ordering::Relaxed);
+        }
+    }
+
+    unsafe extern "C" fn atlas_glyph_dsc(
+        font: *const neo_lvgl_sys::lv_font_t,
+        dsc: *mut neo_lvgl_sys::lv_font_glyph_dsc_t,
+        letter: u32,
+        _letter_next: u32,
+    ) -> bool {
+        let face = &*((*font).dsc as *const Face);
+        let shared = &*face.shared;
+        let found = lookup_glyph(&face.glyphs, letter, dsc);
+        let counter = if found { &shared.hits } else { &shared.misses };
+        counter.fetch_add(1, Ordering::Relaxed);
+        found
+    }
+
+    unsafe extern "C" fn atlas_glyph_bitmap(
+        dsc: *mut neo_lvgl_sys::lv_font_glyph_dsc_t,
+        draw_buf: *mut neo_lvgl_sys::lv_draw_buf_t,
+    ) -> *const c_void {
+        let face = &*((*(*dsc).resolved_font).dsc as *const Face);
+        let shared = &*face.shared;
+        let glyph = &face.glyphs[(*dsc).gid.index as usize];
+        expand_glyph(shared.format, &shared.bitmaps, glyph, draw_buf)
+    }
+}
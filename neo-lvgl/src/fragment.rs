@@ -31,14 +31,61 @@
 //! let home = Fragment::new(HomeFragment { title: "Home" });
 //! manager.push(home, &screen);
 //! ```
+//!
+//! # Screen cache
+//!
+//! Navigating deletes the previous fragment's objects and rebuilds them when
+//! it comes back. A fragment that returns a [`FragmentImpl::cache_key`]
+//! keeps its object tree instead: when LVGL deletes the fragment's objects
+//! the tree is moved to an unloaded parking screen, and the next fragment of
+//! the same type and key (or the same fragment after a `pop`) gets it back
+//! through [`FragmentImpl::obj_restored`] in a single frame.
+//!
+//! Parked trees form an LRU bounded by [`set_cache_budget`]. The heap cost
+//! of each tree is measured while it is built, with `lv_mem_monitor` or,
+//! with the `rust-alloc` feature, LVGL's block bytes. When a fresh build
+//! fails, unowned trees are evicted and the build is retried;
+//! [`trim_cache`] releases memory on demand. [`prebuild_when_idle`] builds
+//! likely next screens ahead of time, one per timer cycle while
+//! `lv_timer_handler` is mostly idle.
+//!
+//! Cached trees can outlive the fragment that built them, so their event
+//! handlers must not borrow fragment state.
+//!
+//! ```ignore
+//! impl FragmentImpl for Settings {
+//!     fn cache_key(&self) -> Option<u32> {
+//!         Some(0)
+//!     }
+//!
+//!     fn create_obj(&mut self, container: &Obj) -> Option<Obj> {
+//!         build_settings(container)
+//!     }
+//!
+//!     fn obj_restored(&mut self, obj: &Obj) {
+//!         self.wifi = obj.find_by_name(c"wifi");
+//!     }
+//! }
+//!
+//! fragment::set_cache_budget(96 * 1024, 4);
+//! fragment::prebuild_when_idle(Settings::default());
+//! ```
 
 use crate::widgets::{Obj, Widget};
 use core::ffi::c_void;
 use core::marker::PhantomData;
-use core::ptr::NonNull;
+use core::ptr::{self, NonNull};
 
 #[cfg(feature = "alloc")]
 use alloc::boxed::Box;
+#[cfg(feature = "alloc")]
+use alloc::collections::VecDeque;
+#[cfg(feature = "alloc")]
+use alloc::vec::Vec;
+#[cfg(feature = "alloc")]
+use core::any::TypeId;
+#[cfg(feature = "alloc")]
+use core::cell::UnsafeCell;
 
 /// Trait for implementing fragment behavior.
 ///
@@ -75,6 +122,19 @@ pub trait FragmentImpl: Sized {
     /// Called when the fragment's objects have been deleted.
     fn obj_deleted(&mut self) {}
 
+    /// Key under which the object tree is cached, or `None` (the default)
+    /// to rebuild it on every navigation.
+    ///
+    /// Fragments of the same type with the same key share the cached tree;
+    /// see the [module docs](self#screen-cache).
+    fn cache_key(&self) -> Option<u32> {
+        None
+    }
+
+    /// Called instead of `create_obj` and `obj_created` when a cached tree
+    /// is attached, e.g. to look up widgets and refresh their values.
+    fn obj_restored(&mut self, _obj: &Obj) {}
+
     /// Handle a custom event sent to this fragment.
     ///
     /// Return `true` if the event was handled.
@@ -141,6 +201,9 @@ impl<T: FragmentImpl + 'static> Fragment<T> {
     }
 
     /// Get the object created by this fragment.
+    ///
+    /// For cached fragments this is the host object the cached tree is
+    /// attached to.
     pub fn obj(&self) -> Option<Obj<'_>> {
         unsafe {
             let obj = (*self.raw.as_ptr()).obj;
@@ -313,10 +376,33 @@ impl Drop for FragmentManager {
 struct FragmentWrapper<T> {
     // Must be first - LVGL fragment base
     base: neo_lvgl_sys::lv_fragment_t,
+    // Cached tree attached to the fragment's host object
+    slot: CacheSlot,
     // User data
     data: T,
 }
 
+struct CacheSlot {
+    key: u32,
+    /// Root of the cached tree while it is attached, else null
+    root: *mut neo_lvgl_sys::lv_obj_t,
+    bytes: usize,
+    /// `root` came from the cache rather than `create_obj`
+    restored: bool,
+    /// The host is being deleted after its tree was parked
+    parked: bool,
+}
+
+impl CacheSlot {
+    const EMPTY: Self = Self {
+        key: 0,
+        root: ptr::null_mut(),
+        bytes: 0,
+        restored: false,
+        parked: false,
+    };
+}
+
 // Get the wrapper from a fragment pointer
 unsafe fn get_wrapper<T>(fragment: *mut neo_lvgl_sys::lv_fragment_t) -> *mut FragmentWrapper<T> {
     fragment as *mut FragmentWrapper<T>
@@ -330,28 +416,8 @@ struct FragmentClass<T> {
 
 #[cfg(feature = "alloc")]
 impl<T: FragmentImpl + 'static> FragmentClass<T> {
-    /// Get or create the fragment class for this type.
-    fn get() -> *const neo_lvgl_sys::lv_fragment_class_t {
-        // Use a static for each type
-        static_class::<T>()
-    }
-}
-
-// Generate static class instance for each fragment type
-#[cfg(feature = "alloc")]
-fn static_class<T: FragmentImpl + 'static>() -> *const neo_lvgl_sys::lv_fragment_class_t {
-    use core::sync::atomic::{AtomicPtr, Ordering};
-    use neo_lvgl_sys::lv_fragment_class_t;
-
-    static CLASS: AtomicPtr<lv_fragment_class_t> = AtomicPtr::new(core::ptr::null_mut());
-
-    let ptr = CLASS.load(Ordering::Acquire);
-    if !ptr.is_null() {
-        return ptr;
-    }
-
-    // Create the class
-    let cls = Box::new(lv_fragment_class_t {
+    // One promoted constant per fragment type
+    const CLASS: neo_lvgl_sys::lv_fragment_class_t = neo_lvgl_sys::lv_fragment_class_t {
         constructor_cb: Some(constructor_cb::<T>),
         destructor_cb: Some(destructor_cb::<T>),
         attached_cb: Some(attached_cb::<T>),
@@ -362,11 +428,378 @@ fn static_class<T: FragmentImpl + 'static>() -> *const neo_lvgl_sys::lv_fragment
         obj_deleted_cb: Some(obj_deleted_cb::<T>),
         event_cb: Some(event_cb::<T>),
         instance_size: core::mem::size_of::<FragmentWrapper<T>>(),
-    });
+    };
+
+    /// Get the fragment class for this type.
+    fn get() -> *const neo_lvgl_sys::lv_fragment_class_t {
+        &Self::CLASS
+    }
+}
+
+#[cfg(feature = "alloc")]
+pub use cache::{
+    cache_stats, clear_cache, prebuild, prebuild_when_idle, set_cache_budget, trim_cache,
+    CacheStats,
+};
+
+/// LRU of parked object trees
+#[cfg(feature = "alloc")]
+mod cache {
+    use super::*;
+    use crate::widgets::pct;
+    use neo_lvgl_sys::{lv_fragment_t, lv_obj_t};
+
+    /// Prebuild only while the timer handler was idle at least this much (%)
+    const PREBUILD_IDLE_PCT: u32 = 50;
+    const PREBUILD_PERIOD_MS: u32 = 100;
+
+    /// Cache statistics, see [`cache_stats`]
+    #[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+    pub struct CacheStats {
+        /// Parked trees
+        pub entries: usize,
+        /// Measured heap cost of the parked trees
+        pub bytes: usize,
+        /// Trees attached from the cache
+        pub hits: u32,
+        /// Trees built by `create_obj`
+        pub misses: u32,
+        /// Trees deleted to stay within the budget or on request
+        pub evictions: u32,
+    }
+
+    type Key = (TypeId, u32);
+
+    /// Typed `obj_will_delete`/delete/`obj_deleted` sequence for an owner
+    type Evict = unsafe fn(*mut lv_fragment_t, *mut lv_obj_t);
+
+    struct Entry {
+        key: Key,
+        root: *mut lv_obj_t,
+        bytes: usize,
+        /// Live fragment the tree belongs to, with its typed eviction hook
+        owner: Option<(*mut lv_fragment_t, Evict)>,
+    }
+
+    struct Cache {
+        /// Least recently used first
+        entries: Vec<Entry>,
+        parking: *mut lv_obj_t,
+        budget: usize,
+        max_entries: usize,
+        stats: CacheStats,
+        jobs: VecDeque<Box<dyn FnOnce()>>,
+        timer: *mut neo_lvgl_sys::lv_timer_t,
+    }
+
+    struct CacheCell(UnsafeCell<Cache>);
+
+    // SAFETY: only used from the LVGL thread
+    unsafe impl Sync for CacheCell {}
+
+    static CACHE: CacheCell = CacheCell(UnsafeCell::new(Cache {
+        entries: Vec::new(),
+        parking: ptr::null_mut(),
+        budget: usize::MAX,
+        max_entries: 4,
+        stats: CacheStats {
+            entries: 0,
+            bytes: 0,
+            hits: 0,
+            misses: 0,
+            evictions: 0,
+        },
+        jobs: VecDeque::new(),
+        timer: ptr::null_mut(),
+    }));
+
+    /// The borrow must end before any user callback runs.
+    unsafe fn cache() -> &'static mut Cache {
+        &mut *CACHE.0.get()
+    }
+
+    /// Keep at most `max_entries` parked trees using at most `bytes`
+    ///
+    /// Defaults to 4 entries and no byte limit. Trees over the budget are
+    /// evicted least recently used first.
+    pub fn set_cache_budget(bytes: usize, max_entries: usize) {
+        unsafe {
+            let cache = cache();
+            cache.budget = bytes;
+            cache.max_entries = max_entries;
+            enforce();
+        }
+    }
+
+    /// Current cache statistics
+    pub fn cache_stats() -> CacheStats {
+        unsafe {
+            let cache = cache();
+            CacheStats {
+                entries: cache.entries.len(),
+                ..cache.stats
+            }
+        }
+    }
+
+    /// Evict parked trees until they use at most `max_bytes`, e.g. when
+    /// the application runs low on memory
+    pub fn trim_cache(max_bytes: usize) {
+        unsafe { while cache().stats.bytes > max_bytes && evict_at(0) {} }
+    }
+
+    /// Delete all parked trees
+    pub fn clear_cache() {
+        unsafe { while evict_at(0) {} }
+    }
+
+    /// Build the tree of a cacheable fragment now, so navigating to a
+    /// fragment of the same type and key attaches it instantly
+    ///
+    /// Only `create_obj` is called on `data`, which is then dropped. Returns
+    /// `false` if the fragment is not cacheable or the build failed.
+    pub fn prebuild<T: FragmentImpl + 'static>(mut data: T) -> bool {
+        let Some(key) = data.cache_key() else {
+            return false;
+        };
+        let key = (TypeId::of::<T>(), key);
+        unsafe {
+            if cache().entries.iter().any(|e| e.key == key) {
+                return true;
+            }
+            let parking = parking();
+            let before = heap_used();
+            let root = match Obj::from_raw(parking) {
+                Some(parking) => data.create_obj(&parking).map(|obj| obj.raw()),
+                None => None,
+            };
+            let Some(root) = root else {
+                return false;
+            };
+            insert(Entry {
+                key,
+                root,
+                bytes: heap_used().saturating_sub(before),
+                owner: None,
+            });
+            true
+        }
+    }
+
+    /// Queue [`prebuild`] for a later timer cycle
+    ///
+    /// One queued fragment is built per cycle, and only while
+    /// `lv_timer_handler` has been idle at least half the time.
+    pub fn prebuild_when_idle<T: FragmentImpl + 'static>(data: T) {
+        unsafe {
+            let cache = cache();
+            cache.jobs.push_back(Box::new(move || {
+                prebuild(data);
+            }));
+            if cache.timer.is_null() {
+                cache.timer = neo_lvgl_sys::lv_timer_create(
+                    Some(prebuild_timer_cb),
+                    PREBUILD_PERIOD_MS,
+                    ptr::null_mut(),
+                );
+            } else {
+                neo_lvgl_sys::lv_timer_resume(cache.timer);
+            }
+        }
+    }
+
+    unsafe extern "C" fn prebuild_timer_cb(timer: *mut neo_lvgl_sys::lv_timer_t) {
+        if neo_lvgl_sys::lv_timer_get_idle() < PREBUILD_IDLE_PCT {
+            return;
+        }
+        match cache().jobs.pop_front() {
+            Some(job) => job(),
+            None => neo_lvgl_sys::lv_timer_pause(timer),
+        }
+    }
+
+    /// Heap in use according to `lv_mem_monitor`
+    #[cfg(not(feature = "rust-alloc"))]
+    fn heap_used() -> usize {
+        unsafe {
+            let mut mon: neo_lvgl_sys::lv_mem_monitor_t = core::mem::zeroed();
+            neo_lvgl_sys::lv_mem_monitor(&mut mon);
+            mon.total_size.saturating_sub(mon.free_size)
+        }
+    }
+
+    /// Bytes of LVGL blocks in use; the Rust allocator reports no heap size
+    #[cfg(feature = "rust-alloc")]
+    fn heap_used() -> usize {
+        crate::mem::stats().used
+    }
+
+    /// Hidden screen that holds parked trees
+    unsafe fn parking() -> *mut lv_obj_t {
+        let cache = cache();
+        if cache.parking.is_null() {
+            cache.parking = neo_lvgl_sys::lv_obj_create(ptr::null_mut());
+        }
+        cache.parking
+    }
+
+    /// Transparent object the fragment manager owns in place of the tree
+    unsafe fn new_host(container: *mut lv_obj_t) -> *mut lv_obj_t {
+        let host = neo_lvgl_sys::lv_obj_create(container);
+        if host.is_null() {
+            return host;
+        }
+        neo_lvgl_sys::lv_obj_remove_style_all(host);
+        neo_lvgl_sys::lv_obj_set_size(host, pct(100), pct(100));
+        neo_lvgl_sys::lv_obj_remove_flag(
+            host,
+            neo_lvgl_sys::lv_obj_flag_t_LV_OBJ_FLAG_SCROLLABLE
+                | neo_lvgl_sys::lv_obj_flag_t_LV_OBJ_FLAG_CLICKABLE
+                | neo_lvgl_sys::lv_obj_flag_t_LV_OBJ_FLAG_CLICK_FOCUSABLE,
+        );
+        host
+    }
+
+    /// `create_obj_cb` of a cacheable fragment
+    pub(super) unsafe fn create_obj<T: FragmentImpl + 'static>(
+        fragment: *mut lv_fragment_t,
+        container: *mut lv_obj_t,
+        key: u32,
+    ) -> *mut lv_obj_t {
+        let wrapper = get_wrapper::<T>(fragment);
+        let host = new_host(container);
+        if host.is_null() {
+            return host;
+        }
 
-    let raw = Box::into_raw(cls);
-    CLASS.store(raw, Ordering::Release);
-    raw
+        let type_key = (TypeId::of::<T>(), key);
+        let cache = cache();
+        let found = cache.entries.iter().position(|e| {
+            e.key == type_key && e.owner.map_or(true, |(owner, _)| owner == fragment)
+        });
+        if let Some(index) = found {
+            let entry = cache.entries.remove(index);
+            cache.stats.bytes -= entry.bytes;
+            cache.stats.hits += 1;
+            neo_lvgl_sys::lv_obj_set_parent(entry.root, host);
+            (*wrapper).slot = CacheSlot {
+                key,
+                root: entry.root,
+                bytes: entry.bytes,
+                restored: true,
+                parked: false,
+            };
+            return host;
+        }
+        cache.stats.misses += 1;
+
+        let mut retried = false;
+        loop {
+            let before = heap_used();
+            let root = match Obj::from_raw(host) {
+                Some(host) => (*wrapper).data.create_obj(&host).map(|obj| obj.raw()),
+                None => None,
+            };
+            if let Some(root) = root {
+                (*wrapper).slot = CacheSlot {
+                    key,
+                    root,
+                    bytes: heap_used().saturating_sub(before),
+                    restored: false,
+                    parked: false,
+                };
+                return host;
+            }
+            // Possibly out of memory: drop unowned trees and try once more
+            if retried || !evict_unowned() {
+                neo_lvgl_sys::lv_obj_delete(host);
+                return ptr::null_mut();
+            }
+            retried = true;
+        }
+    }
+
+    /// `obj_will_delete_cb` of a fragment with an attached tree
+    pub(super) unsafe fn park_owned<T: FragmentImpl + 'static>(fragment: *mut lv_fragment_t) {
+        let wrapper = get_wrapper::<T>(fragment);
+        let slot = core::mem::replace(&mut (*wrapper).slot, CacheSlot::EMPTY);
+        (*wrapper).slot.parked = true;
+        neo_lvgl_sys::lv_obj_set_parent(slot.root, parking());
+        insert(Entry {
+            key: (TypeId::of::<T>(), slot.key),
+            root: slot.root,
+            bytes: slot.bytes,
+            owner: Some((fragment, evict_owned::<T>)),
+        });
+    }
+
+    /// The fragment is being destroyed; its parked trees become unowned
+    pub(super) unsafe fn orphan(fragment: *mut lv_fragment_t) {
+        for entry in &mut cache().entries {
+            if entry.owner.is_some_and(|(owner, _)| owner == fragment) {
+                entry.owner = None;
+            }
+        }
+    }
+
+    unsafe fn evict_owned<T: FragmentImpl>(fragment: *mut lv_fragment_t, root: *mut lv_obj_t) {
+        let wrapper = get_wrapper::<T>(fragment);
+        if let Some(obj) = Obj::from_raw(root) {
+            (*wrapper).data.obj_will_delete(&obj);
+        }
+        neo_lvgl_sys::lv_obj_delete(root);
+        (*wrapper).data.obj_deleted();
+    }
+
+    unsafe fn insert(entry: Entry) {
+        let cache = cache();
+        // A newer tree for the same key replaces an unowned one
+        let stale = cache
+            .entries
+            .iter()
+            .position(|e| e.key == entry.key && e.owner.is_none());
+        cache.stats.bytes += entry.bytes;
+        cache.entries.push(entry);
+        if let Some(index) = stale {
+            evict_at(index);
+        }
+        enforce();
+    }
+
+    unsafe fn enforce() {
+        loop {
+            let cache = cache();
+            let over = cache.entries.len() > cache.max_entries || cache.stats.bytes > cache.budget;
+            if !over || !evict_at(0) {
+                return;
+            }
+        }
+    }
+
+    unsafe fn evict_unowned() -> bool {
+        let mut evicted = false;
+        while let Some(index) = cache().entries.iter().position(|e| e.owner.is_none()) {
+            evict_at(index);
+            evicted = true;
+        }
+        evicted
+    }
+
+    /// Remove and delete an entry; returns `false` if there is none
+    unsafe fn evict_at(index: usize) -> bool {
+        let cache = cache();
+        if index >= cache.entries.len() {
+            return false;
+        }
+        let entry = cache.entries.remove(index);
+        cache.stats.bytes -= entry.bytes;
+        cache.stats.evictions += 1;
+        match entry.owner {
+            Some((fragment, evict)) => evict(fragment, entry.root),
+            None => neo_lvgl_sys::lv_obj_delete(entry.root),
+        }
+        true
+    }
 }
 
 // C callback trampolines
@@ -380,6 +813,7 @@ unsafe extern "C" fn constructor_cb<T: FragmentImpl>(
     let wrapper = get_wrapper::<T>(fragment);
 
     // Initialize the user data in place
+    core::ptr::write(&mut (*wrapper).slot, CacheSlot::EMPTY);
     core::ptr::write(&mut (*wrapper).data, *data);
 
     // Call user constructor
@@ -388,6 +822,8 @@ unsafe extern "C" fn constructor_cb<T: FragmentImpl>(
 
 #[cfg(feature = "alloc")]
 unsafe extern "C" fn destructor_cb<T: FragmentImpl>(fragment: *mut neo_lvgl_sys::lv_fragment_t) {
+    // Parked trees stay cached for the next fragment with the same key
+    cache::orphan(fragment);
     let wrapper = get_wrapper::<T>(fragment);
     (*wrapper).data.destructor();
     // Drop the user data
@@ -407,11 +843,14 @@ unsafe extern "C" fn detached_cb<T: FragmentImpl>(fragment: *mut neo_lvgl_sys::l
 }
 
 #[cfg(feature = "alloc")]
-unsafe extern "C" fn create_obj_cb<T: FragmentImpl>(
+unsafe extern "C" fn create_obj_cb<T: FragmentImpl + 'static>(
     fragment: *mut neo_lvgl_sys::lv_fragment_t,
     container: *mut neo_lvgl_sys::lv_obj_t,
 ) -> *mut neo_lvgl_sys::lv_obj_t {
     let wrapper = get_wrapper::<T>(fragment);
+    if let Some(key) = (*wrapper).data.cache_key() {
+        return cache::create_obj::<T>(fragment, container, key);
+    }
     let container_obj = Obj::from_raw(container);
 
     if let Some(container) = container_obj {
@@ -428,17 +867,28 @@ unsafe extern "C" fn obj_created_cb<T: FragmentImpl>(
     obj: *mut neo_lvgl_sys::lv_obj_t,
 ) {
     let wrapper = get_wrapper::<T>(fragment);
+    let CacheSlot { root, restored, .. } = (*wrapper).slot;
+    let obj = if root.is_null() { obj } else { root };
     if let Some(obj) = Obj::from_raw(obj) {
-        (*wrapper).data.obj_created(&obj);
+        if restored {
+            (*wrapper).data.obj_restored(&obj);
+        } else {
+            (*wrapper).data.obj_created(&obj);
+        }
     }
 }
 
 #[cfg(feature = "alloc")]
-unsafe extern "C" fn obj_will_delete_cb<T: FragmentImpl>(
+unsafe extern "C" fn obj_will_delete_cb<T: FragmentImpl + 'static>(
     fragment: *mut neo_lvgl_sys::lv_fragment_t,
     obj: *mut neo_lvgl_sys::lv_obj_t,
 ) {
     let wrapper = get_wrapper::<T>(fragment);
+    if !(*wrapper).slot.root.is_null() {
+        // Only the host is deleted; the tree goes back to the cache
+        cache::park_owned::<T>(fragment);
+        return;
+    }
     if let Some(obj) = Obj::from_raw(obj) {
         (*wrapper).data.obj_will_delete(&obj);
     }
@@ -450,6 +900,9 @@ unsafe extern "C" fn obj_deleted_cb<T: FragmentImpl>(
     _obj: *mut neo_lvgl_sys::lv_obj_t,
 ) {
     let wrapper = get_wrapper::<T>(fragment);
+    if core::mem::take(&mut (*wrapper).slot.parked) {
+        return;
+    }
     (*wrapper).data.obj_deleted();
 }
 
@@ -0,0 +1,377 @@
+//! Image decode and header caches
+//!
+//! LVGL keeps decoded images in a cache limited by a byte budget and image
+//! headers (size, format) in a second cache limited by an entry count. Both
+//! start at `LV_CACHE_DEF_SIZE` / `LV_IMAGE_HEADER_CACHE_DEF_CNT`, which are
+//! 0 unless `NEO_LVGL_IMAGE_CACHE_SIZE` / `NEO_LVGL_IMAGE_HEADER_CACHE_COUNT`
+//! are set at build time, so every redraw decodes its image again.
+//!
+//! # Example
+//!
+//! ```ignore
+//! use lvgl::image_cache::{self, ImageSrc, Preload};
+//!
+//! static ICONS: Preload = Preload::new(&[
+//!     ImageSrc::dsc(&icon_wifi),
+//!     ImageSrc::dsc(&icon_battery),
+//! ]);
+//!
+//! image_cache::enable_stats();
+//! image_cache::set_budget(64 * 1024);
+//! image_cache::set_header_count(32);
+//!
+//! // Never evict the logo
+//! let _logo = image_cache::pin(ImageSrc::dsc(&logo)).unwrap();
+//! // Decode the icons before the status screen's first frame
+//! image_cache::preload_on_load(&status_screen, &ICONS);
+//!
+//! let stats = image_cache::stats();
+//! log!("hit rate {}/{}", stats.decoded.hits, stats.decoded.lookups());
+//! ```
+
+use crate::widgets::Widget;
+use core::cell::UnsafeCell;
+use core::ffi::{c_void, CStr};
+use core::mem::MaybeUninit;
+use core::sync::atomic::{AtomicBool, AtomicU32, Ordering};
+
+/// An image source: an image descriptor, a file path or a symbol
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+#[repr(transparent)]
+pub struct ImageSrc(*const c_void);
+
+// SAFETY: only refers to 'static, immutable image data
+unsafe impl Sync for ImageSrc {}
+unsafe impl Send for ImageSrc {}
+
+impl ImageSrc {
+    /// An image descriptor, e.g. from an asset converter
+    pub const fn dsc(dsc: &'static neo_lvgl_sys::lv_image_dsc_t) -> Self {
+        Self(dsc as *const _ as *const c_void)
+    }
+
+    /// A file path (`"A:icons/wifi.bin"`) or symbol
+    pub const fn path(path: &'static CStr) -> Self {
+        Self(path.as_ptr() as *const c_void)
+    }
+
+    /// Wrap a raw source pointer
+    ///
+    /// # Safety
+    ///
+    /// `src` must be a valid LVGL image source that never changes or moves.
+    pub const unsafe fn from_raw(src: *const c_void) -> Self {
+        Self(src)
+    }
+
+    /// Get the raw source pointer
+    pub const fn raw(self) -> *const c_void {
+        self.0
+    }
+}
+
+/// Set the decoded image cache budget in bytes (0 disables caching).
+///
+/// Entries over the new budget are evicted immediately. Returns `false` if
+/// LVGL rejected the size.
+pub fn set_budget(bytes: u32) -> bool {
+    unsafe {
+        neo_lvgl_sys::lv_image_cache_resize(bytes, true) == neo_lvgl_sys::lv_result_t_LV_RESULT_OK
+    }
+}
+
+/// Set how many image headers to cache (0 disables caching).
+pub fn set_header_count(count: u32) -> bool {
+    unsafe {
+        neo_lvgl_sys::lv_image_header_cache_resize(count, true)
+            == neo_lvgl_sys::lv_result_t_LV_RESULT_OK
+    }
+}
+
+/// Current decoded cache budget in bytes
+pub fn budget() -> u32 {
+    with_cache(Kind::Decoded, |cache| unsafe {
+        neo_lvgl_sys::lv_cache_get_max_size(cache, core::ptr::null_mut())
+    })
+}
+
+/// Bytes currently held by decoded images
+pub fn used() -> u32 {
+    with_cache(Kind::Decoded, |cache| unsafe {
+        neo_lvgl_sys::lv_cache_get_size(cache, core::ptr::null_mut())
+    })
+}
+
+/// Drop the cached data of `src`, e.g. after its pixels changed
+pub fn invalidate(src: ImageSrc) {
+    uncounted(|| unsafe {
+        neo_lvgl_sys::lv_image_cache_drop(src.raw());
+        neo_lvgl_sys::lv_image_header_cache_drop(src.raw());
+    });
+}
+
+/// Drop all unpinned entries from both caches
+pub fn clear() {
+    uncounted(|| unsafe {
+        neo_lvgl_sys::lv_image_cache_drop(core::ptr::null());
+        neo_lvgl_sys::lv_image_header_cache_drop(core::ptr::null());
+    });
+}
+
+/// A decoded image held in the cache; evictable again once dropped
+pub struct PinnedImage {
+    dsc: neo_lvgl_sys::lv_image_decoder_dsc_t,
+}
+
+impl PinnedImage {
+    /// Width and height of the image
+    pub fn size(&self) -> (u32, u32) {
+        (self.dsc.header.w(), self.dsc.header.h())
+    }
+}
+
+impl Drop for PinnedImage {
+    fn drop(&mut self) {
+        unsafe {
+            neo_lvgl_sys::lv_image_decoder_close(&mut self.dsc);
+        }
+    }
+}
+
+/// Decode `src` into the cache and keep it there while the pin lives.
+///
+/// An open decoder session holds a reference on the cache entry, which
+/// LVGL never evicts. Returns `None` if decoding failed.
+pub fn pin(src: ImageSrc) -> Option<PinnedImage> {
+    let mut dsc = MaybeUninit::<neo_lvgl_sys::lv_image_decoder_dsc_t>::zeroed();
+    unsafe {
+        let result =
+            neo_lvgl_sys::lv_image_decoder_open(dsc.as_mut_ptr(), src.raw(), core::ptr::null());
+        if result != neo_lvgl_sys::lv_result_t_LV_RESULT_OK {
+            return None;
+        }
+        Some(PinnedImage {
+            dsc: dsc.assume_init(),
+        })
+    }
+}
+
+/// Decode `srcs` into the cache so the first frame using them is fast.
+///
+/// Images that exceed the budget are decoded and evicted again. Returns
+/// how many were decoded.
+pub fn preload(srcs: &[ImageSrc]) -> usize {
+    srcs.iter().filter(|&&src| pin(src).is_some()).count()
+}
+
+/// A set of images to decode when a screen starts loading
+pub struct Preload {
+    srcs: &'static [ImageSrc],
+}
+
+impl Preload {
+    /// Create a preload set
+    pub const fn new(srcs: &'static [ImageSrc]) -> Self {
+        Self { srcs }
+    }
+}
+
+unsafe extern "C" fn preload_cb(e: *mut neo_lvgl_sys::lv_event_t) {
+    let set = neo_lvgl_sys::lv_event_get_user_data(e) as *const Preload;
+    preload((*set).srcs);
+}
+
+/// Preload `set` every time `screen` starts loading.
+pub fn preload_on_load<'a>(screen: &impl Widget<'a>, set: &'static Preload) {
+    unsafe {
+        neo_lvgl_sys::lv_obj_add_event_cb(
+            screen.raw(),
+            Some(preload_cb),
+            neo_lvgl_sys::lv_event_code_t_LV_EVENT_SCREEN_LOAD_START,
+            set as *const Preload as *mut c_void,
+        );
+    }
+}
+
+/// Lookup counters of one cache
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub struct CacheStats {
+    /// Lookups that found an entry
+    pub hits: u32,
+    /// Lookups that found nothing (the image was decoded)
+    pub misses: u32,
+    /// Entries evicted to make room
+    pub evictions: u32,
+}
+
+impl CacheStats {
+    /// Total number of lookups
+    pub fn lookups(&self) -> u32 {
+        self.hits.saturating_add(self.misses)
+    }
+}
+
+/// Counters for both image caches, see [`enable_stats`]
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub struct Stats {
+    /// Decoded image cache
+    pub decoded: CacheStats,
+    /// Image header cache
+    pub header: CacheStats,
+}
+
+/// Start counting cache hits, misses and evictions.
+///
+/// Call after [`init`](crate::init); calling again (also after a re-init) is
+/// harmless. Counting adds an atomic increment per lookup.
+pub fn enable_stats() {
+    for kind in [Kind::Decoded, Kind::Header] {
+        with_cache(kind, |cache| unsafe {
+            TRACKED[kind as usize].install(cache, kind)
+        });
+    }
+}
+
+/// Read the counters
+pub fn stats() -> Stats {
+    Stats {
+        decoded: TRACKED[Kind::Decoded as usize].read(),
+        header: TRACKED[Kind::Header as usize].read(),
+    }
+}
+
+/// Reset the counters to zero
+pub fn reset_stats() {
+    for tracked in &TRACKED {
+        tracked.hits.store(0, Ordering::Relaxed);
+        tracked.misses.store(0, Ordering::Relaxed);
+        tracked.evictions.store(0, Ordering::Relaxed);
+    }
+}
+
+#[derive(Clone, Copy)]
+enum Kind {
+    Decoded = 0,
+    Header = 1,
+}
+
+fn with_cache<R: Default>(kind: Kind, f: impl FnOnce(*mut neo_lvgl_sys::lv_cache_t) -> R) -> R {
+    let cache = unsafe {
+        let global = core::ptr::addr_of_mut!(neo_lvgl_sys::lv_global);
+        match kind {
+            Kind::Decoded => (*global).img_cache,
+            Kind::Header => (*global).img_header_cache,
+        }
+    };
+    if cache.is_null() {
+        R::default()
+    } else {
+        f(cache)
+    }
+}
+
+/// Set while entries are dropped; the lookups LVGL makes to find them are
+/// not cache traffic
+static DROPPING: AtomicBool = AtomicBool::new(false);
+
+/// Run `f` without counting its cache lookups
+fn uncounted(f: impl FnOnce()) {
+    DROPPING.store(true, Ordering::Relaxed);
+    f();
+    DROPPING.store(false, Ordering::Relaxed);
+}
+
+/// A copy of a cache class with counting lookup and victim callbacks
+struct Tracked {
+    class: UnsafeCell<MaybeUninit<neo_lvgl_sys::lv_cache_class_t>>,
+    get: UnsafeCell<neo_lvgl_sys::lv_cache_get_cb_t>,
+    victim: UnsafeCell<neo_lvgl_sys::lv_cache_get_victim_cb>,
+    hits: AtomicU32,
+    misses: AtomicU32,
+    evictions: AtomicU32,
+}
+
+// SAFETY: the cells are written only by `install` on the LVGL thread,
+// before the class is handed to LVGL
+unsafe impl Sync for Tracked {}
+
+static TRACKED: [Tracked; 2] = [Tracked::new(), Tracked::new()];
+
+impl Tracked {
+    const fn new() -> Self {
+        Self {
+            class: UnsafeCell::new(MaybeUninit::uninit()),
+            get: UnsafeCell::new(None),
+            victim: UnsafeCell::new(None),
+            hits: AtomicU32::new(0),
+            misses: AtomicU32::new(0),
+            evictions: AtomicU32::new(0),
+        }
+    }
+
+    unsafe fn install(&self, cache: *mut neo_lvgl_sys::lv_cache_t, kind: Kind) {
+        let ours = (*self.class.get()).as_ptr();
+        if (*cache).clz == ours {
+            return;
+        }
+        let mut class = *(*cache).clz;
+        *self.get.get() = class.get_cb;
+        *self.victim.get() = class.get_victim_cb;
+        match kind {
+            Kind::Decoded => {
+                class.get_cb = Some(tracked_get::<0>);
+                class.get_victim_cb = Some(tracked_victim::<0>);
+            }
+            Kind::Header => {
+                class.get_cb = Some(tracked_get::<1>);
+                class.get_victim_cb = Some(tracked_victim::<1>);
+            }
+        }
+        (*self.class.get()).write(class);
+        (*cache).clz = ours;
+    }
+
+    fn read(&self) -> CacheStats {
+        CacheStats {
+            hits: self.hits.load(Ordering::Relaxed),
+            misses: self.misses.load(Ordering::Relaxed),
+            evictions: self.evictions.load(Ordering::Relaxed),
+        }
+    }
+}
+
+unsafe extern "C" fn tracked_get<const K: usize>(
+    cache: *mut neo_lvgl_sys::lv_cache_t,
+    key: *const c_void,
+    user_data: *mut c_void,
+) -> *mut neo_lvgl_sys::lv_cache_entry_t {
+    let tracked = &TRACKED[K];
+    let entry = match *tracked.get.get() {
+        Some(get) => get(cache, key, user_data),
+        None => core::ptr::null_mut(),
+    };
+    if !DROPPING.load(Ordering::Relaxed) {
+        let counter = if entry.is_null() {
+            &tracked.misses
+        } else {
+            &tracked.hits
+        };
+        counter.fetch_add(1, Ordering::Relaxed);
+    }
+    entry
+}
+
+unsafe extern "C" fn tracked_victim<const K: usize>(
+    cache: *mut neo_lvgl_sys::lv_cache_t,
+    user_data: *mut c_void,
+) -> *mut neo_lvgl_sys::lv_cache_entry_t {
+    let tracked = &TRACKED[K];
+    let entry = match *tracked.victim.get() {
+        Some(victim) => victim(cache, user_data),
+        None => core::ptr::null_mut(),
+    };
+    if !entry.is_null() {
+        tracked.evictions.fetch_add(1, Ordering::Relaxed);
+    }
+    entry
+}
@@ -21,9 +21,38 @@
 //!     }
 //! });
 //! ```
+//!
+//! # Event-driven input
+//!
+//! Read callbacks are polled every `LV_DEF_REFR_PERIOD`, which adds up to a
+//! frame of latency and drops samples that arrive faster. With a
+//! [`SampleQueue`] the touch or encoder interrupt pushes every sample into a
+//! lock-free buffer and wakes the UI loop; [`dispatch`] (called by
+//! [`runloop::run_until_idle`](crate::runloop::run_until_idle)) then feeds
+//! all queued samples to LVGL in one read. The device only polls while held
+//! or while a scroll throw runs, so an idle UI makes no input wakeups.
+//!
+//! ```ignore
+//! use lvgl::indev::{Indev, IndevState, PointerData, SampleQueue};
+//!
+//! static TOUCH: SampleQueue<PointerData, 32> = SampleQueue::new();
+//!
+//! let touch = Indev::new_event(&TOUCH).unwrap();
+//!
+//! #[interrupt]
+//! fn TOUCH_IRQ() {
+//!     let (x, y, down) = touch_controller_read();
+//!     let state = if down { IndevState::Pressed } else { IndevState::Released };
+//!     let _ = TOUCH.push(PointerData { point: Point::new(x, y), state });
+//! }
+//! ```
 
+use crate::sync::UiQueue;
 use crate::widgets::Point;
-use core::ptr::NonNull;
+use core::cell::UnsafeCell;
+use core::ffi::c_void;
+use core::ptr::{self, NonNull};
+use core::sync::atomic::{AtomicBool, AtomicPtr, Ordering};
 
 #[cfg(feature = "alloc")]
 use alloc::boxed::Box;
@@ -352,6 +381,274 @@ impl GestureDir {
     }
 }
 
+/// A sample type that can be queued for an event-driven [`Indev`]
+pub trait Sample: Copy + Send + 'static {
+    /// Device type the samples are for
+    const TYPE: IndevType;
+    /// Reported before the first sample
+    const IDLE: Self;
+
+    /// Store the sample in LVGL's read data
+    fn write(self, data: &mut neo_lvgl_sys::lv_indev_data_t);
+
+    /// Button state of the sample
+    fn state(&self) -> IndevState;
+
+    /// The sample to repeat when LVGL reads with the queue empty
+    fn held(self) -> Self {
+        self
+    }
+}
+
+impl Sample for PointerData {
+    const TYPE: IndevType = IndevType::Pointer;
+    const IDLE: Self = Self {
+        point: Point::new(0, 0),
+        state: IndevState::Released,
+    };
+
+    fn write(self, data: &mut neo_lvgl_sys::lv_indev_data_t) {
+        data.point.x = self.point.x;
+        data.point.y = self.point.y;
+        data.state = self.state.to_raw();
+    }
+
+    fn state(&self) -> IndevState {
+        self.state
+    }
+}
+
+impl Sample for KeypadData {
+    const TYPE: IndevType = IndevType::Keypad;
+    const IDLE: Self = Self {
+        key: Key::Custom(0),
+        state: IndevState::Released,
+    };
+
+    fn write(self, data: &mut neo_lvgl_sys::lv_indev_data_t) {
+        data.key = self.key.to_raw();
+        data.state = self.state.to_raw();
+    }
+
+    fn state(&self) -> IndevState {
+        self.state
+    }
+}
+
+impl Sample for EncoderData {
+    const TYPE: IndevType = IndevType::Encoder;
+    const IDLE: Self = Self {
+        diff: 0,
+        state: IndevState::Released,
+    };
+
+    fn write(self, data: &mut neo_lvgl_sys::lv_indev_data_t) {
+        data.enc_diff = self.diff;
+        data.state = self.state.to_raw();
+    }
+
+    fn state(&self) -> IndevState {
+        self.state
+    }
+
+    fn held(self) -> Self {
+        // Steps are only counted once
+        Self { diff: 0, ..self }
+    }
+}
+
+/// Type-erased part of a [`SampleQueue`] linked into [`dispatch`]'s list
+struct EventSource {
+    indev: AtomicPtr<neo_lvgl_sys::lv_indev_t>,
+    /// Set by `push`, cleared by `dispatch`
+    pending: AtomicBool,
+    linked: AtomicBool,
+    next: AtomicPtr<EventSource>,
+    /// Read the owning queue empty
+    drain: unsafe fn(&EventSource),
+}
+
+/// Queues with an indev, walked by [`dispatch`]
+static SOURCES: AtomicPtr<EventSource> = AtomicPtr::new(ptr::null_mut());
+
+/// Input samples buffered from an interrupt for an event-driven [`Indev`]
+///
+/// [`push`](Self::push) is lock-free and may be called from interrupts and
+/// other threads. Size `N` for the samples that can arrive between two UI
+/// loop passes; pushes into a full queue fail.
+#[repr(C)]
+pub struct SampleQueue<T: Sample, const N: usize> {
+    // First, so an `&EventSource` is the queue's address
+    source: EventSource,
+    samples: UiQueue<T, N>,
+    /// Last sample given to LVGL
+    last: UnsafeCell<T>,
+}
+
+// SAFETY: `samples` is a lock-free queue and `last` is only accessed by the
+// LVGL thread from the read callback
+unsafe impl<T: Sample, const N: usize> Sync for SampleQueue<T, N> {}
+
+impl<T: Sample, const N: usize> SampleQueue<T, N> {
+    /// Create an empty queue with room for `N` samples
+    pub const fn new() -> Self {
+        Self {
+            source: EventSource {
+                indev: AtomicPtr::new(ptr::null_mut()),
+                pending: AtomicBool::new(false),
+                linked: AtomicBool::new(false),
+                next: AtomicPtr::new(ptr::null_mut()),
+                drain: drain_queue::<T, N>,
+            },
+            samples: UiQueue::new(),
+            last: UnsafeCell::new(T::IDLE),
+        }
+    }
+
+    /// Queue a sample and wake the UI loop.
+    ///
+    /// Returns the sample back if the queue is full.
+    pub fn push(&self, sample: T) -> Result<(), T> {
+        // Sample, then flag, then wake: a pass that clears the flag is
+        // guaranteed to find the sample
+        self.samples.enqueue(sample)?;
+        self.source.pending.store(true, Ordering::Release);
+        crate::runloop::wake();
+        Ok(())
+    }
+
+    /// Check if no samples are waiting
+    pub fn is_empty(&self) -> bool {
+        self.samples.is_empty()
+    }
+
+    /// Queue capacity
+    pub const fn capacity(&self) -> usize {
+        N
+    }
+}
+
+impl<T: Sample, const N: usize> Default for SampleQueue<T, N> {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+unsafe fn drain_queue<T: Sample, const N: usize>(source: &EventSource) {
+    let queue = &*(source as *const EventSource as *const SampleQueue<T, N>);
+    let indev = source.indev.load(Ordering::Acquire);
+    // `continue_reading` normally empties the queue in one read; the bound
+    // covers disabled devices and samples pushed meanwhile
+    for _ in 0..=N {
+        if indev.is_null() || queue.samples.is_empty() {
+            break;
+        }
+        neo_lvgl_sys::lv_indev_read(indev);
+    }
+}
+
+unsafe extern "C" fn event_read_cb<T: Sample, const N: usize>(
+    indev: *mut neo_lvgl_sys::lv_indev_t,
+    data: *mut neo_lvgl_sys::lv_indev_data_t,
+) {
+    let queue = &*(neo_lvgl_sys::lv_indev_get_driver_data(indev) as *const SampleQueue<T, N>);
+    let last = &mut *queue.last.get();
+    let data = &mut *data;
+    let sample = match queue.samples.pop() {
+        Some(sample) => {
+            data.continue_reading = !queue.samples.is_empty();
+            sample
+        }
+        None => last.held(),
+    };
+    sample.write(data);
+    *last = sample;
+
+    // Poll only while LVGL needs time to pass: long press and key repeat
+    // while held, scroll throw after release
+    let timer = neo_lvgl_sys::lv_indev_get_read_timer(indev);
+    if !timer.is_null() {
+        let scrolling = !neo_lvgl_sys::lv_indev_get_scroll_obj(indev).is_null();
+        if sample.state() == IndevState::Pressed || scrolling {
+            neo_lvgl_sys::lv_timer_resume(timer);
+        } else {
+            neo_lvgl_sys::lv_timer_pause(timer);
+        }
+    }
+}
+
+unsafe extern "C" fn event_indev_deleted_cb(e: *mut neo_lvgl_sys::lv_event_t) {
+    let source = &*(neo_lvgl_sys::lv_event_get_user_data(e) as *const EventSource);
+    source.indev.store(ptr::null_mut(), Ordering::Release);
+}
+
+impl Indev {
+    /// Create an event-driven input device reading samples from `queue`.
+    ///
+    /// LVGL reads the device when samples are dispatched instead of on a
+    /// timer. Returns `None` if `queue` already has a device.
+    pub fn new_event<T: Sample, const N: usize>(queue: &'static SampleQueue<T, N>) -> Option<Self> {
+        let source = &queue.source;
+        if !source.indev.load(Ordering::Acquire).is_null() {
+            return None;
+        }
+        let ptr = unsafe { neo_lvgl_sys::lv_indev_create() };
+        let indev = NonNull::new(ptr)?;
+
+        unsafe {
+            neo_lvgl_sys::lv_indev_set_type(ptr, T::TYPE.to_raw());
+            neo_lvgl_sys::lv_indev_set_read_cb(ptr, Some(event_read_cb::<T, N>));
+            neo_lvgl_sys::lv_indev_set_driver_data(ptr, queue as *const _ as *mut c_void);
+            neo_lvgl_sys::lv_indev_set_mode(ptr, neo_lvgl_sys::lv_indev_mode_t_LV_INDEV_MODE_EVENT);
+            neo_lvgl_sys::lv_indev_add_event_cb(
+                ptr,
+                Some(event_indev_deleted_cb),
+                neo_lvgl_sys::lv_event_code_t_LV_EVENT_DELETE,
+                source as *const EventSource as *mut c_void,
+            );
+        }
+        source.indev.store(ptr, Ordering::Release);
+        if !source.linked.swap(true, Ordering::AcqRel) {
+            let this = source as *const EventSource as *mut EventSource;
+            source
+                .next
+                .store(SOURCES.load(Ordering::Acquire), Ordering::Relaxed);
+            SOURCES.store(this, Ordering::Release);
+        }
+        // Samples pushed before the device existed
+        source.pending.store(true, Ordering::Release);
+
+        Some(Self { raw: indev })
+    }
+
+    /// Read the device now, e.g. after pushing samples outside the run loop
+    pub fn read(&self) {
+        unsafe {
+            neo_lvgl_sys::lv_indev_read(self.raw.as_ptr());
+        }
+    }
+}
+
+/// Feed queued samples of all event-driven devices to LVGL.
+///
+/// Called at the start of every [`runloop::run_until_idle`] pass. Loops
+/// that call `lv_timer_handler` themselves should call it first. Returns
+/// `true` if any device had samples. Must run on the LVGL thread.
+///
+/// [`runloop::run_until_idle`]: crate::runloop::run_until_idle
+pub fn dispatch() -> bool {
+    let mut any = false;
+    let mut source = SOURCES.load(Ordering::Acquire);
+    while let Some(current) = unsafe { source.as_ref() } {
+        if current.pending.swap(false, Ordering::AcqRel) {
+            any = true;
+            unsafe { (current.drain)(current) };
+        }
+        source = current.next.load(Ordering::Acquire);
+    }
+    any
+}
+
 // Closure support (requires alloc feature)
 #[cfg(feature = "alloc")]
 mod closure_support {
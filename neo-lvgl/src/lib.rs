@@ -6,8 +6,31 @@
 //! # Features
 //!
 //! - `alloc` - Enable closure-based event handlers (requires allocator)
+//! - `rust-alloc` - Route LVGL's heap to a Rust allocator, with per-screen
+//!   arenas (see [`mem`])
 //! - `widgets-core` - Core widgets (Button, Label, etc.) - enabled by default
-//! - `widgets-extra` - Additional widgets (Chart, Calendar, etc.)
+//! - `widgets-extra` - Additional widgets (Chart, Calendar, etc.), or pick them
+//!   one by one with `widget-*`
+//! - `font-montserrat-*` / `ttf` - Built-in font sizes and TinyTTF
+//! - `assets` - Convert PNG images, TTF font subsets and XML components at
+//!   compile time with [`include_image!`], [`include_font!`] and
+//!   [`include_ui!`] (see [`asset`])
+//! - `snapshot` - Render widgets into owned buffers and draw static subtrees
+//!   from a cached layer (see [`snapshot`])
+//! - `profiling` - Frame timings, callback costs, heap usage and Chrome/Perfetto
+//!   traces (see [`profiling`])
+//! - `bindgen` - Generate FFI bindings at build time (default); without it
+//!   pre-generated bindings are taken from `NEO_LVGL_BINDINGS_DIR`
+//! - `os-pthread` / `os-freertos` - Build LVGL with an OS backend (real locking,
+//!   multithreaded software rendering)
+//! - `simd-neon` / `simd-helium` / `simd-custom` / `arm2d` - Vectorized fill and
+//!   blend kernels for the target CPU; `fast-draw` builds them at `-O2`
+//! - `draw-pxp` / `draw-vglite` / `draw-dma2d` - Hardware draw units; custom
+//!   units can be added with [`draw::register_unit`]
+//!
+//! Only enabled widgets, fonts and draw backends are compiled into LVGL. Set
+//! `NEO_LVGL_COLOR_FORMAT` (e.g. `rgb565`) to build the software renderer for
+//! a single display format.
 //!
 //! # Example
 //!
@@ -34,23 +57,41 @@
 extern crate alloc;
 
 pub mod anim;
+#[cfg(feature = "assets")]
+pub mod asset;
 pub mod color;
 pub mod display;
+pub mod draw;
 pub mod event;
 pub mod font;
 pub mod fragment;
 pub mod group;
+pub mod image_cache;
 pub mod indev;
 pub mod layout;
+#[cfg(feature = "rust-alloc")]
+pub mod mem;
 pub mod observer;
+pub mod pixel;
 pub mod prelude;
+#[cfg(feature = "profiling")]
+pub mod profiling;
+pub mod runloop;
 pub mod scroll;
+#[cfg(feature = "snapshot")]
+pub mod snapshot;
 pub mod style;
 pub mod sync;
 pub mod timer;
 pub mod widgets;
 pub mod xml;
 
+#[cfg(feature = "assets")]
+#[doc(hidden)]
+pub mod __private {
+    pub use neo_lvgl_sys as sys;
+}
+
 /// Initialize LVGL.
 ///
 /// This must be called before any other LVGL functions.
@@ -69,7 +110,8 @@ pub fn is_initialized() -> bool {
 /// Increment LVGL tick counter.
 ///
 /// Call this periodically from your timer interrupt or main loop.
-/// LVGL uses this for animations and timing.
+/// LVGL uses this for animations and timing. For tickless idle register a
+/// clock with [`runloop::set_clock`] instead.
 ///
 /// # Arguments
 ///
@@ -88,7 +130,8 @@ pub fn tick_inc(ms: u32) {
 /// - Animation updates
 /// - Timer callbacks
 ///
-/// Returns the time in milliseconds until the next scheduled task.
+/// Returns the time in milliseconds until the next scheduled task. See
+/// [`runloop::run_until_idle`] for a loop that sleeps until then.
 pub fn task_handler() -> u32 {
     unsafe { neo_lvgl_sys::lv_timer_handler() }
 }
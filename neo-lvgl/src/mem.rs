@@ -0,0 +1,466 @@
+//! LVGL memory backend
+//!
+//! With the `rust-alloc` feature, LVGL's `lv_malloc`/`lv_realloc`/`lv_free`
+//! are served by a Rust [`GlobalAlloc`] instead of LVGL's fixed
+//! `LV_MEM_SIZE` pool, so LVGL and Rust share one heap. The Rust global
+//! allocator is used by default (`alloc` feature); [`set_allocator`] selects
+//! another one, e.g. a TLSF pool in internal RAM.
+//!
+//! [`Arena`] groups the LVGL allocations made while building a screen into
+//! bump-allocated chunks. Freeing a block inside an arena only drops a
+//! reference count, and all chunks are returned at once when the last block
+//! is freed (typically when the screen is deleted) and the arena handle is
+//! gone.
+//!
+//! # Example
+//!
+//! ```ignore
+//! use lvgl::mem::{self, Arena};
+//!
+//! static POOL: MyTlsf = MyTlsf::new();
+//! mem::set_allocator(&POOL).unwrap();
+//! lvgl::init();
+//!
+//! let screen = mem::with_arena(16 * 1024, || build_settings_screen())?;
+//! // ... later: deleting the screen releases the whole arena
+//! screen.delete();
+//! ```
+
+use core::alloc::{GlobalAlloc, Layout};
+use core::cell::UnsafeCell;
+use core::ffi::c_void;
+use core::ptr::{self, NonNull};
+use core::sync::atomic::{AtomicBool, AtomicPtr, AtomicUsize, Ordering};
+
+/// Alignment of every block handed to LVGL
+const ALIGN: usize = if core::mem::size_of::<usize>() > 4 {
+    16
+} else {
+    8
+};
+
+/// Size of the block header stored in front of each LVGL allocation
+const HEADER: usize = ALIGN;
+
+/// Error returned by memory configuration functions
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum MemError {
+    /// LVGL is already initialized; the allocator must be set before `lvgl::init()`
+    AlreadyInitialized,
+}
+
+/// Memory usage of LVGL allocations
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub struct MemStats {
+    /// Bytes currently allocated (including arena chunks)
+    pub used: usize,
+    /// Highest value of `used` so far
+    pub peak: usize,
+    /// Number of live blocks outside arenas
+    pub blocks: usize,
+}
+
+struct AllocatorSlot(UnsafeCell<Option<&'static dyn GlobalAlloc>>);
+
+// SAFETY: written only before lv_init(), read-only afterwards
+unsafe impl Sync for AllocatorSlot {}
+
+static ALLOCATOR: AllocatorSlot = AllocatorSlot(UnsafeCell::new(None));
+static CURRENT_ARENA: AtomicPtr<ArenaInner> = AtomicPtr::new(ptr::null_mut());
+static USED: AtomicUsize = AtomicUsize::new(0);
+static PEAK: AtomicUsize = AtomicUsize::new(0);
+static BLOCKS: AtomicUsize = AtomicUsize::new(0);
+
+/// Route LVGL's allocations to `allocator`.
+///
+/// Must be called before `lvgl::init()`.
+pub fn set_allocator(allocator: &'static dyn GlobalAlloc) -> Result<(), MemError> {
+    if unsafe { neo_lvgl_sys::lv_is_initialized() } {
+        return Err(MemError::AlreadyInitialized);
+    }
+    unsafe {
+        *ALLOCATOR.0.get() = Some(allocator);
+    }
+    Ok(())
+}
+
+/// Current LVGL memory usage
+pub fn stats() -> MemStats {
+    MemStats {
+        used: USED.load(Ordering::Relaxed),
+        peak: PEAK.load(Ordering::Relaxed),
+        blocks: BLOCKS.load(Ordering::Relaxed),
+    }
+}
+
+#[cfg(feature = "alloc")]
+struct RustGlobal;
+
+#[cfg(feature = "alloc")]
+unsafe impl GlobalAlloc for RustGlobal {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        alloc::alloc::alloc(layout)
+    }
+
+    unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+        alloc::alloc::dealloc(ptr, layout)
+    }
+
+    unsafe fn realloc(&self, ptr: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
+        alloc::alloc::realloc(ptr, layout, new_size)
+    }
+}
+
+fn backing() -> Option<&'static dyn GlobalAlloc> {
+    #[cfg(feature = "alloc")]
+    let default: Option<&'static dyn GlobalAlloc> = Some(&RustGlobal);
+    #[cfg(not(feature = "alloc"))]
+    let default: Option<&'static dyn GlobalAlloc> = None;
+
+    unsafe { *ALLOCATOR.0.get() }.or(default)
+}
+
+fn track_alloc(bytes: usize) {
+    let used = USED.fetch_add(bytes, Ordering::Relaxed) + bytes;
+    PEAK.fetch_max(used, Ordering::Relaxed);
+}
+
+fn track_free(bytes: usize) {
+    USED.fetch_sub(bytes, Ordering::Relaxed);
+}
+
+#[inline]
+const fn align_up(value: usize) -> usize {
+    (value + ALIGN - 1) & !(ALIGN - 1)
+}
+
+/// Header in front of every block; `owner` is null for heap blocks
+#[repr(C)]
+struct BlockHeader {
+    size: usize,
+    owner: *mut ArenaInner,
+}
+
+#[inline]
+unsafe fn header_of(p: *mut c_void) -> *mut BlockHeader {
+    (p as *mut u8).sub(HEADER) as *mut BlockHeader
+}
+
+#[inline]
+fn heap_layout(size: usize) -> Option<Layout> {
+    Layout::from_size_align(HEADER.checked_add(size)?, ALIGN).ok()
+}
+
+unsafe fn heap_alloc(size: usize) -> *mut c_void {
+    let (Some(allocator), Some(layout)) = (backing(), heap_layout(size)) else {
+        return ptr::null_mut();
+    };
+    let base = allocator.alloc(layout);
+    if base.is_null() {
+        return ptr::null_mut();
+    }
+    base.cast::<BlockHeader>().write(BlockHeader {
+        size,
+        owner: ptr::null_mut(),
+    });
+    track_alloc(layout.size());
+    BLOCKS.fetch_add(1, Ordering::Relaxed);
+    base.add(HEADER) as *mut c_void
+}
+
+/// A chunk of arena memory; the bump area follows the (padded) header
+#[repr(C)]
+struct Chunk {
+    next: *mut Chunk,
+    size: usize,
+}
+
+const CHUNK_HEADER: usize = align_up(core::mem::size_of::<Chunk>());
+
+struct BumpState {
+    chunks: *mut Chunk,
+    top: usize,
+    end: usize,
+}
+
+struct ArenaInner {
+    /// One reference for the `Arena` handle plus one per live block
+    refs: AtomicUsize,
+    lock: AtomicBool,
+    chunk_size: usize,
+    bump: UnsafeCell<BumpState>,
+}
+
+impl ArenaInner {
+    fn lock(&self) {
+        while self
+            .lock
+            .compare_exchange_weak(false, true, Ordering::Acquire, Ordering::Relaxed)
+            .is_err()
+        {
+            core::hint::spin_loop();
+        }
+    }
+
+    fn unlock(&self) {
+        self.lock.store(false, Ordering::Release);
+    }
+
+    /// Allocate a new chunk with room for at least `bytes`
+    unsafe fn new_chunk(&self, bytes: usize) -> *mut Chunk {
+        let Some(allocator) = backing() else {
+            return ptr::null_mut();
+        };
+        let Ok(layout) = Layout::from_size_align(CHUNK_HEADER + bytes, ALIGN) else {
+            return ptr::null_mut();
+        };
+        let chunk = allocator.alloc(layout) as *mut Chunk;
+        if !chunk.is_null() {
+            track_alloc(layout.size());
+            chunk.write(Chunk {
+                next: ptr::null_mut(),
+                size: bytes,
+            });
+        }
+        chunk
+    }
+
+    unsafe fn alloc(this: *mut ArenaInner, size: usize) -> *mut c_void {
+        let arena = &*this;
+        let need = HEADER + align_up(size);
+
+        arena.lock();
+        let bump = &mut *arena.bump.get();
+        let block = if bump.end - bump.top >= need {
+            let block = bump.top;
+            bump.top += need;
+            block as *mut u8
+        } else {
+            // Large blocks get a chunk of their own and keep the current one
+            let dedicated = need > arena.chunk_size / 2;
+            let chunk = arena.new_chunk(if dedicated { need } else { arena.chunk_size });
+            if chunk.is_null() {
+                arena.unlock();
+                return ptr::null_mut();
+            }
+            (*chunk).next = bump.chunks;
+            bump.chunks = chunk;
+            let start = chunk as usize + CHUNK_HEADER;
+            if !dedicated {
+                bump.top = start + need;
+                bump.end = start + arena.chunk_size;
+            }
+            start as *mut u8
+        };
+        arena.unlock();
+
+        arena.refs.fetch_add(1, Ordering::Relaxed);
+        block
+            .cast::<BlockHeader>()
+            .write(BlockHeader { size, owner: this });
+        block.add(HEADER) as *mut c_void
+    }
+
+    /// Drop one reference, freeing all chunks with the last one
+    unsafe fn release(this: *mut ArenaInner) {
+        if (*this).refs.fetch_sub(1, Ordering::AcqRel) != 1 {
+            return;
+        }
+        let Some(allocator) = backing() else {
+            return;
+        };
+        let mut chunk = (*(*this).bump.get()).chunks;
+        while !chunk.is_null() {
+            let next = (*chunk).next;
+            let layout = Layout::from_size_align_unchecked(CHUNK_HEADER + (*chunk).size, ALIGN);
+            track_free(layout.size());
+            allocator.dealloc(chunk as *mut u8, layout);
+            chunk = next;
+        }
+        allocator.dealloc(this as *mut u8, Layout::new::<ArenaInner>());
+    }
+}
+
+/// A bump arena for the LVGL allocations of one screen
+///
+/// While an [`ArenaScope`] is active, every `lv_malloc` is served from the
+/// arena. Blocks stay usable after the scope ends; the arena's memory is
+/// returned when the handle is dropped and every block has been freed.
+/// Reallocations after the scope (e.g. a label's text changing) move the
+/// block out of the arena, so a long-lived screen does not grow it.
+pub struct Arena {
+    inner: NonNull<ArenaInner>,
+}
+
+impl Arena {
+    /// Create an arena that allocates `chunk_size` byte chunks.
+    ///
+    /// Returns `None` if no allocator is available.
+    pub fn new(chunk_size: usize) -> Option<Self> {
+        let allocator = backing()?;
+        let chunk_size = align_up(chunk_size.max(4 * HEADER));
+        unsafe {
+            let inner = allocator.alloc(Layout::new::<ArenaInner>()) as *mut ArenaInner;
+            let inner = NonNull::new(inner)?;
+            inner.as_ptr().write(ArenaInner {
+                refs: AtomicUsize::new(1),
+                lock: AtomicBool::new(false),
+                chunk_size,
+                bump: UnsafeCell::new(BumpState {
+                    chunks: ptr::null_mut(),
+                    top: 0,
+                    end: 0,
+                }),
+            });
+            Some(Self { inner })
+        }
+    }
+
+    /// Serve LVGL allocations from this arena until the scope is dropped
+    pub fn enter(&self) -> ArenaScope<'_> {
+        let previous = CURRENT_ARENA.swap(self.inner.as_ptr(), Ordering::AcqRel);
+        ArenaScope {
+            _arena: self,
+            previous,
+        }
+    }
+
+    /// Number of LVGL blocks in this arena that have not been freed yet
+    pub fn live_blocks(&self) -> usize {
+        unsafe { self.inner.as_ref() }.refs.load(Ordering::Relaxed) - 1
+    }
+}
+
+impl Drop for Arena {
+    fn drop(&mut self) {
+        unsafe { ArenaInner::release(self.inner.as_ptr()) }
+    }
+}
+
+/// Guard returned by [`Arena::enter`]
+pub struct ArenaScope<'a> {
+    _arena: &'a Arena,
+    previous: *mut ArenaInner,
+}
+
+impl Drop for ArenaScope<'_> {
+    fn drop(&mut self) {
+        CURRENT_ARENA.store(self.previous, Ordering::Release);
+    }
+}
+
+/// Run `build` with LVGL allocations served from a new arena.
+///
+/// The arena is released once everything `build` allocated is freed, e.g.
+/// when the screen it created is deleted. Falls back to the heap if the
+/// arena cannot be created.
+pub fn with_arena<R>(chunk_size: usize, build: impl FnOnce() -> R) -> R {
+    match Arena::new(chunk_size) {
+        Some(arena) => {
+            let _scope = arena.enter();
+            build()
+        }
+        None => build(),
+    }
+}
+
+// LVGL's LV_STDLIB_CUSTOM memory core
+
+#[no_mangle]
+extern "C" fn lv_mem_init() {}
+
+#[no_mangle]
+extern "C" fn lv_mem_deinit() {}
+
+#[no_mangle]
+extern "C" fn lv_mem_add_pool(_mem: *mut c_void, _bytes: usize) -> neo_lvgl_sys::lv_mem_pool_t {
+    // Extra memory is added to the Rust allocator instead
+    ptr::null_mut()
+}
+
+#[no_mangle]
+extern "C" fn lv_mem_remove_pool(_pool: neo_lvgl_sys::lv_mem_pool_t) {}
+
+#[no_mangle]
+unsafe extern "C" fn lv_malloc_core(size: usize) -> *mut c_void {
+    let arena = CURRENT_ARENA.load(Ordering::Acquire);
+    if arena.is_null() {
+        heap_alloc(size)
+    } else {
+        ArenaInner::alloc(arena, size)
+    }
+}
+
+#[no_mangle]
+unsafe extern "C" fn lv_realloc_core(p: *mut c_void, new_size: usize) -> *mut c_void {
+    if p.is_null() {
+        return lv_malloc_core(new_size);
+    }
+    let header = header_of(p);
+    let old_size = (*header).size;
+
+    if (*header).owner.is_null() {
+        let (Some(allocator), Some(old), Some(new)) =
+            (backing(), heap_layout(old_size), heap_layout(new_size))
+        else {
+            return ptr::null_mut();
+        };
+        let base = allocator.realloc(header as *mut u8, old, new.size());
+        if base.is_null() {
+            return ptr::null_mut();
+        }
+        track_free(old.size());
+        track_alloc(new.size());
+        (*(base as *mut BlockHeader)).size = new_size;
+        return base.add(HEADER) as *mut c_void;
+    }
+
+    // Arena blocks can't grow in place; move to wherever new blocks go now
+    let new = lv_malloc_core(new_size);
+    if !new.is_null() {
+        ptr::copy_nonoverlapping(p as *const u8, new as *mut u8, old_size.min(new_size));
+        lv_free_core(p);
+    }
+    new
+}
+
+#[no_mangle]
+unsafe extern "C" fn lv_free_core(p: *mut c_void) {
+    if p.is_null() {
+        return;
+    }
+    let header = header_of(p);
+    let owner = (*header).owner;
+    if !owner.is_null() {
+        ArenaInner::release(owner);
+        return;
+    }
+
+    let (Some(allocator), Some(layout)) = (backing(), heap_layout((*header).size)) else {
+        return;
+    };
+    track_free(layout.size());
+    BLOCKS.fetch_sub(1, Ordering::Relaxed);
+    allocator.dealloc(header as *mut u8, layout);
+}
+
+/// Reports block count and peak use
+///
+/// A [`GlobalAlloc`] does not tell its capacity or free space, so the size,
+/// free, percentage and fragmentation fields stay zero. Use [`stats`] for
+/// the bytes in use.
+#[no_mangle]
+unsafe extern "C" fn lv_mem_monitor_core(mon_p: *mut neo_lvgl_sys::lv_mem_monitor_t) {
+    let Some(mon) = mon_p.as_mut() else {
+        return;
+    };
+    let stats = stats();
+    *mon = core::mem::zeroed();
+    mon.used_cnt = stats.blocks as _;
+    mon.max_used = stats.peak;
+}
+
+#[no_mangle]
+extern "C" fn lv_mem_test_core() -> neo_lvgl_sys::lv_result_t {
+    neo_lvgl_sys::lv_result_t_LV_RESULT_OK
+}
@@ -22,12 +22,30 @@
 //!
 //! // When you update the subject, all bound widgets update automatically
 //! temperature.set(30);
+//!
+//! // For high-rate data, notify at most once per refresh period
+//! temperature.set_deferred(31);
 //! ```
+//!
+//! # Address stability
+//!
+//! LVGL's observers keep pointers to their subject, so each subject's
+//! `lv_subject_t` is allocated from the LVGL heap and never moves, even when
+//! the Rust value does. LVGL must be initialized before creating subjects.
+//!
+//! # Deferred notification
+//!
+//! `set_deferred()` stores the value and marks the subject dirty. One LVGL
+//! timer running at the display refresh period (`LV_DEF_REFR_PERIOD`)
+//! then notifies each dirty subject once with its latest value, so bound
+//! widgets redraw at display rate rather than sample rate. The timer is
+//! paused while nothing is dirty. Deferred setters must be called from the
+//! LVGL thread, like all other LVGL calls.
 
 use crate::color::Color;
-use core::ffi::CStr;
-use core::mem::MaybeUninit;
-use core::ptr::NonNull;
+use core::ffi::{c_void, CStr};
+use core::ptr::{self, NonNull};
+use core::sync::atomic::{AtomicPtr, Ordering};
 
 /// Observer handle
 ///
@@ -76,69 +94,218 @@ pub trait Subject {
     }
 }
 
+/// Value waiting for a deferred notification
+#[derive(Clone, Copy)]
+enum Pending {
+    /// Notify without changing the value
+    Notify,
+    Int(i32),
+    Pointer(*mut c_void),
+    Color(neo_lvgl_sys::lv_color_t),
+}
+
+/// A subject in the LVGL heap, with deferred notification state
+///
+/// `subject` is the first field, so a cell pointer is also a subject pointer.
+#[repr(C)]
+struct SubjectCell {
+    subject: neo_lvgl_sys::lv_subject_t,
+    pending: Pending,
+    dirty: bool,
+    next_dirty: *mut SubjectCell,
+}
+
+/// Subjects waiting for notification, linked through `next_dirty`
+static DIRTY: AtomicPtr<SubjectCell> = AtomicPtr::new(ptr::null_mut());
+/// The rest of the list being notified by [`flush_deferred`]
+static FLUSHING: AtomicPtr<SubjectCell> = AtomicPtr::new(ptr::null_mut());
+static FLUSH_TIMER: AtomicPtr<neo_lvgl_sys::lv_timer_t> = AtomicPtr::new(ptr::null_mut());
+
+impl SubjectCell {
+    /// Allocate a cell and initialize its subject with `init`
+    fn new(init: impl FnOnce(*mut neo_lvgl_sys::lv_subject_t)) -> NonNull<Self> {
+        unsafe {
+            let cell = neo_lvgl_sys::lv_malloc(core::mem::size_of::<Self>()) as *mut Self;
+            let cell = NonNull::new(cell).expect("lv_malloc failed for subject");
+            ptr::write_bytes(cell.as_ptr(), 0, 1);
+            (*cell.as_ptr()).pending = Pending::Notify;
+            init(cell.as_ptr().cast());
+            cell
+        }
+    }
+
+    /// Store `pending` and schedule a notification
+    unsafe fn defer(cell: *mut Self, pending: Pending) {
+        (*cell).pending = pending;
+        if (*cell).dirty {
+            return;
+        }
+        (*cell).dirty = true;
+        (*cell).next_dirty = DIRTY.load(Ordering::Relaxed);
+        DIRTY.store(cell, Ordering::Relaxed);
+
+        let mut timer = FLUSH_TIMER.load(Ordering::Relaxed);
+        if timer.is_null() {
+            timer = neo_lvgl_sys::lv_timer_create(
+                Some(flush_timer_cb),
+                neo_lvgl_sys::LV_DEF_REFR_PERIOD,
+                ptr::null_mut(),
+            );
+            FLUSH_TIMER.store(timer, Ordering::Relaxed);
+        }
+        if !timer.is_null() {
+            neo_lvgl_sys::lv_timer_resume(timer);
+        }
+    }
+
+    /// Apply the pending value, notifying observers
+    unsafe fn flush(cell: *mut Self) {
+        (*cell).dirty = false;
+        (*cell).next_dirty = ptr::null_mut();
+        let subject = cell.cast();
+        match core::mem::replace(&mut (*cell).pending, Pending::Notify) {
+            Pending::Notify => neo_lvgl_sys::lv_subject_notify(subject),
+            Pending::Int(value) => neo_lvgl_sys::lv_subject_set_int(subject, value),
+            Pending::Pointer(value) => neo_lvgl_sys::lv_subject_set_pointer(subject, value),
+            Pending::Color(value) => neo_lvgl_sys::lv_subject_set_color(subject, value),
+        }
+    }
+
+    /// Drop a pending deferred value, before the subject is set directly
+    unsafe fn cancel(cell: *mut Self) {
+        if !(*cell).dirty {
+            return;
+        }
+        for list in [&DIRTY, &FLUSHING] {
+            let mut link = list.as_ptr();
+            while !(*link).is_null() {
+                if *link == cell {
+                    *link = (*cell).next_dirty;
+                    break;
+                }
+                link = &mut (**link).next_dirty;
+            }
+        }
+        (*cell).dirty = false;
+        (*cell).next_dirty = ptr::null_mut();
+        (*cell).pending = Pending::Notify;
+    }
+
+    /// Unlink from the dirty list, deinitialize and free
+    unsafe fn free(cell: NonNull<Self>) {
+        let cell = cell.as_ptr();
+        Self::cancel(cell);
+        neo_lvgl_sys::lv_subject_deinit(cell.cast());
+        neo_lvgl_sys::lv_free(cell.cast());
+    }
+}
+
+unsafe extern "C" fn flush_timer_cb(timer: *mut neo_lvgl_sys::lv_timer_t) {
+    // Subjects deferred by observers during the flush resume the timer
+    neo_lvgl_sys::lv_timer_pause(timer);
+    flush_deferred();
+}
+
+/// Notify all subjects with deferred changes now
+///
+/// Subjects deferred again by observers during the flush are notified on
+/// the next one.
+pub fn flush_deferred() {
+    FLUSHING.store(
+        DIRTY.swap(ptr::null_mut(), Ordering::Relaxed),
+        Ordering::Relaxed,
+    );
+    loop {
+        // Popped one at a time so observers may drop subjects still queued
+        let cell = FLUSHING.load(Ordering::Relaxed);
+        if cell.is_null() {
+            break;
+        }
+        unsafe {
+            FLUSHING.store((*cell).next_dirty, Ordering::Relaxed);
+            SubjectCell::flush(cell);
+        }
+    }
+}
+
 /// Integer subject for reactive integer values
 ///
 /// Use this to create reactive integer data that can be bound to widgets
 /// like sliders, bars, arcs, etc.
 pub struct IntSubject {
-    raw: neo_lvgl_sys::lv_subject_t,
+    cell: NonNull<SubjectCell>,
 }
 
 impl IntSubject {
     /// Create a new integer subject with an initial value
     pub fn new(initial_value: i32) -> Self {
-        let mut raw = MaybeUninit::<neo_lvgl_sys::lv_subject_t>::uninit();
-        unsafe {
-            neo_lvgl_sys::lv_subject_init_int(raw.as_mut_ptr(), initial_value);
-            Self {
-                raw: raw.assume_init(),
-            }
+        Self {
+            cell: SubjectCell::new(|raw| unsafe {
+                neo_lvgl_sys::lv_subject_init_int(raw, initial_value)
+            }),
         }
     }
 
     /// Set the current value (notifies all observers)
+    ///
+    /// Replaces a value set with [`set_deferred`](Self::set_deferred) that
+    /// has not been notified yet.
     pub fn set(&mut self, value: i32) {
         unsafe {
-            neo_lvgl_sys::lv_subject_set_int(&mut self.raw, value);
+            SubjectCell::cancel(self.cell.as_ptr());
+            neo_lvgl_sys::lv_subject_set_int(self.raw(), value);
         }
     }
 
+    /// Set the value, notifying observers once at the next refresh period
+    ///
+    /// Repeated calls before then only keep the last value.
+    pub fn set_deferred(&mut self, value: i32) {
+        unsafe { SubjectCell::defer(self.cell.as_ptr(), Pending::Int(value)) }
+    }
+
     /// Get the current value
+    ///
+    /// Includes a value set with [`set_deferred`](Self::set_deferred) that
+    /// has not been notified yet.
     pub fn get(&mut self) -> i32 {
-        unsafe { neo_lvgl_sys::lv_subject_get_int(&mut self.raw) }
+        unsafe {
+            match (*self.cell.as_ptr()).pending {
+                Pending::Int(value) if (*self.cell.as_ptr()).dirty => value,
+                _ => neo_lvgl_sys::lv_subject_get_int(self.raw()),
+            }
+        }
     }
 
     /// Get the previous value (before the last change)
     pub fn previous(&mut self) -> i32 {
-        unsafe { neo_lvgl_sys::lv_subject_get_previous_int(&mut self.raw) }
+        unsafe { neo_lvgl_sys::lv_subject_get_previous_int(self.raw()) }
     }
 
     /// Set the minimum allowed value
     pub fn set_min(&mut self, min: i32) {
         unsafe {
-            neo_lvgl_sys::lv_subject_set_min_value_int(&mut self.raw, min);
+            neo_lvgl_sys::lv_subject_set_min_value_int(self.raw(), min);
         }
     }
 
     /// Set the maximum allowed value
     pub fn set_max(&mut self, max: i32) {
         unsafe {
-            neo_lvgl_sys::lv_subject_set_max_value_int(&mut self.raw, max);
+            neo_lvgl_sys::lv_subject_set_max_value_int(self.raw(), max);
         }
     }
 }
 
 impl Subject for IntSubject {
     fn raw(&mut self) -> *mut neo_lvgl_sys::lv_subject_t {
-        &mut self.raw
+        self.cell.as_ptr().cast()
     }
 }
 
 impl Drop for IntSubject {
     fn drop(&mut self) {
-        unsafe {
-            neo_lvgl_sys::lv_subject_deinit(&mut self.raw);
-        }
+        unsafe { SubjectCell::free(self.cell) }
     }
 }
 
@@ -147,7 +314,7 @@ impl Drop for IntSubject {
 /// Use this to create reactive string data that can be bound to labels.
 /// The subject owns a buffer for the string data.
 pub struct StringSubject {
-    raw: neo_lvgl_sys::lv_subject_t,
+    cell: NonNull<SubjectCell>,
 }
 
 impl StringSubject {
@@ -168,34 +335,41 @@ impl StringSubject {
         prev_buf: Option<&'static mut [u8]>,
         initial: &CStr,
     ) -> Self {
-        let mut raw = MaybeUninit::<neo_lvgl_sys::lv_subject_t>::uninit();
         let prev_ptr = prev_buf
             .map(|b| b.as_mut_ptr().cast())
             .unwrap_or(core::ptr::null_mut());
 
-        neo_lvgl_sys::lv_subject_init_string(
-            raw.as_mut_ptr(),
-            buf.as_mut_ptr().cast(),
-            prev_ptr,
-            buf.len(),
-            initial.as_ptr().cast(),
-        );
-
         Self {
-            raw: raw.assume_init(),
+            cell: SubjectCell::new(|raw| {
+                neo_lvgl_sys::lv_subject_init_string(
+                    raw,
+                    buf.as_mut_ptr().cast(),
+                    prev_ptr,
+                    buf.len(),
+                    initial.as_ptr().cast(),
+                )
+            }),
         }
     }
 
     /// Set the string value (copies the string, notifies observers)
     pub fn set(&mut self, value: &CStr) {
         unsafe {
-            neo_lvgl_sys::lv_subject_copy_string(&mut self.raw, value.as_ptr().cast());
+            SubjectCell::cancel(self.cell.as_ptr());
+            neo_lvgl_sys::lv_subject_copy_string(self.raw(), value.as_ptr().cast());
         }
     }
 
+    /// Notify observers once at the next refresh period
+    ///
+    /// Use after updating the string buffer in place.
+    pub fn notify_deferred(&mut self) {
+        unsafe { SubjectCell::defer(self.cell.as_ptr(), Pending::Notify) }
+    }
+
     /// Get the current string value
     pub fn get(&mut self) -> Option<&CStr> {
-        let ptr = unsafe { neo_lvgl_sys::lv_subject_get_string(&mut self.raw) };
+        let ptr = unsafe { neo_lvgl_sys::lv_subject_get_string(self.raw()) };
         if ptr.is_null() {
             None
         } else {
@@ -205,7 +379,7 @@ impl StringSubject {
 
     /// Get the previous string value
     pub fn previous(&mut self) -> Option<&CStr> {
-        let ptr = unsafe { neo_lvgl_sys::lv_subject_get_previous_string(&mut self.raw) };
+        let ptr = unsafe { neo_lvgl_sys::lv_subject_get_previous_string(self.raw()) };
         if ptr.is_null() {
             None
         } else {
@@ -216,15 +390,13 @@ impl StringSubject {
 
 impl Subject for StringSubject {
     fn raw(&mut self) -> *mut neo_lvgl_sys::lv_subject_t {
-        &mut self.raw
+        self.cell.as_ptr().cast()
     }
 }
 
 impl Drop for StringSubject {
     fn drop(&mut self) {
-        unsafe {
-            neo_lvgl_sys::lv_subject_deinit(&mut self.raw);
-        }
+        unsafe { SubjectCell::free(self.cell) }
     }
 }
 
@@ -232,99 +404,103 @@ impl Drop for StringSubject {
 ///
 /// Use this to store and observe changes to arbitrary pointer data.
 pub struct PointerSubject {
-    raw: neo_lvgl_sys::lv_subject_t,
+    cell: NonNull<SubjectCell>,
 }
 
 impl PointerSubject {
     /// Create a new pointer subject
     pub fn new(initial: *mut core::ffi::c_void) -> Self {
-        let mut raw = MaybeUninit::<neo_lvgl_sys::lv_subject_t>::uninit();
-        unsafe {
-            neo_lvgl_sys::lv_subject_init_pointer(raw.as_mut_ptr(), initial);
-            Self {
-                raw: raw.assume_init(),
-            }
+        Self {
+            cell: SubjectCell::new(|raw| unsafe {
+                neo_lvgl_sys::lv_subject_init_pointer(raw, initial)
+            }),
         }
     }
 
-    /// Set the pointer value
+    /// Set the pointer value, replacing a pending deferred one
     pub fn set(&mut self, ptr: *mut core::ffi::c_void) {
         unsafe {
-            neo_lvgl_sys::lv_subject_set_pointer(&mut self.raw, ptr);
+            SubjectCell::cancel(self.cell.as_ptr());
+            neo_lvgl_sys::lv_subject_set_pointer(self.raw(), ptr);
         }
     }
 
+    /// Set the pointer value, notifying observers at the next refresh period
+    pub fn set_deferred(&mut self, ptr: *mut core::ffi::c_void) {
+        unsafe { SubjectCell::defer(self.cell.as_ptr(), Pending::Pointer(ptr)) }
+    }
+
     /// Get the current pointer value
     pub fn get(&mut self) -> *const core::ffi::c_void {
-        unsafe { neo_lvgl_sys::lv_subject_get_pointer(&mut self.raw) }
+        unsafe { neo_lvgl_sys::lv_subject_get_pointer(self.raw()) }
     }
 
     /// Get the previous pointer value
     pub fn previous(&mut self) -> *const core::ffi::c_void {
-        unsafe { neo_lvgl_sys::lv_subject_get_previous_pointer(&mut self.raw) }
+        unsafe { neo_lvgl_sys::lv_subject_get_previous_pointer(self.raw()) }
     }
 }
 
 impl Subject for PointerSubject {
     fn raw(&mut self) -> *mut neo_lvgl_sys::lv_subject_t {
-        &mut self.raw
+        self.cell.as_ptr().cast()
     }
 }
 
 impl Drop for PointerSubject {
     fn drop(&mut self) {
-        unsafe {
-            neo_lvgl_sys::lv_subject_deinit(&mut self.raw);
-        }
+        unsafe { SubjectCell::free(self.cell) }
     }
 }
 
 /// Color subject for reactive color values
 pub struct ColorSubject {
-    raw: neo_lvgl_sys::lv_subject_t,
+    cell: NonNull<SubjectCell>,
 }
 
 impl ColorSubject {
     /// Create a new color subject
     pub fn new(initial: Color) -> Self {
-        let mut raw = MaybeUninit::<neo_lvgl_sys::lv_subject_t>::uninit();
-        unsafe {
-            neo_lvgl_sys::lv_subject_init_color(raw.as_mut_ptr(), initial.to_raw());
-            Self {
-                raw: raw.assume_init(),
-            }
+        Self {
+            cell: SubjectCell::new(|raw| unsafe {
+                neo_lvgl_sys::lv_subject_init_color(raw, initial.to_raw())
+            }),
         }
     }
 
-    /// Set the color value
+    /// Set the color value, replacing a pending deferred one
     pub fn set(&mut self, color: Color) {
         unsafe {
-            neo_lvgl_sys::lv_subject_set_color(&mut self.raw, color.to_raw());
+            SubjectCell::cancel(self.cell.as_ptr());
+            neo_lvgl_sys::lv_subject_set_color(self.raw(), color.to_raw());
         }
     }
 
+    /// Set the color value, notifying observers at the next refresh period
+    pub fn set_deferred(&mut self, color: Color) {
+        unsafe { SubjectCell::defer(self.cell.as_ptr(), Pending::Color(color.to_raw())) }
+    }
+
     /// Get the current color value
     pub fn get(&mut self) -> Color {
-        unsafe { Color::from_raw(neo_lvgl_sys::lv_subject_get_color(&mut self.raw)) }
+        unsafe { Color::from_raw(neo_lvgl_sys::lv_subject_get_color(self.raw())) }
     }
 
     /// Get the previous color value
     pub fn previous(&mut self) -> Color {
-        unsafe { Color::from_raw(neo_lvgl_sys::lv_subject_get_previous_color(&mut self.raw)) }
+        unsafe { Color::from_raw(neo_lvgl_sys::lv_subject_get_previous_color(self.raw())) }
     }
 }
 
 impl Subject for ColorSubject {
     fn raw(&mut self) -> *mut neo_lvgl_sys::lv_subject_t {
-        &mut self.raw
+        self.cell.as_ptr().cast()
     }
 }
 
 impl Drop for ColorSubject {
     fn drop(&mut self) {
-        unsafe {
-            neo_lvgl_sys::lv_subject_deinit(&mut self.raw);
-        }
+        unsafe { SubjectCell::free(self.cell) }
     }
 }
 
@@ -343,3 +519,25 @@ impl<'a, T: crate::widgets::Widget<'a>> ObserverBindExt<'a> for T {}
 
 // Widget-specific bindings are implemented in their respective modules
 // Here we provide the core observer infrastructure
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_set_replaces_deferred_value() {
+        crate::init();
+        let mut subject = IntSubject::new(0);
+        subject.set_deferred(1);
+        subject.set(2);
+        assert_eq!(subject.get(), 2);
+
+        flush_deferred();
+        assert_eq!(subject.get(), 2);
+
+        // Deferring after a direct set still applies
+        subject.set_deferred(3);
+        flush_deferred();
+        assert_eq!(subject.get(), 3);
+    }
+}
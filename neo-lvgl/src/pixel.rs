@@ -0,0 +1,220 @@
+//! Typed pixel formats
+//!
+//! Pixel types matching LVGL's color formats. Drivers and buffers that know
+//! their format at compile time can work on `&[Rgb565]` or `&[Xrgb8888]`
+//! instead of raw bytes. [`convert`] and [`map_indexed`] transform whole
+//! rows between formats.
+//!
+//! # Example
+//!
+//! ```ignore
+//! use lvgl::pixel::{Pixel, Rgb565};
+//! use lvgl::color::Color;
+//!
+//! let px = Rgb565::from(Color::hex(0xFF8000));
+//! assert_eq!(Rgb565::FORMAT, ColorFormat::Rgb565);
+//! ```
+
+use crate::color::Color;
+use crate::display::ColorFormat;
+
+/// A pixel type with a fixed LVGL color format
+///
+/// # Safety
+///
+/// Implementors must have exactly the size and memory layout of one pixel of
+/// `FORMAT`, so that LVGL draw buffers can be reinterpreted as `[Self]`.
+pub unsafe trait Pixel: Copy + 'static {
+    /// The LVGL color format of this pixel type
+    const FORMAT: ColorFormat;
+
+    /// Number of bytes per pixel
+    const BYTES_PER_PIXEL: usize = core::mem::size_of::<Self>();
+}
+
+/// 16-bit RGB (5-6-5) pixel
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+#[repr(transparent)]
+pub struct Rgb565(pub u16);
+
+impl Rgb565 {
+    /// Create from 8-bit RGB components
+    #[inline]
+    pub const fn new(r: u8, g: u8, b: u8) -> Self {
+        Self((((r as u16) >> 3) << 11) | (((g as u16) >> 2) << 5) | ((b as u16) >> 3))
+    }
+
+    /// Convert to the byte-swapped variant (e.g. for SPI panels)
+    #[inline]
+    pub const fn swapped(self) -> Rgb565Swapped {
+        Rgb565Swapped(self.0.swap_bytes())
+    }
+}
+
+/// 16-bit RGB (5-6-5) pixel with swapped bytes
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+#[repr(transparent)]
+pub struct Rgb565Swapped(pub u16);
+
+/// 24-bit RGB (8-8-8) pixel, stored in LVGL's B, G, R byte order
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+#[repr(C)]
+pub struct Rgb888 {
+    pub b: u8,
+    pub g: u8,
+    pub r: u8,
+}
+
+/// 32-bit ARGB (8-8-8-8) pixel
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+#[repr(transparent)]
+pub struct Argb8888(pub u32);
+
+/// 32-bit XRGB (8-8-8-8) pixel, alpha ignored
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+#[repr(transparent)]
+pub struct Xrgb8888(pub u32);
+
+/// 8-bit grayscale pixel
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+#[repr(transparent)]
+pub struct L8(pub u8);
+
+unsafe impl Pixel for Rgb565 {
+    const FORMAT: ColorFormat = ColorFormat::Rgb565;
+}
+
+unsafe impl Pixel for Rgb565Swapped {
+    const FORMAT: ColorFormat = ColorFormat::Rgb565Swapped;
+}
+
+unsafe impl Pixel for Rgb888 {
+    const FORMAT: ColorFormat = ColorFormat::Rgb888;
+}
+
+unsafe impl Pixel for Argb8888 {
+    const FORMAT: ColorFormat = ColorFormat::Argb8888;
+}
+
+unsafe impl Pixel for Xrgb8888 {
+    const FORMAT: ColorFormat = ColorFormat::Xrgb8888;
+}
+
+unsafe impl Pixel for L8 {
+    const FORMAT: ColorFormat = ColorFormat::L8;
+}
+
+impl From<Color> for Rgb565 {
+    #[inline]
+    fn from(color: Color) -> Self {
+        let raw = color.raw();
+        Self::new(raw.red, raw.green, raw.blue)
+    }
+}
+
+impl From<Color> for Rgb565Swapped {
+    #[inline]
+    fn from(color: Color) -> Self {
+        Rgb565::from(color).swapped()
+    }
+}
+
+impl From<Color> for Rgb888 {
+    #[inline]
+    fn from(color: Color) -> Self {
+        let raw = color.raw();
+        Self {
+            b: raw.blue,
+            g: raw.green,
+            r: raw.red,
+        }
+    }
+}
+
+impl From<Color> for Argb8888 {
+    #[inline]
+    fn from(color: Color) -> Self {
+        let raw = color.raw();
+        Self(0xFF00_0000 | ((raw.red as u32) << 16) | ((raw.green as u32) << 8) | raw.blue as u32)
+    }
+}
+
+impl From<Color> for Xrgb8888 {
+    #[inline]
+    fn from(color: Color) -> Self {
+        Self(Argb8888::from(color).0)
+    }
+}
+
+impl From<Argb8888> for Rgb565 {
+    #[inline]
+    fn from(px: Argb8888) -> Self {
+        let v = px.0;
+        Self((((v >> 8) & 0xF800) | ((v >> 5) & 0x07E0) | ((v >> 3) & 0x001F)) as u16)
+    }
+}
+
+impl From<Xrgb8888> for Rgb565 {
+    #[inline]
+    fn from(px: Xrgb8888) -> Self {
+        Self::from(Argb8888(px.0))
+    }
+}
+
+impl From<Rgb888> for Rgb565 {
+    #[inline]
+    fn from(px: Rgb888) -> Self {
+        Self::new(px.r, px.g, px.b)
+    }
+}
+
+impl From<L8> for Rgb565 {
+    #[inline]
+    fn from(px: L8) -> Self {
+        Self::new(px.0, px.0, px.0)
+    }
+}
+
+impl From<Rgb565> for Xrgb8888 {
+    #[inline]
+    fn from(px: Rgb565) -> Self {
+        // Replicate the high bits so white stays 0xFFFFFF
+        let v = px.0 as u32;
+        let r = (v >> 11) & 0x1F;
+        let g = (v >> 5) & 0x3F;
+        let b = v & 0x1F;
+        let r = (r << 3) | (r >> 2);
+        let g = (g << 2) | (g >> 4);
+        let b = (b << 3) | (b >> 2);
+        Self(0xFF00_0000 | (r << 16) | (g << 8) | b)
+    }
+}
+
+impl From<Rgb565> for Argb8888 {
+    #[inline]
+    fn from(px: Rgb565) -> Self {
+        Self(Xrgb8888::from(px).0)
+    }
+}
+
+/// Convert a row of pixels from one format to another.
+///
+/// Converts `min(src.len(), dst.len())` pixels. The loop has no branches or
+/// bounds checks, so it vectorizes for the target's SIMD width.
+#[inline]
+pub fn convert<S: Pixel, D: Pixel + From<S>>(src: &[S], dst: &mut [D]) {
+    for (d, s) in dst.iter_mut().zip(src) {
+        *d = D::from(*s);
+    }
+}
+
+/// Map 8-bit indices through a 256-entry palette (colormaps, heatmaps).
+///
+/// Maps `min(indices.len(), dst.len())` pixels; a full palette makes every
+/// index valid, so the lookup needs no bounds check.
+#[inline]
+pub fn map_indexed<P: Pixel>(indices: &[u8], palette: &[P; 256], dst: &mut [P]) {
+    for (d, &i) in dst.iter_mut().zip(indices) {
+        *d = palette[i as usize];
+    }
+}
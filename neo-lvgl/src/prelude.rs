@@ -15,10 +15,12 @@
 
 // Core types
 pub use crate::color::Color;
-pub use crate::display::{Area, ColorFormat, Display, DisplayDriver, RenderMode};
+pub use crate::display::{
+    Area, ColorFormat, Display, DisplayDriver, FlushToken, RenderMode, TypedDisplayDriver,
+};
 #[cfg(feature = "alloc")]
-pub use crate::display::ManagedDisplay;
-pub use crate::style::{Style, StyleSelector};
+pub use crate::display::{ManagedDisplay, TypedDisplay};
+pub use crate::style::{ConstStyle, Style, StyleSelector};
 
 // Widgets
 pub use crate::widgets::{Obj, Widget};
@@ -41,7 +43,7 @@ pub use crate::layout::{Direction, FlexAlign, FlexFlow, GridAlign};
 pub use crate::scroll::{ScrollSnap, ScrollbarMode};
 
 // Animation
-pub use crate::anim::{Anim, AnimHandle, AnimPath, RepeatCount};
+pub use crate::anim::{Anim, AnimHandle, AnimPath, AnimProperty, AnimTimeline, RepeatCount};
 
 // Observer/binding
 pub use crate::observer::{IntSubject, Observer, Subject};
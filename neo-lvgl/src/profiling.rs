@@ -0,0 +1,504 @@
+//! Frame timings, callback costs and heap usage
+//!
+//! [`attach`] a display to time each of its refreshes: layout, rendering
+//! and flushing are measured from LVGL's display events. The closures
+//! behind [`event`](crate::event), [`timer`](crate::timer) and
+//! [`anim`](crate::anim) callbacks are counted and timed by their
+//! trampolines. Results are delivered per frame to [`set_frame_cb`],
+//! periodically as a [`Report`] to [`set_report_cb`], or on demand with
+//! [`report`].
+//!
+//! Times come from [`Clock::now_us`](crate::runloop::Clock::now_us) of the
+//! clock registered with [`runloop::set_clock`](crate::runloop::set_clock);
+//! its default resolution of one millisecond and LVGL's tick, used without a
+//! clock, are too coarse for single frames.
+//!
+//! # Traces
+//!
+//! [`start_trace`] turns on LVGL's builtin profiler. The begin and end of
+//! LVGL's refresh, layout and draw steps and of the Rust callbacks above are
+//! streamed to a sink in systrace text, which `chrome://tracing` and
+//! Perfetto (<https://ui.perfetto.dev>) open as a timeline.
+//!
+//! # Example
+//!
+//! ```ignore
+//! use lvgl::profiling::{self, Report};
+//! use lvgl::runloop::{self, Clock};
+//!
+//! struct Cycles;
+//! impl Clock for Cycles {
+//!     fn now_ms() -> u32 {
+//!         (Self::now_us() / 1000) as u32
+//!     }
+//!     fn now_us() -> u64 {
+//!         dwt_cycles() / CPU_MHZ
+//!     }
+//! }
+//!
+//! fn print(report: &Report) {
+//!     defmt::info!(
+//!         "{} fps, cpu {}%, render {} us, heap peak {}",
+//!         report.fps,
+//!         report.cpu_pct,
+//!         report.avg.render_us,
+//!         report.mem.peak,
+//!     );
+//! }
+//!
+//! runloop::set_clock::<Cycles>();
+//! profiling::attach(display.display());
+//! profiling::set_report_cb(1000, Some(print));
+//!
+//! profiling::start_trace(16 * 1024, |chunk| uart_write(chunk.to_bytes()));
+//! ```
+
+use core::cell::UnsafeCell;
+use core::ffi::{c_char, CStr};
+use core::ptr;
+use core::sync::atomic::{AtomicPtr, Ordering};
+
+use crate::display::Display;
+use crate::runloop::now_us;
+
+/// Timings of one display refresh, in microseconds
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub struct FrameTiming {
+    /// Before rendering: layout updates and joining invalidated areas
+    pub layout_us: u32,
+    /// Drawing the invalidated areas, without the flushes
+    pub render_us: u32,
+    /// In the flush callback and waiting for flushes to finish
+    pub flush_us: u32,
+    /// The whole refresh
+    pub total_us: u32,
+}
+
+impl FrameTiming {
+    fn max(self, other: Self) -> Self {
+        Self {
+            layout_us: self.layout_us.max(other.layout_us),
+            render_us: self.render_us.max(other.render_us),
+            flush_us: self.flush_us.max(other.flush_us),
+            total_us: self.total_us.max(other.total_us),
+        }
+    }
+}
+
+/// Calls of one kind of callback
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub struct CallStats {
+    /// Number of calls
+    pub count: u32,
+    /// Time in all calls in microseconds, including callbacks nested inside
+    pub total_us: u64,
+    /// Longest single call in microseconds
+    pub max_us: u32,
+}
+
+impl CallStats {
+    /// Average duration of a call
+    pub fn avg_us(&self) -> u32 {
+        match self.count {
+            0 => 0,
+            n => (self.total_us / u64::from(n)) as u32,
+        }
+    }
+
+    fn add(&mut self, us: u32) {
+        self.count = self.count.wrapping_add(1);
+        self.total_us += u64::from(us);
+        self.max_us = self.max_us.max(us);
+    }
+}
+
+/// LVGL heap usage according to `lv_mem_monitor`
+///
+/// Sizes are in bytes. The builtin allocator fills in all fields; with
+/// other `LV_USE_STDLIB_MALLOC` settings they may stay zero. With the
+/// `rust-alloc` feature, `used` and `peak` come from
+/// [`mem::stats`](crate::mem::stats) and the other fields, which a Rust
+/// allocator does not report, are zero.
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub struct MemStats {
+    /// Size of the heap
+    pub total: usize,
+    /// Currently allocated, including allocator overhead
+    pub used: usize,
+    /// Highest use since start
+    pub peak: usize,
+    /// Largest free block, i.e. the largest allocation that can succeed
+    pub biggest_free: usize,
+    /// Fragmentation of the free memory in percent; 0 when it is one block
+    pub frag_pct: u8,
+}
+
+/// Activity since the previous report
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub struct Report {
+    /// Length of the reporting period in milliseconds
+    pub period_ms: u32,
+    /// Refreshes that rendered something
+    pub frames: u32,
+    /// Rendered frames per second over the period
+    pub fps: u32,
+    /// Time spent in LVGL timers in percent, from `lv_timer_get_idle`
+    ///
+    /// LVGL measures this over its own window, not the report period.
+    pub cpu_pct: u8,
+    /// Average timings of the rendered frames; zero without frames
+    pub avg: FrameTiming,
+    /// Longest timings of the rendered frames, per field
+    pub max: FrameTiming,
+    /// Heap usage at the time of the report
+    pub mem: MemStats,
+    /// Event closures run during the period
+    pub events: CallStats,
+    /// Timer closures run during the period
+    pub timers: CallStats,
+    /// Animation closures run during the period
+    pub anims: CallStats,
+}
+
+/// Attach the frame timer to `display`.
+///
+/// Call once per display; frames of all attached displays are reported
+/// together.
+pub fn attach(display: &Display) {
+    unsafe {
+        let p = profiler();
+        if p.frames == 0 {
+            p.period_start = now_us();
+        }
+        neo_lvgl_sys::lv_display_add_event_cb(
+            display.raw(),
+            Some(display_event),
+            neo_lvgl_sys::lv_event_code_t_LV_EVENT_ALL,
+            ptr::null_mut(),
+        );
+    }
+}
+
+/// Call `cb` after every rendered frame
+pub fn set_frame_cb(cb: Option<fn(&FrameTiming)>) {
+    unsafe { profiler().frame_cb = cb };
+}
+
+/// Call `cb` with a [`report`] every `period_ms`
+///
+/// Pass `None` to stop reporting.
+pub fn set_report_cb(period_ms: u32, cb: Option<fn(&Report)>) {
+    unsafe {
+        let p = profiler();
+        p.report_cb = cb;
+        match (cb, p.report_timer.is_null()) {
+            (Some(_), true) => {
+                p.report_timer =
+                    neo_lvgl_sys::lv_timer_create(Some(report_timer), period_ms, ptr::null_mut());
+            }
+            (Some(_), false) => neo_lvgl_sys::lv_timer_set_period(p.report_timer, period_ms),
+            (None, false) => {
+                neo_lvgl_sys::lv_timer_delete(p.report_timer);
+                p.report_timer = ptr::null_mut();
+            }
+            (None, true) => {}
+        }
+    }
+}
+
+/// Statistics since the previous report; starts a new period
+pub fn report() -> Report {
+    let now = now_us();
+    let mem = mem_stats();
+    let idle = unsafe { neo_lvgl_sys::lv_timer_get_idle() };
+    unsafe {
+        let p = profiler();
+        let period_us = elapsed(p.period_start, now).max(1);
+        let frames = p.frames;
+        let avg = match frames {
+            0 => FrameTiming::default(),
+            n => {
+                let n = u64::from(n);
+                FrameTiming {
+                    layout_us: (p.sum[0] / n) as u32,
+                    render_us: (p.sum[1] / n) as u32,
+                    flush_us: (p.sum[2] / n) as u32,
+                    total_us: (p.sum[3] / n) as u32,
+                }
+            }
+        };
+        let report = Report {
+            period_ms: period_us / 1000,
+            frames,
+            fps: (u64::from(frames) * 1_000_000 / u64::from(period_us)) as u32,
+            cpu_pct: 100u32.saturating_sub(idle) as u8,
+            avg,
+            max: p.max,
+            mem,
+            events: p.calls[Site::Event as usize],
+            timers: p.calls[Site::Timer as usize],
+            anims: p.calls[Site::Anim as usize],
+        };
+        p.period_start = now;
+        p.frames = 0;
+        p.sum = [0; 4];
+        p.max = FrameTiming::default();
+        p.calls = [CallStats::default(); 3];
+        report
+    }
+}
+
+/// Current LVGL heap usage
+pub fn mem_stats() -> MemStats {
+    unsafe {
+        let mut mon: neo_lvgl_sys::lv_mem_monitor_t = core::mem::zeroed();
+        neo_lvgl_sys::lv_mem_monitor(&mut mon);
+        #[cfg(not(feature = "rust-alloc"))]
+        let used = mon.total_size.saturating_sub(mon.free_size);
+        #[cfg(feature = "rust-alloc")]
+        let used = crate::mem::stats().used;
+        MemStats {
+            total: mon.total_size,
+            used,
+            peak: mon.max_used,
+            biggest_free: mon.free_biggest_size,
+            frag_pct: mon.frag_pct,
+        }
+    }
+}
+
+/// Start recording a trace into a `buf_size` byte buffer.
+///
+/// `sink` receives the trace a line at a time whenever the buffer fills up
+/// and on [`flush_trace`]; written to a file in order, the lines open in
+/// `chrome://tracing` or Perfetto.
+pub fn start_trace(buf_size: usize, sink: fn(&CStr)) {
+    TRACE_SINK.store(sink as *mut (), Ordering::Release);
+    sink(c"# tracer: nop\n#\n");
+    unsafe {
+        let mut config: neo_lvgl_sys::lv_profiler_builtin_config_t = core::mem::zeroed();
+        neo_lvgl_sys::lv_profiler_builtin_config_init(&mut config);
+        config.buf_size = buf_size;
+        config.tick_per_sec = 1_000_000;
+        config.tick_get_cb = Some(trace_tick);
+        config.flush_cb = Some(trace_flush);
+        // lv_init set up the profiler with the default configuration
+        neo_lvgl_sys::lv_profiler_builtin_uninit();
+        neo_lvgl_sys::lv_profiler_builtin_init(&config);
+        neo_lvgl_sys::lv_profiler_builtin_set_enable(true);
+    }
+}
+
+/// Write the recorded part of the trace to the sink
+pub fn flush_trace() {
+    unsafe { neo_lvgl_sys::lv_profiler_builtin_flush() };
+}
+
+/// Flush and stop the trace
+pub fn stop_trace() {
+    unsafe {
+        neo_lvgl_sys::lv_profiler_builtin_flush();
+        neo_lvgl_sys::lv_profiler_builtin_set_enable(false);
+    }
+}
+
+/// Kind of callback timed by a [`Span`]
+#[derive(Clone, Copy)]
+#[cfg_attr(not(feature = "alloc"), allow(dead_code))]
+pub(crate) enum Site {
+    Event,
+    Timer,
+    Anim,
+}
+
+impl Site {
+    fn name(self) -> &'static CStr {
+        match self {
+            Self::Event => c"rust_event_cb",
+            Self::Timer => c"rust_timer_cb",
+            Self::Anim => c"rust_anim_cb",
+        }
+    }
+}
+
+/// Times a callback until dropped
+#[cfg_attr(not(feature = "alloc"), allow(dead_code))]
+pub(crate) struct Span {
+    site: Site,
+    start: u64,
+}
+
+impl Span {
+    #[inline]
+    #[cfg_attr(not(feature = "alloc"), allow(dead_code))]
+    pub(crate) fn enter(site: Site) -> Self {
+        trace(site, b'B');
+        Self {
+            site,
+            start: now_us(),
+        }
+    }
+}
+
+impl Drop for Span {
+    #[inline]
+    fn drop(&mut self) {
+        let us = elapsed(self.start, now_us());
+        unsafe { profiler().calls[self.site as usize].add(us) };
+        trace(self.site, b'E');
+    }
+}
+
+fn trace(site: Site, tag: u8) {
+    unsafe { neo_lvgl_sys::lv_profiler_builtin_write(site.name().as_ptr(), tag as c_char) };
+}
+
+/// Timestamps of the refresh in progress
+#[derive(Clone, Copy)]
+struct Frame {
+    start: u64,
+    render_start: u64,
+    render_end: u64,
+    flush_start: u64,
+    flush_us: u32,
+    rendered: bool,
+}
+
+struct Profiler {
+    frame: Frame,
+    period_start: u64,
+    frames: u32,
+    /// Sums of the [`FrameTiming`] fields, in declaration order
+    sum: [u64; 4],
+    max: FrameTiming,
+    calls: [CallStats; 3],
+    frame_cb: Option<fn(&FrameTiming)>,
+    report_cb: Option<fn(&Report)>,
+    report_timer: *mut neo_lvgl_sys::lv_timer_t,
+}
+
+struct ProfilerCell(UnsafeCell<Profiler>);
+
+// SAFETY: only used from the LVGL thread
+unsafe impl Sync for ProfilerCell {}
+
+const IDLE_FRAME: Frame = Frame {
+    start: 0,
+    render_start: 0,
+    render_end: 0,
+    flush_start: 0,
+    flush_us: 0,
+    rendered: false,
+};
+
+static PROFILER: ProfilerCell = ProfilerCell(UnsafeCell::new(Profiler {
+    frame: IDLE_FRAME,
+    period_start: 0,
+    frames: 0,
+    sum: [0; 4],
+    max: FrameTiming {
+        layout_us: 0,
+        render_us: 0,
+        flush_us: 0,
+        total_us: 0,
+    },
+    calls: [CallStats {
+        count: 0,
+        total_us: 0,
+        max_us: 0,
+    }; 3],
+    frame_cb: None,
+    report_cb: None,
+    report_timer: ptr::null_mut(),
+}));
+
+static TRACE_SINK: AtomicPtr<()> = AtomicPtr::new(ptr::null_mut());
+
+/// The borrow must end before any user callback runs.
+unsafe fn profiler() -> &'static mut Profiler {
+    &mut *PROFILER.0.get()
+}
+
+fn elapsed(from: u64, to: u64) -> u32 {
+    to.saturating_sub(from).min(u64::from(u32::MAX)) as u32
+}
+
+unsafe extern "C" fn display_event(e: *mut neo_lvgl_sys::lv_event_t) {
+    let now = now_us();
+    let done = {
+        let p = profiler();
+        let f = &mut p.frame;
+        match neo_lvgl_sys::lv_event_get_code(e) {
+            neo_lvgl_sys::lv_event_code_t_LV_EVENT_REFR_START => {
+                *f = Frame {
+                    start: now,
+                    ..IDLE_FRAME
+                };
+                None
+            }
+            neo_lvgl_sys::lv_event_code_t_LV_EVENT_RENDER_START => {
+                f.render_start = now;
+                f.rendered = true;
+                None
+            }
+            neo_lvgl_sys::lv_event_code_t_LV_EVENT_RENDER_READY => {
+                f.render_end = now;
+                None
+            }
+            neo_lvgl_sys::lv_event_code_t_LV_EVENT_FLUSH_START
+            | neo_lvgl_sys::lv_event_code_t_LV_EVENT_FLUSH_WAIT_START => {
+                f.flush_start = now;
+                None
+            }
+            neo_lvgl_sys::lv_event_code_t_LV_EVENT_FLUSH_FINISH
+            | neo_lvgl_sys::lv_event_code_t_LV_EVENT_FLUSH_WAIT_FINISH => {
+                f.flush_us = f.flush_us.saturating_add(elapsed(f.flush_start, now));
+                None
+            }
+            neo_lvgl_sys::lv_event_code_t_LV_EVENT_REFR_READY if f.rendered => {
+                let render_end = if f.render_end < f.render_start {
+                    now
+                } else {
+                    f.render_end
+                };
+                let timing = FrameTiming {
+                    layout_us: elapsed(f.start, f.render_start),
+                    render_us: elapsed(f.render_start, render_end).saturating_sub(f.flush_us),
+                    flush_us: f.flush_us,
+                    total_us: elapsed(f.start, now),
+                };
+                f.rendered = false;
+                p.frames = p.frames.wrapping_add(1);
+                p.sum[0] += u64::from(timing.layout_us);
+                p.sum[1] += u64::from(timing.render_us);
+                p.sum[2] += u64::from(timing.flush_us);
+                p.sum[3] += u64::from(timing.total_us);
+                p.max = p.max.max(timing);
+                p.frame_cb.map(|cb| (cb, timing))
+            }
+            _ => None,
+        }
+    };
+    if let Some((cb, timing)) = done {
+        cb(&timing);
+    }
+}
+
+unsafe extern "C" fn report_timer(_timer: *mut neo_lvgl_sys::lv_timer_t) {
+    let report = report();
+    if let Some(cb) = profiler().report_cb {
+        cb(&report);
+    }
+}
+
+unsafe extern "C" fn trace_tick() -> u64 {
+    now_us()
+}
+
+unsafe extern "C" fn trace_flush(buf: *const c_char) {
+    let sink = TRACE_SINK.load(Ordering::Acquire);
+    if !sink.is_null() && !buf.is_null() {
+        // SAFETY: only ever set from a `fn(&CStr)` in start_trace
+        core::mem::transmute::<*mut (), fn(&CStr)>(sink)(CStr::from_ptr(buf));
+    }
+}
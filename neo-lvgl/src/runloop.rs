@@ -0,0 +1,269 @@
+//! UI loop driver for tickless idle
+//!
+//! Instead of `loop { task_handler(); delay(5) }`, register a monotonic
+//! [`Clock`] once and let [`run_until_idle`] report how long the MCU may
+//! sleep. Running animations, polled input devices and refresh are LVGL
+//! timers, so the returned [`Deadline`] already covers them; event-driven
+//! input calls [`wake`] to end the sleep early, and samples pushed to an
+//! [`indev::SampleQueue`](crate::indev::SampleQueue) do so automatically.
+//!
+//! # Example
+//!
+//! ```ignore
+//! use lvgl::runloop::{self, Clock, Deadline};
+//!
+//! struct Rtc;
+//! impl Clock for Rtc {
+//!     fn now_ms() -> u32 {
+//!         rtc_millis()
+//!     }
+//! }
+//!
+//! runloop::set_clock::<Rtc>();
+//! loop {
+//!     let deadline = runloop::run_until_idle();
+//!     critical_section(|| {
+//!         if !runloop::wake_pending() {
+//!             sleep_until(deadline); // e.g. RTC alarm + WFI
+//!         }
+//!     });
+//! }
+//! ```
+//!
+//! With an async executor, [`run`] awaits the deadline or a wakeup:
+//!
+//! ```ignore
+//! // embassy
+//! runloop::run(|ms| embassy_time::Timer::after_millis(ms.into())).await;
+//! // tokio
+//! runloop::run(|ms| tokio::time::sleep(Duration::from_millis(ms.into()))).await;
+//! ```
+
+use core::cell::UnsafeCell;
+use core::future::{poll_fn, Future};
+use core::pin::pin;
+use core::sync::atomic::{AtomicBool, AtomicPtr, AtomicU8, Ordering};
+use core::task::{Poll, Waker};
+
+/// Handler passes to run back to back before yielding with a zero deadline
+const MAX_PASSES: u32 = 8;
+
+/// A monotonic millisecond clock, registered with [`set_clock`]
+pub trait Clock {
+    /// Milliseconds since an arbitrary start; may wrap around
+    fn now_ms() -> u32;
+
+    /// Microseconds since an arbitrary start
+    ///
+    /// Used for the timings and traces of the `profiling` feature; override
+    /// it when a finer clock (e.g. a cycle counter) is available.
+    fn now_us() -> u64 {
+        u64::from(Self::now_ms()) * 1000
+    }
+}
+
+/// `now_us` of the registered clock
+#[cfg(feature = "profiling")]
+static CLOCK_US: AtomicPtr<()> = AtomicPtr::new(core::ptr::null_mut());
+
+/// Microseconds from the registered clock, or from LVGL's tick without one
+#[cfg(feature = "profiling")]
+pub(crate) fn now_us() -> u64 {
+    let clock = CLOCK_US.load(Ordering::Acquire);
+    if clock.is_null() {
+        return u64::from(unsafe { neo_lvgl_sys::lv_tick_get() }) * 1000;
+    }
+    // SAFETY: only ever set from a `fn() -> u64` in set_clock
+    unsafe { core::mem::transmute::<*mut (), fn() -> u64>(clock)() }
+}
+
+unsafe extern "C" fn tick_cb<C: Clock>() -> u32 {
+    C::now_ms()
+}
+
+/// Use `C` as LVGL's tick source (`lv_tick_set_cb`).
+///
+/// Replaces periodic [`tick_inc`](crate::tick_inc) calls, so no tick
+/// interrupt is needed while sleeping. [`Clock::now_us`] times profiling.
+pub fn set_clock<C: Clock>() {
+    #[cfg(feature = "profiling")]
+    CLOCK_US.store(C::now_us as fn() -> u64 as *mut (), Ordering::Release);
+    unsafe {
+        neo_lvgl_sys::lv_tick_set_cb(Some(tick_cb::<C>));
+    }
+}
+
+/// When the UI loop needs to run again
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum Deadline {
+    /// After this many milliseconds (0 = immediately)
+    In(u32),
+    /// Only after an input or other [`wake`]
+    Never,
+}
+
+impl Deadline {
+    /// Delay in milliseconds, `None` for [`Deadline::Never`]
+    pub fn as_ms(self) -> Option<u32> {
+        match self {
+            Self::In(ms) => Some(ms),
+            Self::Never => None,
+        }
+    }
+
+    /// Absolute deadline in LVGL tick time
+    pub fn at(self) -> Option<u32> {
+        let now = unsafe { neo_lvgl_sys::lv_tick_get() };
+        self.as_ms().map(|ms| now.wrapping_add(ms))
+    }
+}
+
+/// Call `hook` at the start of every [`run_until_idle`] pass.
+///
+/// Typically drains a [`UiQueue`](crate::sync::UiQueue) so queued updates
+/// are applied right before LVGL refreshes.
+pub fn set_before_pass(hook: fn()) {
+    BEFORE_PASS.store(hook as *mut (), Ordering::Release);
+}
+
+/// Run LVGL timers until nothing is due and return the sleep deadline.
+///
+/// Returns `Deadline::In(0)` if a [`wake`] arrived while running, or if
+/// work is still due after a few passes.
+pub fn run_until_idle() -> Deadline {
+    for _ in 0..MAX_PASSES {
+        WOKEN.store(false, Ordering::Relaxed);
+        crate::indev::dispatch();
+        let hook = BEFORE_PASS.load(Ordering::Acquire);
+        if !hook.is_null() {
+            // SAFETY: only ever set from a `fn()` in set_before_pass
+            unsafe { core::mem::transmute::<*mut (), fn()>(hook)() };
+        }
+        let next = unsafe { neo_lvgl_sys::lv_timer_handler() };
+        if WOKEN.load(Ordering::Acquire) {
+            return Deadline::In(0);
+        }
+        match next {
+            0 => continue,
+            neo_lvgl_sys::LV_NO_TIMER_READY => return Deadline::Never,
+            ms => return Deadline::In(ms),
+        }
+    }
+    Deadline::In(0)
+}
+
+/// Request a UI loop pass, e.g. from an input interrupt.
+///
+/// Safe to call from interrupts and other threads.
+pub fn wake() {
+    WOKEN.store(true, Ordering::Release);
+    WAKER.wake();
+}
+
+/// Check whether [`wake`] was called since the last [`run_until_idle`]
+pub fn wake_pending() -> bool {
+    WOKEN.load(Ordering::Acquire)
+}
+
+/// Wait until `sleep` completes or [`wake`] is called.
+///
+/// `sleep` is `None` for [`Deadline::Never`].
+pub async fn idle<F: Future<Output = ()>>(sleep: Option<F>) {
+    let mut sleep = pin!(sleep);
+    poll_fn(|cx| {
+        WAKER.register(cx.waker());
+        if WOKEN.load(Ordering::Acquire) {
+            return Poll::Ready(());
+        }
+        match sleep.as_mut().as_pin_mut() {
+            Some(sleep) => sleep.poll(cx),
+            None => Poll::Pending,
+        }
+    })
+    .await
+}
+
+/// Drive LVGL forever from an async task.
+///
+/// `sleep(ms)` returns the executor's timer future, e.g.
+/// `embassy_time::Timer::after_millis` or `tokio::time::sleep`.
+pub async fn run<S, F>(mut sleep: S) -> !
+where
+    S: FnMut(u32) -> F,
+    F: Future<Output = ()>,
+{
+    loop {
+        let deadline = run_until_idle();
+        idle(deadline.as_ms().map(&mut sleep)).await;
+    }
+}
+
+static WOKEN: AtomicBool = AtomicBool::new(false);
+static BEFORE_PASS: AtomicPtr<()> = AtomicPtr::new(core::ptr::null_mut());
+static WAKER: AtomicWaker = AtomicWaker::new();
+
+const IDLE: u8 = 0;
+const REGISTERING: u8 = 1;
+const WAKING: u8 = 2;
+
+/// A waker slot that can be woken from interrupts without blocking
+struct AtomicWaker {
+    state: AtomicU8,
+    waker: UnsafeCell<Option<Waker>>,
+}
+
+// SAFETY: `waker` is only accessed by the side that moved `state` away from IDLE
+unsafe impl Sync for AtomicWaker {}
+
+impl AtomicWaker {
+    const fn new() -> Self {
+        Self {
+            state: AtomicU8::new(IDLE),
+            waker: UnsafeCell::new(None),
+        }
+    }
+
+    fn register(&self, waker: &Waker) {
+        if self
+            .state
+            .compare_exchange(IDLE, REGISTERING, Ordering::Acquire, Ordering::Acquire)
+            .is_err()
+        {
+            // A wake is in progress; make sure the task is polled again
+            waker.wake_by_ref();
+            return;
+        }
+        unsafe {
+            match &*self.waker.get() {
+                Some(old) if old.will_wake(waker) => {}
+                _ => *self.waker.get() = Some(waker.clone()),
+            }
+        }
+        if self
+            .state
+            .compare_exchange(REGISTERING, IDLE, Ordering::AcqRel, Ordering::Acquire)
+            .is_err()
+        {
+            // Woken while registering
+            let waker = unsafe { (*self.waker.get()).take() };
+            self.state.store(IDLE, Ordering::Release);
+            if let Some(waker) = waker {
+                waker.wake();
+            }
+        }
+    }
+
+    fn wake(&self) {
+        match self.state.fetch_or(WAKING, Ordering::AcqRel) {
+            IDLE => {
+                let waker = unsafe { (*self.waker.get()).take() };
+                self.state.fetch_and(!WAKING, Ordering::Release);
+                if let Some(waker) = waker {
+                    waker.wake();
+                }
+            }
+            // The registering side sees WAKING and wakes itself
+            _ => {}
+        }
+    }
+}
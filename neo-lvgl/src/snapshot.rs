@@ -0,0 +1,456 @@
+//! Snapshots and cached layers (feature `snapshot`)
+//!
+//! [`Snapshot`] renders a widget and its children into an owned draw buffer.
+//! [`CachedLayer`] builds on it for static subtrees such as gauge faces: the
+//! subtree is rendered once and the buffer is drawn as a single image
+//! afterwards, so a needle moving over a `Scale` with dozens of `Line`s costs
+//! one blit instead of the full vector redraw.
+//!
+//! While cached, the subtree keeps its layout, input and events but is not
+//! drawn (`opa_layered` 0); a transparent, non-clickable sibling placed just
+//! above it draws the buffer at the subtree's current position. The layer is
+//! re-rendered on the next timer cycle when the subtree changes size, style
+//! or children. Content changes LVGL does not report to the root (a label's
+//! text, an arc's value) need [`CachedLayer::invalidate`].
+//!
+//! # Example
+//!
+//! ```ignore
+//! use lvgl::snapshot::LayerFormat;
+//!
+//! let face = Obj::new(&screen).unwrap();
+//! build_gauge_face(&face);
+//! let layer = face.cache_layer(LayerFormat::Rgb565A8).unwrap();
+//! let needle = Line::new(&screen).unwrap(); // drawn above the cached face
+//!
+//! log!("face cache: {} bytes", layer.memory());
+//! ```
+
+use crate::color::Opacity;
+use crate::const_style;
+use crate::style::{ConstStyle, StyleSelector};
+use crate::widgets::{pct, Obj, Widget};
+use core::ffi::c_void;
+use core::mem::MaybeUninit;
+use core::ptr::{self, NonNull};
+
+/// Pixel format of a [`Snapshot`] or [`CachedLayer`] buffer
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum LayerFormat {
+    /// 16-bit RGB, opaque (2 bytes per pixel)
+    Rgb565,
+    /// 16-bit RGB plus an 8-bit alpha plane (3 bytes per pixel)
+    Rgb565A8,
+    /// 24-bit RGB, opaque
+    Rgb888,
+    /// 32-bit RGB, opaque
+    Xrgb8888,
+    /// 32-bit RGB with alpha
+    Argb8888,
+}
+
+impl LayerFormat {
+    fn to_raw(self) -> neo_lvgl_sys::lv_color_format_t {
+        match self {
+            LayerFormat::Rgb565 => neo_lvgl_sys::lv_color_format_t_LV_COLOR_FORMAT_RGB565,
+            LayerFormat::Rgb565A8 => neo_lvgl_sys::lv_color_format_t_LV_COLOR_FORMAT_RGB565A8,
+            LayerFormat::Rgb888 => neo_lvgl_sys::lv_color_format_t_LV_COLOR_FORMAT_RGB888,
+            LayerFormat::Xrgb8888 => neo_lvgl_sys::lv_color_format_t_LV_COLOR_FORMAT_XRGB8888,
+            LayerFormat::Argb8888 => neo_lvgl_sys::lv_color_format_t_LV_COLOR_FORMAT_ARGB8888,
+        }
+    }
+}
+
+/// A widget subtree rendered into an owned draw buffer
+///
+/// The buffer covers the widget's area plus its extra draw size (shadows,
+/// outlines) and is freed on drop.
+pub struct Snapshot {
+    buf: NonNull<neo_lvgl_sys::lv_draw_buf_t>,
+}
+
+impl Snapshot {
+    /// Render `widget` and its children into a new buffer.
+    ///
+    /// Returns `None` if the widget has no size or the buffer could not be
+    /// allocated.
+    pub fn take<'a>(widget: &impl Widget<'a>, format: LayerFormat) -> Option<Self> {
+        unsafe { Self::take_raw(widget.raw(), format) }
+    }
+
+    unsafe fn take_raw(obj: *mut neo_lvgl_sys::lv_obj_t, format: LayerFormat) -> Option<Self> {
+        let buf = neo_lvgl_sys::lv_snapshot_take(obj, format.to_raw());
+        NonNull::new(buf).map(|buf| Self { buf })
+    }
+
+    /// Render `obj` again into this buffer, reallocating it only if the
+    /// object grew or `format` changed. On failure the old buffer is kept.
+    unsafe fn retake(&mut self, obj: *mut neo_lvgl_sys::lv_obj_t, format: LayerFormat) -> bool {
+        let buf = self.buf.as_ptr();
+        let cf = format.to_raw();
+        let reused = (*buf).header.cf() == cf
+            && neo_lvgl_sys::lv_snapshot_reshape_draw_buf(obj, buf)
+                == neo_lvgl_sys::lv_result_t_LV_RESULT_OK
+            && neo_lvgl_sys::lv_snapshot_take_to_draw_buf(obj, cf, buf)
+                == neo_lvgl_sys::lv_result_t_LV_RESULT_OK;
+        if reused {
+            // Same address, new pixels
+            neo_lvgl_sys::lv_image_cache_drop(buf as *const c_void);
+            return true;
+        }
+        match Self::take_raw(obj, format) {
+            Some(fresh) => {
+                *self = fresh;
+                true
+            }
+            None => false,
+        }
+    }
+
+    /// Width in pixels
+    pub fn width(&self) -> u32 {
+        unsafe { (*self.buf.as_ptr()).header.w() }
+    }
+
+    /// Height in pixels
+    pub fn height(&self) -> u32 {
+        unsafe { (*self.buf.as_ptr()).header.h() }
+    }
+
+    /// Pixel format
+    pub fn format(&self) -> LayerFormat {
+        let cf = unsafe { (*self.buf.as_ptr()).header.cf() };
+        match cf {
+            neo_lvgl_sys::lv_color_format_t_LV_COLOR_FORMAT_RGB565A8 => LayerFormat::Rgb565A8,
+            neo_lvgl_sys::lv_color_format_t_LV_COLOR_FORMAT_RGB888 => LayerFormat::Rgb888,
+            neo_lvgl_sys::lv_color_format_t_LV_COLOR_FORMAT_XRGB8888 => LayerFormat::Xrgb8888,
+            neo_lvgl_sys::lv_color_format_t_LV_COLOR_FORMAT_ARGB8888 => LayerFormat::Argb8888,
+            _ => LayerFormat::Rgb565,
+        }
+    }
+
+    /// Size of the pixel data in bytes
+    pub fn data_size(&self) -> usize {
+        unsafe { (*self.buf.as_ptr()).data_size as usize }
+    }
+
+    /// Get the raw draw buffer, usable as an image source while `self` lives
+    #[inline]
+    pub fn raw(&self) -> *const neo_lvgl_sys::lv_draw_buf_t {
+        self.buf.as_ptr()
+    }
+}
+
+impl Drop for Snapshot {
+    fn drop(&mut self) {
+        unsafe {
+            neo_lvgl_sys::lv_image_cache_drop(self.buf.as_ptr() as *const c_void);
+            neo_lvgl_sys::lv_draw_buf_destroy(self.buf.as_ptr());
+        }
+    }
+}
+
+/// Keeps a cached subtree out of the render pass without affecting layout
+static HIDDEN: ConstStyle = const_style![opa_layered(Opacity::TRANSPARENT)];
+
+/// Layer state, allocated with `lv_malloc` and freed with the root
+struct State {
+    root: *mut neo_lvgl_sys::lv_obj_t,
+    /// Sibling drawing `buf`; null once deleted
+    proxy: *mut neo_lvgl_sys::lv_obj_t,
+    buf: Option<Snapshot>,
+    format: LayerFormat,
+    /// `buf` is current and the root is hidden
+    shown: bool,
+    /// A re-render is queued with `lv_async_call`
+    scheduled: bool,
+    /// Ignore the root's events caused by our own style changes
+    busy: bool,
+}
+
+/// A subtree drawn from a cached snapshot
+///
+/// Created with [`Widget::cache_layer`]. The cache follows the root: it is
+/// freed when the root is deleted or [`remove`](Self::remove) is called.
+pub struct CachedLayer<'a> {
+    root: Obj<'a>,
+    state: NonNull<State>,
+}
+
+impl<'a> CachedLayer<'a> {
+    /// Start caching `widget` and its children in `format`.
+    ///
+    /// The subtree is rendered immediately; if it has no size yet it is drawn
+    /// live until its first layout. Returns `None` if the state or the proxy
+    /// object could not be allocated.
+    pub fn new(widget: &impl Widget<'a>, format: LayerFormat) -> Option<Self> {
+        let root = *widget.obj();
+        unsafe {
+            let parent = neo_lvgl_sys::lv_obj_get_parent(root.raw());
+            if parent.is_null() {
+                // A screen has no sibling to draw it
+                return None;
+            }
+            let state = neo_lvgl_sys::lv_malloc(core::mem::size_of::<State>()) as *mut State;
+            let state = NonNull::new(state)?;
+            let proxy = neo_lvgl_sys::lv_obj_create(parent);
+            if proxy.is_null() {
+                neo_lvgl_sys::lv_free(state.as_ptr().cast());
+                return None;
+            }
+            ptr::write(
+                state.as_ptr(),
+                State {
+                    root: root.raw(),
+                    proxy,
+                    buf: None,
+                    format,
+                    shown: false,
+                    scheduled: false,
+                    busy: false,
+                },
+            );
+
+            neo_lvgl_sys::lv_obj_remove_style_all(proxy);
+            neo_lvgl_sys::lv_obj_add_flag(proxy, neo_lvgl_sys::lv_obj_flag_t_LV_OBJ_FLAG_FLOATING);
+            neo_lvgl_sys::lv_obj_remove_flag(
+                proxy,
+                neo_lvgl_sys::lv_obj_flag_t_LV_OBJ_FLAG_CLICKABLE
+                    | neo_lvgl_sys::lv_obj_flag_t_LV_OBJ_FLAG_SCROLLABLE,
+            );
+            neo_lvgl_sys::lv_obj_set_size(proxy, pct(100), pct(100));
+            neo_lvgl_sys::lv_obj_move_to_index(
+                proxy,
+                neo_lvgl_sys::lv_obj_get_index(root.raw()) + 1,
+            );
+
+            let data = state.as_ptr() as *mut c_void;
+            for code in [
+                neo_lvgl_sys::lv_event_code_t_LV_EVENT_DRAW_MAIN,
+                neo_lvgl_sys::lv_event_code_t_LV_EVENT_REFR_EXT_DRAW_SIZE,
+                neo_lvgl_sys::lv_event_code_t_LV_EVENT_DELETE,
+            ] {
+                neo_lvgl_sys::lv_obj_add_event_cb(proxy, Some(proxy_event_cb), code, data);
+            }
+            for code in [
+                neo_lvgl_sys::lv_event_code_t_LV_EVENT_SIZE_CHANGED,
+                neo_lvgl_sys::lv_event_code_t_LV_EVENT_STYLE_CHANGED,
+                neo_lvgl_sys::lv_event_code_t_LV_EVENT_CHILD_CHANGED,
+                neo_lvgl_sys::lv_event_code_t_LV_EVENT_CHILD_CREATED,
+                neo_lvgl_sys::lv_event_code_t_LV_EVENT_CHILD_DELETED,
+                neo_lvgl_sys::lv_event_code_t_LV_EVENT_DELETE,
+            ] {
+                neo_lvgl_sys::lv_obj_add_event_cb(root.raw(), Some(root_event_cb), code, data);
+            }
+
+            render(&mut *state.as_ptr());
+            Some(Self { root, state })
+        }
+    }
+
+    /// Re-render the subtree now.
+    ///
+    /// Returns `false` if the snapshot failed; the subtree is then drawn live
+    /// until the next successful render.
+    pub fn refresh(&self) -> bool {
+        unsafe { render(&mut *self.state.as_ptr()) }
+    }
+
+    /// Re-render the subtree on the next timer cycle.
+    ///
+    /// Call after changing content inside the subtree that does not resize
+    /// or restyle it, e.g. a label's text.
+    pub fn invalidate(&self) {
+        unsafe { schedule(self.state.as_ptr()) }
+    }
+
+    /// Change the buffer format and re-render
+    pub fn set_format(&self, format: LayerFormat) -> bool {
+        unsafe {
+            let state = &mut *self.state.as_ptr();
+            state.format = format;
+            render(state)
+        }
+    }
+
+    /// Current buffer format
+    pub fn format(&self) -> LayerFormat {
+        unsafe { (*self.state.as_ptr()).format }
+    }
+
+    /// Bytes held by the cached buffer (0 before the first render)
+    pub fn memory(&self) -> usize {
+        unsafe {
+            (*self.state.as_ptr())
+                .buf
+                .as_ref()
+                .map_or(0, Snapshot::data_size)
+        }
+    }
+
+    /// Whether the subtree is currently drawn from the cache
+    pub fn is_valid(&self) -> bool {
+        unsafe { (*self.state.as_ptr()).shown }
+    }
+
+    /// Get the cached root
+    pub fn root(&self) -> &Obj<'a> {
+        &self.root
+    }
+
+    /// Stop caching: free the buffer and draw the subtree live again
+    pub fn remove(self) {
+        unsafe {
+            let state = self.state.as_ptr();
+            neo_lvgl_sys::lv_obj_remove_event_cb_with_user_data(
+                (*state).root,
+                Some(root_event_cb),
+                state as *mut c_void,
+            );
+            release(state);
+        }
+    }
+}
+
+/// Show or hide the live subtree
+unsafe fn set_hidden(state: &mut State, hidden: bool) {
+    let busy = core::mem::replace(&mut state.busy, true);
+    let style = HIDDEN.raw() as *mut _;
+    let main = StyleSelector::MAIN.bits();
+    if hidden {
+        neo_lvgl_sys::lv_obj_add_style(state.root, style, main);
+    } else {
+        neo_lvgl_sys::lv_obj_remove_style(state.root, style, main);
+    }
+    state.busy = busy;
+}
+
+unsafe fn render(state: &mut State) -> bool {
+    if state.scheduled {
+        neo_lvgl_sys::lv_async_call_cancel(
+            Some(async_render_cb),
+            state as *mut State as *mut c_void,
+        );
+        state.scheduled = false;
+    }
+    if state.proxy.is_null() {
+        return false;
+    }
+    // Layout updates and our style toggles must not queue another render
+    state.busy = true;
+    if state.shown {
+        set_hidden(state, false);
+    }
+    neo_lvgl_sys::lv_obj_update_layout(state.root);
+    let ok = match &mut state.buf {
+        Some(buf) => buf.retake(state.root, state.format),
+        None => {
+            state.buf = Snapshot::take_raw(state.root, state.format);
+            state.buf.is_some()
+        }
+    };
+    state.shown = ok;
+    if ok {
+        set_hidden(state, true);
+        neo_lvgl_sys::lv_obj_refresh_ext_draw_size(state.proxy);
+    }
+    state.busy = false;
+    neo_lvgl_sys::lv_obj_invalidate(state.root);
+    ok
+}
+
+unsafe fn schedule(state: *mut State) {
+    if !(*state).scheduled && !(*state).proxy.is_null() {
+        (*state).scheduled = true;
+        neo_lvgl_sys::lv_async_call(Some(async_render_cb), state as *mut c_void);
+    }
+}
+
+/// Stop caching and free the state; the root stays alive
+unsafe fn release(state: *mut State) {
+    let proxy = (*state).proxy;
+    if !proxy.is_null() {
+        // Its DELETE event shows the root again
+        neo_lvgl_sys::lv_obj_delete(proxy);
+    }
+    if (*state).scheduled {
+        neo_lvgl_sys::lv_async_call_cancel(Some(async_render_cb), state as *mut c_void);
+    }
+    ptr::drop_in_place(state);
+    neo_lvgl_sys::lv_free(state as *mut c_void);
+}
+
+/// Area the snapshot covers: the root's coordinates plus its extra draw size
+unsafe fn layer_area(state: &State) -> Option<neo_lvgl_sys::lv_area_t> {
+    let buf = state.buf.as_ref().filter(|_| state.shown)?;
+    let mut area = MaybeUninit::<neo_lvgl_sys::lv_area_t>::zeroed().assume_init();
+    neo_lvgl_sys::lv_obj_get_coords(state.root, &mut area);
+    let ext = neo_lvgl_sys::lv_obj_get_ext_draw_size(state.root);
+    area.x1 -= ext;
+    area.y1 -= ext;
+    area.x2 = area.x1 + buf.width() as i32 - 1;
+    area.y2 = area.y1 + buf.height() as i32 - 1;
+    Some(area)
+}
+
+unsafe extern "C" fn async_render_cb(data: *mut c_void) {
+    let state = &mut *(data as *mut State);
+    state.scheduled = false;
+    render(state);
+}
+
+unsafe extern "C" fn root_event_cb(e: *mut neo_lvgl_sys::lv_event_t) {
+    let state = neo_lvgl_sys::lv_event_get_user_data(e) as *mut State;
+    match neo_lvgl_sys::lv_event_get_code(e) {
+        neo_lvgl_sys::lv_event_code_t_LV_EVENT_DELETE => {
+            // The proxy's DELETE event must not touch the dying root
+            (*state).shown = false;
+            (*state).buf = None;
+            release(state);
+        }
+        _ if (*state).busy => {}
+        _ => schedule(state),
+    }
+}
+
+unsafe extern "C" fn proxy_event_cb(e: *mut neo_lvgl_sys::lv_event_t) {
+    let state = &mut *(neo_lvgl_sys::lv_event_get_user_data(e) as *mut State);
+    match neo_lvgl_sys::lv_event_get_code(e) {
+        neo_lvgl_sys::lv_event_code_t_LV_EVENT_DRAW_MAIN => {
+            let Some(area) = layer_area(state) else {
+                return;
+            };
+            let Some(buf) = &state.buf else {
+                return;
+            };
+            let mut dsc = MaybeUninit::<neo_lvgl_sys::lv_draw_image_dsc_t>::zeroed();
+            neo_lvgl_sys::lv_draw_image_dsc_init(dsc.as_mut_ptr());
+            let mut dsc = dsc.assume_init();
+            dsc.src = buf.raw() as *const c_void;
+            neo_lvgl_sys::lv_draw_image(neo_lvgl_sys::lv_event_get_layer(e), &dsc, &area);
+        }
+        neo_lvgl_sys::lv_event_code_t_LV_EVENT_REFR_EXT_DRAW_SIZE => {
+            // The proxy is clipped to its own area; reach the whole layer
+            let Some(area) = layer_area(state) else {
+                return;
+            };
+            let mut own = MaybeUninit::<neo_lvgl_sys::lv_area_t>::zeroed().assume_init();
+            neo_lvgl_sys::lv_obj_get_coords(state.proxy, &mut own);
+            let reach = (own.x1 - area.x1)
+                .max(area.x2 - own.x2)
+                .max(own.y1 - area.y1)
+                .max(area.y2 - own.y2);
+            if reach > 0 {
+                neo_lvgl_sys::lv_event_set_ext_draw_size(e, reach);
+            }
+        }
+        neo_lvgl_sys::lv_event_code_t_LV_EVENT_DELETE => {
+            state.proxy = ptr::null_mut();
+            if state.shown {
+                state.shown = false;
+                set_hidden(state, false);
+            }
+        }
+        _ => {}
+    }
+}
@@ -2,10 +2,18 @@
 //!
 //! LVGL styles allow customizing the appearance of widgets.
 //! Styles can be applied to different parts and states of widgets.
+//!
+//! Styles that never change can be built at compile time with
+//! [`const_style!`](crate::const_style). Their property tables live in flash
+//! and need no initialization or heap memory.
 
 use crate::color::{Color, Opacity};
 use bitflags::bitflags;
+use core::cell::UnsafeCell;
+use core::ffi::c_void;
+use core::marker::PhantomData;
 use core::mem::MaybeUninit;
+use core::ptr;
 
 /// LVGL style
 ///
@@ -457,6 +465,293 @@ impl Drop for Style {
     }
 }
 
+/// A style property with a compile-time value
+///
+/// Element of a [`ConstStyle`] property table, usually built with
+/// [`const_style!`](crate::const_style).
+#[derive(Clone, Copy)]
+#[repr(transparent)]
+pub struct StyleProp(neo_lvgl_sys::lv_style_const_prop_t);
+
+// SAFETY: immutable data; pointer values only refer to 'static data
+unsafe impl Sync for StyleProp {}
+
+const fn num(value: i32) -> neo_lvgl_sys::lv_style_value_t {
+    neo_lvgl_sys::lv_style_value_t { num: value }
+}
+
+const fn color(value: Color) -> neo_lvgl_sys::lv_style_value_t {
+    neo_lvgl_sys::lv_style_value_t { color: value.raw() }
+}
+
+impl StyleProp {
+    /// Terminator of a property table
+    pub const END: Self = Self::with(neo_lvgl_sys::_lv_style_id_t_LV_STYLE_PROP_INV, num(0));
+
+    const fn with(id: u32, value: neo_lvgl_sys::lv_style_value_t) -> Self {
+        Self(neo_lvgl_sys::lv_style_const_prop_t {
+            prop: id as neo_lvgl_sys::lv_style_prop_t,
+            value,
+        })
+    }
+
+    const fn is_end(&self) -> bool {
+        self.0.prop
+            == neo_lvgl_sys::_lv_style_id_t_LV_STYLE_PROP_INV as neo_lvgl_sys::lv_style_prop_t
+    }
+}
+
+macro_rules! style_props {
+    ($($name:ident($arg:ident: $ty:ty) => $id:ident = $value:expr;)*) => {
+        impl StyleProp {
+            $(
+                #[doc = concat!("`", stringify!($name), "` property")]
+                pub const fn $name($arg: $ty) -> Self {
+                    Self::with(neo_lvgl_sys::$id, $value)
+                }
+            )*
+        }
+    };
+}
+
+style_props! {
+    bg_color(c: Color) => _lv_style_id_t_LV_STYLE_BG_COLOR = color(c);
+    bg_opa(opa: Opacity) => _lv_style_id_t_LV_STYLE_BG_OPA = num(opa.raw() as i32);
+    bg_grad_color(c: Color) => _lv_style_id_t_LV_STYLE_BG_GRAD_COLOR = color(c);
+    bg_grad_dir(dir: GradDir) => _lv_style_id_t_LV_STYLE_BG_GRAD_DIR = num(dir.to_raw() as i32);
+    border_color(c: Color) => _lv_style_id_t_LV_STYLE_BORDER_COLOR = color(c);
+    border_opa(opa: Opacity) => _lv_style_id_t_LV_STYLE_BORDER_OPA = num(opa.raw() as i32);
+    border_width(width: i32) => _lv_style_id_t_LV_STYLE_BORDER_WIDTH = num(width);
+    border_side(side: BorderSide) => _lv_style_id_t_LV_STYLE_BORDER_SIDE = num(side.bits() as i32);
+    radius(radius: i32) => _lv_style_id_t_LV_STYLE_RADIUS = num(radius);
+    pad_top(pad: i32) => _lv_style_id_t_LV_STYLE_PAD_TOP = num(pad);
+    pad_bottom(pad: i32) => _lv_style_id_t_LV_STYLE_PAD_BOTTOM = num(pad);
+    pad_left(pad: i32) => _lv_style_id_t_LV_STYLE_PAD_LEFT = num(pad);
+    pad_right(pad: i32) => _lv_style_id_t_LV_STYLE_PAD_RIGHT = num(pad);
+    pad_row(pad: i32) => _lv_style_id_t_LV_STYLE_PAD_ROW = num(pad);
+    pad_column(pad: i32) => _lv_style_id_t_LV_STYLE_PAD_COLUMN = num(pad);
+    width(width: i32) => _lv_style_id_t_LV_STYLE_WIDTH = num(width);
+    min_width(width: i32) => _lv_style_id_t_LV_STYLE_MIN_WIDTH = num(width);
+    max_width(width: i32) => _lv_style_id_t_LV_STYLE_MAX_WIDTH = num(width);
+    height(height: i32) => _lv_style_id_t_LV_STYLE_HEIGHT = num(height);
+    min_height(height: i32) => _lv_style_id_t_LV_STYLE_MIN_HEIGHT = num(height);
+    max_height(height: i32) => _lv_style_id_t_LV_STYLE_MAX_HEIGHT = num(height);
+    text_color(c: Color) => _lv_style_id_t_LV_STYLE_TEXT_COLOR = color(c);
+    text_opa(opa: Opacity) => _lv_style_id_t_LV_STYLE_TEXT_OPA = num(opa.raw() as i32);
+    text_letter_space(space: i32) => _lv_style_id_t_LV_STYLE_TEXT_LETTER_SPACE = num(space);
+    text_line_space(space: i32) => _lv_style_id_t_LV_STYLE_TEXT_LINE_SPACE = num(space);
+    text_align(align: TextAlign) => _lv_style_id_t_LV_STYLE_TEXT_ALIGN = num(align.to_raw() as i32);
+    outline_color(c: Color) => _lv_style_id_t_LV_STYLE_OUTLINE_COLOR = color(c);
+    outline_opa(opa: Opacity) => _lv_style_id_t_LV_STYLE_OUTLINE_OPA = num(opa.raw() as i32);
+    outline_width(width: i32) => _lv_style_id_t_LV_STYLE_OUTLINE_WIDTH = num(width);
+    outline_pad(pad: i32) => _lv_style_id_t_LV_STYLE_OUTLINE_PAD = num(pad);
+    shadow_color(c: Color) => _lv_style_id_t_LV_STYLE_SHADOW_COLOR = color(c);
+    shadow_opa(opa: Opacity) => _lv_style_id_t_LV_STYLE_SHADOW_OPA = num(opa.raw() as i32);
+    shadow_width(width: i32) => _lv_style_id_t_LV_STYLE_SHADOW_WIDTH = num(width);
+    shadow_offset_x(offset: i32) => _lv_style_id_t_LV_STYLE_SHADOW_OFFSET_X = num(offset);
+    shadow_offset_y(offset: i32) => _lv_style_id_t_LV_STYLE_SHADOW_OFFSET_Y = num(offset);
+    shadow_spread(spread: i32) => _lv_style_id_t_LV_STYLE_SHADOW_SPREAD = num(spread);
+    transform_rotation(angle: i32) => _lv_style_id_t_LV_STYLE_TRANSFORM_ROTATION = num(angle);
+    transform_scale_x(scale: i32) => _lv_style_id_t_LV_STYLE_TRANSFORM_SCALE_X = num(scale);
+    transform_scale_y(scale: i32) => _lv_style_id_t_LV_STYLE_TRANSFORM_SCALE_Y = num(scale);
+    opa(opa: Opacity) => _lv_style_id_t_LV_STYLE_OPA = num(opa.raw() as i32);
+    opa_layered(opa: Opacity) => _lv_style_id_t_LV_STYLE_OPA_LAYERED = num(opa.raw() as i32);
+    flex_flow(flow: FlexFlow) => _lv_style_id_t_LV_STYLE_FLEX_FLOW = num(flow.to_raw() as i32);
+    flex_grow(grow: u8) => _lv_style_id_t_LV_STYLE_FLEX_GROW = num(grow as i32);
+}
+
+/// A read-only style backed by a static property table
+///
+/// The LVGL equivalent of `LV_STYLE_CONST_INIT`: the style and its
+/// properties are plain `static` data placed in flash, need no
+/// `lv_style_init` and no heap, and are looked up by LVGL like any other
+/// style. Requires `LV_USE_ASSERT_STYLE 0` (the default).
+///
+/// # Example
+///
+/// ```ignore
+/// use lvgl::const_style;
+/// use lvgl::style::ConstStyle;
+///
+/// static CARD: ConstStyle = const_style![
+///     bg_color(Color::const_hex(0x202830)),
+///     radius(8),
+///     pad_top(12),
+///     pad_bottom(12),
+/// ];
+///
+/// panel.add_const_style(&CARD, StyleSelector::MAIN);
+/// ```
+#[repr(transparent)]
+pub struct ConstStyle(neo_lvgl_sys::lv_style_t);
+
+// SAFETY: LVGL never writes to constant styles
+unsafe impl Sync for ConstStyle {}
+
+impl ConstStyle {
+    /// Create a style from a property table ending in [`StyleProp::END`]
+    ///
+    /// Panics at compile time if the terminator is missing.
+    pub const fn new(props: &'static [StyleProp]) -> Self {
+        assert!(
+            !props.is_empty() && props[props.len() - 1].is_end(),
+            "const style property table must end with StyleProp::END"
+        );
+        let mut raw: neo_lvgl_sys::lv_style_t = unsafe { MaybeUninit::zeroed().assume_init() };
+        raw.values_and_props = props.as_ptr() as *mut c_void;
+        // Marks the style as constant, as LV_STYLE_CONST_INIT does
+        raw.has_group = 0xFFFF_FFFF;
+        raw.prop_cnt = 255;
+        Self(raw)
+    }
+
+    /// Get raw pointer to the style
+    #[inline]
+    pub fn raw(&self) -> *const neo_lvgl_sys::lv_style_t {
+        &self.0
+    }
+}
+
+/// Build a [`ConstStyle`](crate::style::ConstStyle) from
+/// [`StyleProp`](crate::style::StyleProp) constructors.
+///
+/// ```ignore
+/// static TITLE: ConstStyle = const_style![text_color(Color::white()), text_letter_space(1)];
+/// ```
+#[macro_export]
+macro_rules! const_style {
+    ($($prop:ident($($arg:expr),* $(,)?)),* $(,)?) => {{
+        static PROPS: &[$crate::style::StyleProp] = &[
+            $($crate::style::StyleProp::$prop($($arg),*),)*
+            $crate::style::StyleProp::END,
+        ];
+        $crate::style::ConstStyle::new(PROPS)
+    }};
+}
+
+/// Roots refreshed when the outermost [`StyleBatch`] ends; further nested
+/// roots are refreshed when their own batch ends
+const MAX_BATCH_ROOTS: usize = 8;
+
+/// Open [`StyleBatch`]es and the roots to refresh when the outermost ends
+struct BatchState {
+    depth: u32,
+    roots: [*mut neo_lvgl_sys::lv_obj_t; MAX_BATCH_ROOTS],
+    len: usize,
+}
+
+struct BatchCell(UnsafeCell<BatchState>);
+
+// SAFETY: only used from the LVGL thread
+unsafe impl Sync for BatchCell {}
+
+static BATCH: BatchCell = BatchCell(UnsafeCell::new(BatchState {
+    depth: 0,
+    roots: [ptr::null_mut(); MAX_BATCH_ROOTS],
+    len: 0,
+}));
+
+/// Refresh `root` and, recursively, all of its children
+unsafe fn refresh_subtree(root: *mut neo_lvgl_sys::lv_obj_t) {
+    neo_lvgl_sys::lv_obj_refresh_style(
+        root,
+        neo_lvgl_sys::lv_part_t_LV_PART_ANY,
+        neo_lvgl_sys::_lv_style_id_t_LV_STYLE_PROP_ANY as neo_lvgl_sys::lv_style_prop_t,
+    );
+}
+
+/// Whether `obj` is `root` or one of its descendants
+unsafe fn in_subtree(
+    mut obj: *mut neo_lvgl_sys::lv_obj_t,
+    root: *mut neo_lvgl_sys::lv_obj_t,
+) -> bool {
+    while !obj.is_null() {
+        if obj == root {
+            return true;
+        }
+        obj = neo_lvgl_sys::lv_obj_get_parent(obj);
+    }
+    false
+}
+
+/// An open style transaction on a widget subtree
+///
+/// While a batch is open, adding or removing styles and setting local style
+/// properties does not refresh objects. Dropping the batch refreshes the
+/// subtree once: one style report, one layout pass and one invalidation per
+/// object instead of one per change. Batches may nest; the roots of nested
+/// batches are refreshed together, and LVGL's automatic refresh re-enabled,
+/// when the outermost batch ends.
+///
+/// Style refresh is global, so changes to objects outside the subtree made
+/// during the batch are not refreshed by it; call
+/// [`refresh_style`](crate::widgets::Widget::refresh_style) on them.
+///
+/// Created with [`Widget::style_batch`](crate::widgets::Widget::style_batch).
+pub struct StyleBatch<'w> {
+    root: *mut neo_lvgl_sys::lv_obj_t,
+    /// The root did not fit the batch state
+    refresh_on_drop: bool,
+    _widget: PhantomData<&'w ()>,
+}
+
+impl StyleBatch<'_> {
+    /// Open a batch on `root` and its children
+    ///
+    /// # Safety
+    ///
+    /// `root` must stay valid until the batch is dropped. A root of a nested
+    /// batch that is deleted before the outermost batch ends is skipped.
+    pub unsafe fn begin(root: *mut neo_lvgl_sys::lv_obj_t) -> Self {
+        let batch = &mut *BATCH.0.get();
+        if batch.depth == 0 {
+            neo_lvgl_sys::lv_obj_enable_style_refresh(false);
+        }
+        batch.depth += 1;
+        // Subtrees of a recorded root are refreshed with it
+        let recorded = &batch.roots[..batch.len];
+        let mut refresh_on_drop = false;
+        if !recorded.iter().any(|&outer| in_subtree(root, outer)) {
+            if batch.len < MAX_BATCH_ROOTS {
+                batch.roots[batch.len] = root;
+                batch.len += 1;
+            } else {
+                refresh_on_drop = true;
+            }
+        }
+        Self {
+            root,
+            refresh_on_drop,
+            _widget: PhantomData,
+        }
+    }
+}
+
+impl Drop for StyleBatch<'_> {
+    fn drop(&mut self) {
+        unsafe {
+            let batch = &mut *BATCH.0.get();
+            batch.depth -= 1;
+            if self.refresh_on_drop {
+                // Not recorded, so refresh it now
+                neo_lvgl_sys::lv_obj_enable_style_refresh(true);
+                refresh_subtree(self.root);
+                neo_lvgl_sys::lv_obj_enable_style_refresh(false);
+            }
+            if batch.depth == 0 {
+                neo_lvgl_sys::lv_obj_enable_style_refresh(true);
+                let len = core::mem::take(&mut batch.len);
+                for (i, &root) in batch.roots[..len].iter().enumerate() {
+                    // The outermost root is this one; nested ones may be gone
+                    if i == 0 || neo_lvgl_sys::lv_obj_is_valid(root) {
+                        refresh_subtree(root);
+                    }
+                }
+            }
+        }
+    }
+}
+
 bitflags! {
     /// Style selector for specifying widget parts and states
     #[derive(Clone, Copy, Debug, PartialEq, Eq)]
@@ -501,7 +796,7 @@ pub enum GradDir {
 }
 
 impl GradDir {
-    fn to_raw(self) -> neo_lvgl_sys::lv_grad_dir_t {
+    const fn to_raw(self) -> neo_lvgl_sys::lv_grad_dir_t {
         match self {
             GradDir::None => neo_lvgl_sys::lv_grad_dir_t_LV_GRAD_DIR_NONE,
             GradDir::Horizontal => neo_lvgl_sys::lv_grad_dir_t_LV_GRAD_DIR_HOR,
@@ -533,7 +828,7 @@ pub enum TextAlign {
 }
 
 impl TextAlign {
-    fn to_raw(self) -> neo_lvgl_sys::lv_text_align_t {
+    const fn to_raw(self) -> neo_lvgl_sys::lv_text_align_t {
         match self {
             TextAlign::Auto => neo_lvgl_sys::lv_text_align_t_LV_TEXT_ALIGN_AUTO,
             TextAlign::Left => neo_lvgl_sys::lv_text_align_t_LV_TEXT_ALIGN_LEFT,
@@ -557,7 +852,7 @@ pub enum FlexFlow {
 }
 
 impl FlexFlow {
-    fn to_raw(self) -> neo_lvgl_sys::lv_flex_flow_t {
+    const fn to_raw(self) -> neo_lvgl_sys::lv_flex_flow_t {
         match self {
             FlexFlow::Row => neo_lvgl_sys::lv_flex_flow_t_LV_FLEX_FLOW_ROW,
             FlexFlow::Column => neo_lvgl_sys::lv_flex_flow_t_LV_FLEX_FLOW_COLUMN,
@@ -3,6 +3,16 @@
 //! LVGL is not thread-safe by default. This module provides wrappers that ensure
 //! all access to LVGL objects goes through `lv_lock()`/`lv_unlock()` synchronization.
 //!
+//! # OS backends
+//!
+//! `lv_lock()` is only a real mutex when LVGL is built with an OS backend,
+//! selected with the `os-pthread` or `os-freertos` feature. Those features
+//! also enable threaded software rendering (`NEO_LVGL_DRAW_UNITS` render
+//! threads at build time, default 2), and `lv_timer_handler()` then takes the
+//! lock itself, so other threads can update widgets through [`Locked`] or
+//! [`lvgl_lock`] while the UI runs. Without an OS backend the lock is a no-op
+//! and all LVGL calls must come from one thread; see [`HAS_OS_LOCK`].
+//!
 //! # Example
 //!
 //! ```ignore
@@ -21,9 +31,23 @@
 //!     // Lock released when guard drops
 //! });
 //! ```
+//!
+//! # Update queue
+//!
+//! Producers that only need to push values into the UI should not take the
+//! LVGL lock at all. [`UiQueue`] is a bounded lock-free queue: tasks and
+//! interrupts [`post`](UiQueue::post) typed commands without blocking, and
+//! the LVGL thread applies them before each `lv_timer_handler()` pass (see
+//! [`runloop::set_before_pass`](crate::runloop::set_before_pass)).
+//! [`lvgl_try_lock_isr`] remains for cases the queue can't express.
 
 use core::cell::UnsafeCell;
+use core::mem::MaybeUninit;
 use core::ops::{Deref, DerefMut};
+use core::sync::atomic::{AtomicUsize, Ordering};
+
+/// Whether LVGL was built with an OS backend, making `lv_lock()` a real mutex.
+pub const HAS_OS_LOCK: bool = cfg!(any(feature = "os-pthread", feature = "os-freertos"));
 
 /// A thread-safe wrapper for LVGL objects.
 ///
@@ -217,3 +241,182 @@ impl Drop for LvglLockGuard {
         }
     }
 }
+
+struct QueueSlot<T> {
+    /// Sequence number minus the slot index (so all-zero is the empty state)
+    seq: AtomicUsize,
+    value: UnsafeCell<MaybeUninit<T>>,
+}
+
+impl<T> QueueSlot<T> {
+    const EMPTY: Self = Self {
+        seq: AtomicUsize::new(0),
+        value: UnsafeCell::new(MaybeUninit::uninit()),
+    };
+}
+
+/// A bounded lock-free queue of UI updates
+///
+/// Any number of threads or interrupts may [`post`](Self::post); posting
+/// never blocks and fails only when the queue is full. The LVGL thread
+/// applies the updates with [`drain`](Self::drain). Each post also calls
+/// [`runloop::wake`](crate::runloop::wake) so a sleeping UI loop runs.
+///
+/// # Example
+///
+/// ```ignore
+/// use lvgl::sync::UiQueue;
+///
+/// enum Update {
+///     Temperature(i32),
+///     Status(&'static CStr),
+/// }
+///
+/// static UPDATES: UiQueue<Update, 64> = UiQueue::new();
+///
+/// // Sensor task
+/// let _ = UPDATES.post(Update::Temperature(231));
+///
+/// // LVGL thread
+/// fn apply_updates() {
+///     UPDATES.drain(|update| match update {
+///         Update::Temperature(t) => ui().temperature.set_deferred(t),
+///         Update::Status(text) => ui().status.set_text(text),
+///     });
+/// }
+/// runloop::set_before_pass(apply_updates);
+/// ```
+pub struct UiQueue<T, const N: usize> {
+    slots: [QueueSlot<T>; N],
+    head: AtomicUsize,
+    tail: AtomicUsize,
+}
+
+// SAFETY: values are handed from producers to the consumer through the
+// per-slot sequence numbers, which order every access to a slot
+unsafe impl<T: Send, const N: usize> Sync for UiQueue<T, N> {}
+unsafe impl<T: Send, const N: usize> Send for UiQueue<T, N> {}
+
+impl<T, const N: usize> UiQueue<T, N> {
+    /// Create an empty queue with room for `N` updates
+    pub const fn new() -> Self {
+        assert!(N > 0, "UiQueue capacity must not be zero");
+        Self {
+            slots: [QueueSlot::EMPTY; N],
+            head: AtomicUsize::new(0),
+            tail: AtomicUsize::new(0),
+        }
+    }
+
+    #[inline]
+    fn seq(&self, pos: usize) -> (&QueueSlot<T>, usize) {
+        let index = pos % N;
+        let slot = &self.slots[index];
+        (slot, slot.seq.load(Ordering::Acquire).wrapping_add(index))
+    }
+
+    #[inline]
+    fn set_seq(slot: &QueueSlot<T>, pos: usize, seq: usize) {
+        slot.seq.store(seq.wrapping_sub(pos % N), Ordering::Release);
+    }
+
+    /// Queue an update without blocking.
+    ///
+    /// Returns the update back if the queue is full.
+    pub fn post(&self, value: T) -> Result<(), T> {
+        self.enqueue(value)?;
+        crate::runloop::wake();
+        Ok(())
+    }
+
+    /// Queue an update without waking the UI loop
+    pub(crate) fn enqueue(&self, value: T) -> Result<(), T> {
+        let mut pos = self.head.load(Ordering::Relaxed);
+        loop {
+            let (slot, seq) = self.seq(pos);
+            match seq.wrapping_sub(pos) as isize {
+                0 => match self.head.compare_exchange_weak(
+                    pos,
+                    pos.wrapping_add(1),
+                    Ordering::Relaxed,
+                    Ordering::Relaxed,
+                ) {
+                    Ok(_) => {
+                        unsafe { (*slot.value.get()).write(value) };
+                        Self::set_seq(slot, pos, pos.wrapping_add(1));
+                        return Ok(());
+                    }
+                    Err(current) => pos = current,
+                },
+                diff if diff < 0 => return Err(value),
+                _ => pos = self.head.load(Ordering::Relaxed),
+            }
+        }
+    }
+
+    /// Take the oldest update, if any
+    pub fn pop(&self) -> Option<T> {
+        let mut pos = self.tail.load(Ordering::Relaxed);
+        loop {
+            let (slot, seq) = self.seq(pos);
+            match seq.wrapping_sub(pos.wrapping_add(1)) as isize {
+                0 => match self.tail.compare_exchange_weak(
+                    pos,
+                    pos.wrapping_add(1),
+                    Ordering::Relaxed,
+                    Ordering::Relaxed,
+                ) {
+                    Ok(_) => {
+                        let value = unsafe { (*slot.value.get()).assume_init_read() };
+                        Self::set_seq(slot, pos, pos.wrapping_add(N));
+                        return Some(value);
+                    }
+                    Err(current) => pos = current,
+                },
+                diff if diff < 0 => return None,
+                _ => pos = self.tail.load(Ordering::Relaxed),
+            }
+        }
+    }
+
+    /// Apply all queued updates with `apply`.
+    ///
+    /// Updates posted while draining are applied too, up to `N` of them, so
+    /// a fast producer cannot keep the LVGL thread here forever. Returns the
+    /// number of updates applied.
+    pub fn drain(&self, mut apply: impl FnMut(T)) -> usize {
+        let mut count = 0;
+        while count < N {
+            let Some(value) = self.pop() else {
+                break;
+            };
+            apply(value);
+            count += 1;
+        }
+        count
+    }
+
+    /// Check if no updates are queued
+    pub fn is_empty(&self) -> bool {
+        let pos = self.tail.load(Ordering::Relaxed);
+        let (_, seq) = self.seq(pos);
+        seq != pos.wrapping_add(1)
+    }
+
+    /// Queue capacity
+    pub const fn capacity(&self) -> usize {
+        N
+    }
+}
+
+impl<T, const N: usize> Default for UiQueue<T, N> {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl<T, const N: usize> Drop for UiQueue<T, N> {
+    fn drop(&mut self) {
+        while self.pop().is_some() {}
+    }
+}
@@ -3,6 +3,7 @@
 //! LVGL timers allow you to execute periodic tasks. This module provides:
 //!
 //! - `Timer` - A periodic callback timer
+//! - `TimerService` - Pooled, coalesced periodic callbacks (requires `alloc`)
 //!
 //! # Example
 //!
@@ -112,8 +113,12 @@ impl Timer {
     }
 
     /// Set the callback function
+    ///
+    /// A closure set with [`Timer::new`] or [`Timer::set_closure`] is freed.
     pub fn set_cb(&self, cb: TimerCb) {
         unsafe {
+            #[cfg(feature = "alloc")]
+            closure_support::release(self.raw.as_ptr());
             neo_lvgl_sys::lv_timer_set_cb(self.raw.as_ptr(), Some(cb));
         }
     }
@@ -139,8 +144,14 @@ impl Timer {
     }
 
     /// Set user data
+    ///
+    /// A closure set with [`Timer::new`] or [`Timer::set_closure`] lives in
+    /// the user data; it is freed and the timer has no callback until
+    /// [`set_cb`](Self::set_cb).
     pub fn set_user_data(&self, data: *mut c_void) {
         unsafe {
+            #[cfg(feature = "alloc")]
+            closure_support::release(self.raw.as_ptr());
             neo_lvgl_sys::lv_timer_set_user_data(self.raw.as_ptr(), data);
         }
     }
@@ -152,9 +163,13 @@ impl Timer {
 
     /// Delete the timer
     ///
-    /// This consumes the Timer, preventing further use.
+    /// This consumes the Timer, preventing further use. A closure set with
+    /// [`Timer::new`] or [`Timer::set_closure`] is freed with it, as it is
+    /// when LVGL auto-deletes the timer after its last repeat.
     pub fn delete(self) {
         unsafe {
+            #[cfg(feature = "alloc")]
+            closure_support::release(self.raw.as_ptr());
             neo_lvgl_sys::lv_timer_delete(self.raw.as_ptr());
         }
         // Don't run Drop since we've already deleted
@@ -178,24 +193,58 @@ mod closure_support {
     /// Container for timer closure
     struct TimerClosure {
         callback: Box<dyn FnMut()>,
+        /// The callback is on the stack; see [`release`]
+        running: bool,
+        /// Released while running; freed when the callback returns
+        released: bool,
+    }
+
+    impl TimerClosure {
+        fn new(callback: impl FnMut() + 'static) -> *mut Self {
+            Box::into_raw(Box::new(Self {
+                callback: Box::new(callback),
+                running: false,
+                released: false,
+            }))
+        }
     }
 
     /// Trampoline for closure callbacks
     unsafe extern "C" fn closure_trampoline(timer: *mut neo_lvgl_sys::lv_timer_t) {
-        let user_data = neo_lvgl_sys::lv_timer_get_user_data(timer);
-        if !user_data.is_null() {
-            let closure = &mut *(user_data as *mut TimerClosure);
-            (closure.callback)();
+        #[cfg(feature = "profiling")]
+        let _span = crate::profiling::Span::enter(crate::profiling::Site::Timer);
+        let closure = neo_lvgl_sys::lv_timer_get_user_data(timer) as *mut TimerClosure;
+        if closure.is_null() {
+            return;
+        }
+        (*closure).running = true;
+        ((*closure).callback)();
+        (*closure).running = false;
+        if (*closure).released {
+            // Replaced or deleted by the callback; the timer may be gone
+            drop(Box::from_raw(closure));
+        } else if (*timer).repeat_count == 0 && (*timer).auto_delete() != 0 {
+            // LVGL deletes the timer right after this last run
+            neo_lvgl_sys::lv_timer_set_user_data(timer, core::ptr::null_mut());
+            drop(Box::from_raw(closure));
         }
     }
 
-    /// Trampoline that also cleans up on delete
-    #[allow(dead_code)]
-    unsafe extern "C" fn cleanup_trampoline(timer: *mut neo_lvgl_sys::lv_timer_t) {
-        let user_data = neo_lvgl_sys::lv_timer_get_user_data(timer);
-        if !user_data.is_null() {
-            // Drop the boxed closure
-            let _ = Box::from_raw(user_data as *mut TimerClosure);
+    /// Free the closure of `timer`, if it has one, and remove its callback
+    ///
+    /// A closure that is running is freed by the trampoline once it returns.
+    pub(super) unsafe fn release(timer: *mut neo_lvgl_sys::lv_timer_t) {
+        let ours = (*timer).timer_cb.map(|cb| cb as usize) == Some(closure_trampoline as usize);
+        let closure = neo_lvgl_sys::lv_timer_get_user_data(timer) as *mut TimerClosure;
+        if !ours || closure.is_null() {
+            return;
+        }
+        neo_lvgl_sys::lv_timer_set_user_data(timer, core::ptr::null_mut());
+        neo_lvgl_sys::lv_timer_set_cb(timer, None);
+        if (*closure).running {
+            (*closure).released = true;
+        } else {
+            drop(Box::from_raw(closure));
         }
     }
 
@@ -213,43 +262,345 @@ mod closure_support {
         where
             F: FnMut() + 'static,
         {
-            let closure = Box::new(TimerClosure {
-                callback: Box::new(callback),
-            });
-            let raw_closure = Box::into_raw(closure);
-
+            let closure = TimerClosure::new(callback);
             let ptr = unsafe {
                 neo_lvgl_sys::lv_timer_create(
                     Some(closure_trampoline),
                     period_ms,
-                    raw_closure as *mut c_void,
+                    closure as *mut c_void,
                 )
             };
+            if ptr.is_null() {
+                unsafe { drop(Box::from_raw(closure)) };
+            }
 
             NonNull::new(ptr).map(|raw| Self { raw })
         }
 
         /// Set callback using a closure
         ///
-        /// Note: This will leak the previous closure if one was set.
-        /// For best results, use this only once or manage the closure lifetime manually.
+        /// The previous closure is freed, after it returns if this is called
+        /// from inside it.
         pub fn set_closure<F>(&self, callback: F)
         where
             F: FnMut() + 'static,
         {
-            let closure = Box::new(TimerClosure {
-                callback: Box::new(callback),
-            });
-            let raw_closure = Box::into_raw(closure);
-
+            let closure = TimerClosure::new(callback);
             unsafe {
+                release(self.raw.as_ptr());
                 neo_lvgl_sys::lv_timer_set_cb(self.raw.as_ptr(), Some(closure_trampoline));
-                neo_lvgl_sys::lv_timer_set_user_data(self.raw.as_ptr(), raw_closure as *mut c_void);
+                neo_lvgl_sys::lv_timer_set_user_data(self.raw.as_ptr(), closure as *mut c_void);
             }
         }
     }
 }
 
+/// Handle to a callback registered with a [`TimerService`]
+#[cfg(feature = "alloc")]
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub struct TimerId {
+    index: usize,
+    generation: u32,
+}
+
+/// Bytes of captured state a [`TimerService`] slot holds without allocating
+#[cfg(feature = "alloc")]
+const INLINE_BYTES: usize = 4 * core::mem::size_of::<usize>();
+
+/// A `FnMut()` stored in place, or boxed if it captures more than
+/// [`INLINE_BYTES`]
+#[cfg(feature = "alloc")]
+struct InlineCallback {
+    data: [core::mem::MaybeUninit<usize>; INLINE_BYTES / core::mem::size_of::<usize>()],
+    call: unsafe fn(*mut c_void),
+    drop: unsafe fn(*mut c_void),
+}
+
+#[cfg(feature = "alloc")]
+impl InlineCallback {
+    fn new<F: FnMut() + 'static>(callback: F) -> Self {
+        if core::mem::size_of::<F>() <= INLINE_BYTES
+            && core::mem::align_of::<F>() <= core::mem::align_of::<usize>()
+        {
+            Self::store(callback)
+        } else {
+            Self::store(Box::new(callback))
+        }
+    }
+
+    fn store<F: FnMut() + 'static>(callback: F) -> Self {
+        unsafe fn call<F: FnMut()>(data: *mut c_void) {
+            (*(data as *mut F))()
+        }
+        unsafe fn drop<F>(data: *mut c_void) {
+            core::ptr::drop_in_place(data as *mut F)
+        }
+        debug_assert!(core::mem::size_of::<F>() <= INLINE_BYTES);
+        let mut cb = Self {
+            data: [core::mem::MaybeUninit::uninit(); INLINE_BYTES / core::mem::size_of::<usize>()],
+            call: call::<F>,
+            drop: drop::<F>,
+        };
+        unsafe { core::ptr::write(cb.data.as_mut_ptr() as *mut F, callback) };
+        cb
+    }
+
+    fn call(&mut self) {
+        unsafe { (self.call)(self.data.as_mut_ptr().cast()) }
+    }
+}
+
+#[cfg(feature = "alloc")]
+impl Drop for InlineCallback {
+    fn drop(&mut self) {
+        unsafe { (self.drop)(self.data.as_mut_ptr().cast()) }
+    }
+}
+
+#[cfg(feature = "alloc")]
+struct TimerSlot {
+    callback: Option<InlineCallback>,
+    period: u32,
+    due: u32,
+    generation: u32,
+    active: bool,
+}
+
+#[cfg(feature = "alloc")]
+struct ServiceInner<const N: usize> {
+    timer: *mut neo_lvgl_sys::lv_timer_t,
+    slack_ms: u32,
+    slots: [TimerSlot; N],
+}
+
+/// Many periodic callbacks driven by a single LVGL timer
+///
+/// Callbacks live in a fixed slab of `N` slots and are freed when they are
+/// cancelled or the service is dropped. Closures capturing up to four
+/// pointers' worth of state are stored in the slot itself, so adding them
+/// does not allocate; larger ones are boxed. Due times are aligned to multiples
+/// of their period, so callbacks with equal or dividing periods (e.g. 50,
+/// 100, 250 and 1000 ms) fire in the same wakeup. Callbacks due within
+/// `slack_ms` of each other are run together as well.
+///
+/// The underlying LVGL timer's period always matches the next due time, so
+/// [`timer_get_time_until_next`] and the value returned by `task_handler()`
+/// are exact and a tickless loop can sleep until then.
+///
+/// # Example
+///
+/// ```ignore
+/// let timers = TimerService::<16>::new(5).unwrap();
+/// let temp = timers.add(250, || refresh_temperature()).unwrap();
+/// timers.add(1000, || refresh_battery());
+/// timers.cancel(temp);
+/// ```
+#[cfg(feature = "alloc")]
+pub struct TimerService<const N: usize> {
+    inner: Box<core::cell::UnsafeCell<ServiceInner<N>>>,
+}
+
+#[cfg(feature = "alloc")]
+impl<const N: usize> TimerService<N> {
+    /// Create a service that coalesces callbacks due within `slack_ms`
+    pub fn new(slack_ms: u32) -> Option<Self> {
+        let inner = Box::new(core::cell::UnsafeCell::new(ServiceInner {
+            timer: core::ptr::null_mut(),
+            slack_ms,
+            slots: core::array::from_fn(|_| TimerSlot {
+                callback: None,
+                period: 0,
+                due: 0,
+                generation: 0,
+                active: false,
+            }),
+        }));
+        let timer = unsafe {
+            neo_lvgl_sys::lv_timer_create(
+                Some(service_trampoline::<N>),
+                u32::MAX,
+                inner.get() as *mut c_void,
+            )
+        };
+        if timer.is_null() {
+            return None;
+        }
+        unsafe {
+            neo_lvgl_sys::lv_timer_pause(timer);
+            (*inner.get()).timer = timer;
+        }
+        Some(Self { inner })
+    }
+
+    /// Register `callback` to run every `period_ms` milliseconds.
+    ///
+    /// Returns `None` if all `N` slots are in use.
+    pub fn add<F>(&self, period_ms: u32, callback: F) -> Option<TimerId>
+    where
+        F: FnMut() + 'static,
+    {
+        let period = period_ms.max(1);
+        let now = unsafe { neo_lvgl_sys::lv_tick_get() };
+        let inner = self.inner.get();
+        let id = unsafe {
+            let (index, slot) = (*inner)
+                .slots
+                .iter_mut()
+                .enumerate()
+                .find(|(_, s)| !s.active)?;
+            slot.callback = Some(InlineCallback::new(callback));
+            slot.period = period;
+            // Align to the period so timers sharing it fire together
+            slot.due = now.wrapping_sub(now % period).wrapping_add(period);
+            slot.active = true;
+            TimerId {
+                index,
+                generation: slot.generation,
+            }
+        };
+        unsafe { reschedule(inner, now) };
+        Some(id)
+    }
+
+    /// Remove a callback and free it.
+    ///
+    /// Returns `false` if `id` was already cancelled.
+    pub fn cancel(&self, id: TimerId) -> bool {
+        let inner = self.inner.get();
+        let removed = unsafe {
+            match (*inner).slots.get_mut(id.index) {
+                Some(slot) if slot.active && slot.generation == id.generation => {
+                    slot.active = false;
+                    slot.generation = slot.generation.wrapping_add(1);
+                    // Dropped after the borrow; may be None while running
+                    Some(slot.callback.take())
+                }
+                _ => None,
+            }
+        };
+        let Some(callback) = removed else {
+            return false;
+        };
+        drop(callback);
+        unsafe { reschedule(inner, neo_lvgl_sys::lv_tick_get()) };
+        true
+    }
+
+    /// Change the period of a callback, re-aligning its next due time
+    pub fn set_period(&self, id: TimerId, period_ms: u32) -> bool {
+        let period = period_ms.max(1);
+        let now = unsafe { neo_lvgl_sys::lv_tick_get() };
+        let inner = self.inner.get();
+        unsafe {
+            match (*inner).slots.get_mut(id.index) {
+                Some(slot) if slot.active && slot.generation == id.generation => {
+                    slot.period = period;
+                    slot.due = now.wrapping_sub(now % period).wrapping_add(period);
+                }
+                _ => return false,
+            }
+            reschedule(inner, now);
+        }
+        true
+    }
+
+    /// Number of registered callbacks
+    pub fn len(&self) -> usize {
+        unsafe {
+            (*self.inner.get())
+                .slots
+                .iter()
+                .filter(|s| s.active)
+                .count()
+        }
+    }
+
+    /// Check if no callbacks are registered
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// Milliseconds until the next callback is due, or `None` if idle
+    pub fn time_until_next(&self) -> Option<u32> {
+        let now = unsafe { neo_lvgl_sys::lv_tick_get() };
+        unsafe { next_delay(self.inner.get(), now) }
+    }
+}
+
+#[cfg(feature = "alloc")]
+impl<const N: usize> Drop for TimerService<N> {
+    fn drop(&mut self) {
+        unsafe {
+            neo_lvgl_sys::lv_timer_delete(self.inner.get_mut().timer);
+        }
+    }
+}
+
+/// Delay until the earliest active slot is due
+#[cfg(feature = "alloc")]
+unsafe fn next_delay<const N: usize>(inner: *mut ServiceInner<N>, now: u32) -> Option<u32> {
+    (*inner)
+        .slots
+        .iter()
+        .filter(|s| s.active)
+        .map(|s| (s.due.wrapping_sub(now) as i32).max(0) as u32)
+        .min()
+}
+
+/// Set the LVGL timer to fire exactly when the next slot is due
+#[cfg(feature = "alloc")]
+unsafe fn reschedule<const N: usize>(inner: *mut ServiceInner<N>, now: u32) {
+    let timer = (*inner).timer;
+    match next_delay(inner, now) {
+        Some(delay) => {
+            neo_lvgl_sys::lv_timer_set_period(timer, delay.max(1));
+            neo_lvgl_sys::lv_timer_reset(timer);
+            neo_lvgl_sys::lv_timer_resume(timer);
+        }
+        None => neo_lvgl_sys::lv_timer_pause(timer),
+    }
+}
+
+#[cfg(feature = "alloc")]
+unsafe extern "C" fn service_trampoline<const N: usize>(timer: *mut neo_lvgl_sys::lv_timer_t) {
+    #[cfg(feature = "profiling")]
+    let _span = crate::profiling::Span::enter(crate::profiling::Site::Timer);
+    let inner = neo_lvgl_sys::lv_timer_get_user_data(timer) as *mut ServiceInner<N>;
+    if inner.is_null() {
+        return;
+    }
+    let now = neo_lvgl_sys::lv_tick_get();
+    let horizon = now.wrapping_add((*inner).slack_ms);
+
+    for index in 0..N {
+        // Take the callback out so it may add or cancel timers while running
+        let taken = {
+            let slot = &mut (*inner).slots[index];
+            if !slot.active || (horizon.wrapping_sub(slot.due) as i32) < 0 {
+                continue;
+            }
+            // Skip missed periods but keep the phase
+            let late = now.wrapping_sub(slot.due) as i32;
+            let periods = if late < 0 {
+                1
+            } else {
+                late as u32 / slot.period + 1
+            };
+            slot.due = slot.due.wrapping_add(periods.wrapping_mul(slot.period));
+            slot.callback.take().map(|cb| (cb, slot.generation))
+        };
+        if let Some((mut callback, generation)) = taken {
+            callback.call();
+            let slot = &mut (*inner).slots[index];
+            if slot.active && slot.generation == generation {
+                slot.callback = Some(callback);
+            }
+        }
+    }
+
+    reschedule(inner, neo_lvgl_sys::lv_tick_get());
+}
+
 // Global timer functions
 
 /// Enable or disable all LVGL timers
@@ -1,8 +1,38 @@
 //! Canvas widget
+//!
+//! Besides LVGL's per-pixel calls, a canvas offers two bulk paths:
+//!
+//! - [`Canvas::pixels`] borrows the buffer as typed rows (`&mut [Rgb565]`),
+//!   with row blits, scrolling, palette mapping and format conversion. Only
+//!   the touched rectangle is invalidated when the view is dropped.
+//! - [`Canvas::draw`] records many shapes into one canvas layer and renders
+//!   them in a single pass.
+//!
+//! # Example
+//!
+//! ```ignore
+//! use lvgl::pixel::Rgb565;
+//!
+//! // Waterfall: shift history down one row, add the newest spectrum on top
+//! let mut px = canvas.pixels::<Rgb565>().unwrap();
+//! px.scroll_down(1, Rgb565(0));
+//! px.blit_indexed(0, 0, &magnitudes, &HEATMAP);
+//! drop(px); // invalidates the canvas area once
+//!
+//! canvas.draw(|layer| {
+//!     for (i, peak) in peaks.iter().enumerate() {
+//!         layer.line(Point::new(i as i32, 0), Point::new(i as i32, *peak), 1, Color::white(), Opacity::COVER);
+//!     }
+//! });
+//! ```
 
-use super::{Obj, Widget};
+use super::{Obj, Point, Widget};
 use crate::color::{Color, Opacity};
+use crate::display::Area;
 use crate::event::EventHandler;
+use crate::pixel::{self, Pixel};
+use core::mem::MaybeUninit;
+use core::ptr::NonNull;
 
 /// Color format for canvas buffer
 #[derive(Clone, Copy, Debug, PartialEq, Eq)]
@@ -135,6 +165,352 @@ impl<'a> Canvas<'a> {
             neo_lvgl_sys::lv_canvas_set_palette(self.obj.raw(), index, color32);
         }
     }
+
+    /// Borrow the canvas buffer as rows of `P` pixels.
+    ///
+    /// Returns `None` if no buffer is set, its format is not `P::FORMAT`, or
+    /// another view or [`draw`](Self::draw) is using it. Dropping the view
+    /// invalidates only the area it modified.
+    pub fn pixels<P: Pixel>(&self) -> Option<CanvasPixels<'_, P>> {
+        unsafe {
+            let buf = NonNull::new(neo_lvgl_sys::lv_canvas_get_draw_buf(self.obj.raw()))?;
+            let raw = &mut *buf.as_ptr();
+            let size = core::mem::size_of::<P>();
+            let stride = raw.header.stride() as usize;
+            if raw.data.is_null()
+                || raw.header.cf() != P::FORMAT.to_raw() as _
+                || stride % size != 0
+                || raw.data as usize % core::mem::align_of::<P>() != 0
+                || !lock(raw)
+            {
+                return None;
+            }
+            let (width, height) = (raw.header.w() as usize, raw.header.h() as usize);
+            let stride = stride / size;
+            let len = stride * height;
+            Some(CanvasPixels {
+                obj: self.obj.raw(),
+                buf,
+                pixels: core::slice::from_raw_parts_mut(raw.data as *mut P, len),
+                width,
+                height,
+                stride,
+                dirty: None,
+            })
+        }
+    }
+
+    /// Draw shapes into the canvas in one layer pass.
+    ///
+    /// Everything `f` adds to the layer is rendered into the buffer when it
+    /// returns, and the canvas is invalidated once. Returns `None` without
+    /// calling `f` if no buffer is set or a [`pixels`](Self::pixels) view is
+    /// live.
+    pub fn draw<R>(&self, f: impl FnOnce(&mut CanvasLayer<'_>) -> R) -> Option<R> {
+        unsafe {
+            let buf = neo_lvgl_sys::lv_canvas_get_draw_buf(self.obj.raw());
+            if buf.is_null() || !lock(&mut *buf) {
+                return None;
+            }
+            let mut layer = MaybeUninit::<neo_lvgl_sys::lv_layer_t>::zeroed().assume_init();
+            neo_lvgl_sys::lv_canvas_init_layer(self.obj.raw(), &mut layer);
+            let result = f(&mut CanvasLayer { layer: &mut layer });
+            neo_lvgl_sys::lv_canvas_finish_layer(self.obj.raw(), &mut layer);
+            unlock(&mut *buf);
+            Some(result)
+        }
+    }
+}
+
+/// Image header flag marking a canvas buffer as borrowed
+const BORROWED: u32 = neo_lvgl_sys::lv_image_flags_t_LV_IMAGE_FLAGS_USER8 as u32;
+
+/// Claim `buf` for exclusive access
+fn lock(buf: &mut neo_lvgl_sys::lv_draw_buf_t) -> bool {
+    let flags = buf.header.flags() as u32;
+    if flags & BORROWED != 0 {
+        return false;
+    }
+    buf.header.set_flags((flags | BORROWED) as _);
+    true
+}
+
+fn unlock(buf: &mut neo_lvgl_sys::lv_draw_buf_t) {
+    let flags = buf.header.flags() as u32;
+    buf.header.set_flags((flags & !BORROWED) as _);
+}
+
+/// Typed, exclusive view of a canvas buffer
+///
+/// Obtained from [`Canvas::pixels`]. Coordinates are in canvas pixels; runs
+/// that fall partly outside the canvas are clipped. Writes are tracked as a
+/// dirty rectangle that is flushed and invalidated on drop.
+pub struct CanvasPixels<'c, P: Pixel> {
+    obj: *mut neo_lvgl_sys::lv_obj_t,
+    buf: NonNull<neo_lvgl_sys::lv_draw_buf_t>,
+    pixels: &'c mut [P],
+    width: usize,
+    height: usize,
+    /// Pixels per row, `>= width`
+    stride: usize,
+    dirty: Option<Area>,
+}
+
+impl<P: Pixel> CanvasPixels<'_, P> {
+    /// Width in pixels
+    pub fn width(&self) -> usize {
+        self.width
+    }
+
+    /// Height in pixels
+    pub fn height(&self) -> usize {
+        self.height
+    }
+
+    /// Distance between rows in pixels
+    pub fn stride(&self) -> usize {
+        self.stride
+    }
+
+    /// Pixels of row `y`
+    pub fn row(&self, y: usize) -> &[P] {
+        &self.pixels[y * self.stride..][..self.width]
+    }
+
+    /// Pixels of row `y` for writing; the whole row is marked dirty
+    pub fn row_mut(&mut self, y: usize) -> &mut [P] {
+        assert!(y < self.height, "row out of range");
+        self.mark(0, y, self.width, 1);
+        &mut self.pixels[y * self.stride..][..self.width]
+    }
+
+    /// Read one pixel
+    pub fn get(&self, x: usize, y: usize) -> Option<P> {
+        if x < self.width && y < self.height {
+            Some(self.pixels[y * self.stride + x])
+        } else {
+            None
+        }
+    }
+
+    /// Write one pixel (ignored outside the canvas)
+    pub fn set(&mut self, x: usize, y: usize, px: P) {
+        if x < self.width && y < self.height {
+            self.pixels[y * self.stride + x] = px;
+            self.mark(x, y, 1, 1);
+        }
+    }
+
+    /// Fill the whole canvas
+    pub fn fill(&mut self, px: P) {
+        self.fill_rect(0, 0, self.width, self.height, px);
+    }
+
+    /// Fill a `w`×`h` rectangle at (`x`, `y`)
+    pub fn fill_rect(&mut self, x: usize, y: usize, w: usize, h: usize, px: P) {
+        let w = w.min(self.width.saturating_sub(x));
+        let h = h.min(self.height.saturating_sub(y));
+        if w == 0 || h == 0 {
+            return;
+        }
+        for row in y..y + h {
+            self.pixels[row * self.stride + x..][..w].fill(px);
+        }
+        self.mark(x, y, w, h);
+    }
+
+    /// Copy `src` into row `y` starting at column `x`
+    pub fn blit_row(&mut self, x: i32, y: i32, src: &[P]) {
+        if let Some((start, skip, count)) = self.clip(x, y, src.len()) {
+            self.pixels[start..][..count].copy_from_slice(&src[skip..][..count]);
+        }
+    }
+
+    /// Convert `src` from another format into row `y` starting at column `x`
+    pub fn blit_convert<S: Pixel>(&mut self, x: i32, y: i32, src: &[S])
+    where
+        P: From<S>,
+    {
+        if let Some((start, skip, count)) = self.clip(x, y, src.len()) {
+            pixel::convert(&src[skip..][..count], &mut self.pixels[start..][..count]);
+        }
+    }
+
+    /// Map 8-bit `indices` through `palette` into row `y` starting at
+    /// column `x`
+    pub fn blit_indexed(&mut self, x: i32, y: i32, indices: &[u8], palette: &[P; 256]) {
+        if let Some((start, skip, count)) = self.clip(x, y, indices.len()) {
+            pixel::map_indexed(
+                &indices[skip..][..count],
+                palette,
+                &mut self.pixels[start..][..count],
+            );
+        }
+    }
+
+    /// Move the content up by `rows`, filling the rows freed at the bottom
+    pub fn scroll_up(&mut self, rows: usize, fill: P) {
+        let rows = rows.min(self.height);
+        let keep = self.height - rows;
+        self.pixels
+            .copy_within(rows * self.stride..self.height * self.stride, 0);
+        self.fill_rect(0, keep, self.width, rows, fill);
+        self.mark(0, 0, self.width, self.height);
+    }
+
+    /// Move the content down by `rows`, filling the rows freed at the top
+    pub fn scroll_down(&mut self, rows: usize, fill: P) {
+        let rows = rows.min(self.height);
+        let keep = self.height - rows;
+        self.pixels
+            .copy_within(0..keep * self.stride, rows * self.stride);
+        self.fill_rect(0, 0, self.width, rows, fill);
+        self.mark(0, 0, self.width, self.height);
+    }
+
+    /// Mark an area as modified, e.g. after writing through [`row_mut`](Self::row_mut)
+    /// in a loop that only touched part of each row
+    pub fn mark_dirty(&mut self, area: Area) {
+        self.dirty = Some(self.dirty.map_or(area, |dirty| dirty.union(&area)));
+    }
+
+    /// Area modified so far, in canvas coordinates
+    pub fn dirty(&self) -> Option<Area> {
+        self.dirty
+    }
+
+    /// Clip a `len`-pixel run at (`x`, `y`) and mark it dirty: returns the
+    /// buffer index of its first visible pixel, how many source pixels are
+    /// skipped and how many remain
+    fn clip(&mut self, x: i32, y: i32, len: usize) -> Option<(usize, usize, usize)> {
+        if y < 0 || y as usize >= self.height {
+            return None;
+        }
+        let skip = x.min(0).unsigned_abs() as usize;
+        let x = x.max(0) as usize;
+        if x >= self.width || skip >= len {
+            return None;
+        }
+        let count = (len - skip).min(self.width - x);
+        self.mark(x, y as usize, count, 1);
+        Some((y as usize * self.stride + x, skip, count))
+    }
+
+    fn mark(&mut self, x: usize, y: usize, w: usize, h: usize) {
+        if w == 0 || h == 0 {
+            return;
+        }
+        self.mark_dirty(Area::new(
+            x as i16,
+            y as i16,
+            (x + w - 1) as i16,
+            (y + h - 1) as i16,
+        ));
+    }
+}
+
+impl<P: Pixel> Drop for CanvasPixels<'_, P> {
+    fn drop(&mut self) {
+        unsafe {
+            let buf = self.buf.as_ptr();
+            unlock(&mut *buf);
+            let Some(dirty) = self.dirty else {
+                return;
+            };
+            let mut area = dirty.to_raw();
+            neo_lvgl_sys::lv_draw_buf_flush_cache(buf, &area);
+            // A rotated or zoomed canvas covers more than the changed pixels
+            let obj = self.obj;
+            let scale = neo_lvgl_sys::LV_SCALE_NONE as _;
+            if neo_lvgl_sys::lv_image_get_rotation(obj) != 0
+                || neo_lvgl_sys::lv_image_get_scale_x(obj) != scale
+                || neo_lvgl_sys::lv_image_get_scale_y(obj) != scale
+            {
+                neo_lvgl_sys::lv_obj_invalidate(obj);
+                return;
+            }
+            let mut coords = MaybeUninit::<neo_lvgl_sys::lv_area_t>::zeroed().assume_init();
+            neo_lvgl_sys::lv_obj_get_content_coords(obj, &mut coords);
+            area.x1 += coords.x1;
+            area.x2 += coords.x1;
+            area.y1 += coords.y1;
+            area.y2 += coords.y1;
+            neo_lvgl_sys::lv_obj_invalidate_area(obj, &area);
+        }
+    }
+}
+
+/// Shapes queued into a canvas layer by [`Canvas::draw`]
+///
+/// Coordinates are in canvas pixels. Other LVGL draw descriptors can be
+/// added through [`raw`](Self::raw).
+pub struct CanvasLayer<'l> {
+    layer: &'l mut neo_lvgl_sys::lv_layer_t,
+}
+
+impl CanvasLayer<'_> {
+    /// Fill a rectangle
+    pub fn fill(&mut self, area: Area, color: Color, opa: Opacity, radius: i32) {
+        unsafe {
+            let mut dsc = MaybeUninit::<neo_lvgl_sys::lv_draw_fill_dsc_t>::zeroed();
+            neo_lvgl_sys::lv_draw_fill_dsc_init(dsc.as_mut_ptr());
+            let mut dsc = dsc.assume_init();
+            dsc.color = color.to_raw();
+            dsc.opa = opa.to_raw();
+            dsc.radius = radius;
+            neo_lvgl_sys::lv_draw_fill(self.layer, &dsc, &area.to_raw());
+        }
+    }
+
+    /// Draw a straight line
+    pub fn line(&mut self, from: Point, to: Point, width: i32, color: Color, opa: Opacity) {
+        unsafe {
+            let mut dsc = MaybeUninit::<neo_lvgl_sys::lv_draw_line_dsc_t>::zeroed();
+            neo_lvgl_sys::lv_draw_line_dsc_init(dsc.as_mut_ptr());
+            let mut dsc = dsc.assume_init();
+            dsc.p1.x = from.x as _;
+            dsc.p1.y = from.y as _;
+            dsc.p2.x = to.x as _;
+            dsc.p2.y = to.y as _;
+            dsc.width = width;
+            dsc.color = color.to_raw();
+            dsc.opa = opa.to_raw();
+            neo_lvgl_sys::lv_draw_line(self.layer, &dsc);
+        }
+    }
+
+    /// Draw an arc from `start` to `end` degrees (0° at 3 o'clock, clockwise)
+    #[allow(clippy::too_many_arguments)]
+    pub fn arc(
+        &mut self,
+        center: Point,
+        radius: u16,
+        start: i32,
+        end: i32,
+        width: i32,
+        color: Color,
+        opa: Opacity,
+    ) {
+        unsafe {
+            let mut dsc = MaybeUninit::<neo_lvgl_sys::lv_draw_arc_dsc_t>::zeroed();
+            neo_lvgl_sys::lv_draw_arc_dsc_init(dsc.as_mut_ptr());
+            let mut dsc = dsc.assume_init();
+            dsc.center.x = center.x;
+            dsc.center.y = center.y;
+            dsc.radius = radius;
+            dsc.start_angle = start as _;
+            dsc.end_angle = end as _;
+            dsc.width = width;
+            dsc.color = color.to_raw();
+            dsc.opa = opa.to_raw();
+            neo_lvgl_sys::lv_draw_arc(self.layer, &dsc);
+        }
+    }
+
+    /// Get the raw layer for other `lv_draw_*` calls
+    pub fn raw(&mut self) -> *mut neo_lvgl_sys::lv_layer_t {
+        self.layer
+    }
 }
 
 impl<'a> Widget<'a> for Canvas<'a> {
@@ -3,6 +3,7 @@
 use crate::color::Color;
 use crate::event::EventHandler;
 use crate::widgets::{Obj, Widget};
+use core::cell::Cell;
 use core::ptr::NonNull;
 
 /// Chart type
@@ -74,6 +75,72 @@ impl ChartSeries {
     }
 }
 
+/// Min/max decimation for streaming more samples than the chart has pixels
+///
+/// Every `bucket` input samples are reduced to two points, the minimum and
+/// the maximum in their original order, so peaks stay visible. Partial
+/// buckets are kept until the next batch.
+///
+/// # Example
+///
+/// ```ignore
+/// // 1 kS/s into a 250 px wide chart, 4 s visible
+/// let mut decimator = MinMaxDecimator::new(8);
+/// chart.append_decimated(&series, &mut decimator, &samples);
+/// ```
+#[derive(Clone, Copy, Debug)]
+pub struct MinMaxDecimator {
+    bucket: u32,
+    count: u32,
+    min: i32,
+    max: i32,
+    min_first: bool,
+}
+
+impl MinMaxDecimator {
+    /// Create a decimator reducing `bucket` samples to 2 points
+    pub const fn new(bucket: u32) -> Self {
+        Self {
+            bucket: if bucket < 2 { 2 } else { bucket },
+            count: 0,
+            min: i32::MAX,
+            max: i32::MIN,
+            min_first: true,
+        }
+    }
+
+    /// Feed one sample, returning the point pair when a bucket completes
+    pub fn push(&mut self, value: i32) -> Option<[i32; 2]> {
+        if value < self.min {
+            self.min = value;
+            self.min_first = false;
+        }
+        if value > self.max {
+            self.max = value;
+            self.min_first = true;
+        }
+        self.count += 1;
+        if self.count < self.bucket {
+            return None;
+        }
+        let pair = if self.min_first {
+            [self.min, self.max]
+        } else {
+            [self.max, self.min]
+        };
+        self.reset();
+        Some(pair)
+    }
+
+    /// Drop the partial bucket
+    pub fn reset(&mut self) {
+        self.count = 0;
+        self.min = i32::MAX;
+        self.max = i32::MIN;
+        self.min_first = true;
+    }
+}
+
 /// Chart widget
 ///
 /// Displays data as line, bar, or scatter charts.
@@ -90,6 +157,9 @@ impl ChartSeries {
 /// chart.set_next(&series, 10);
 /// chart.set_next(&series, 25);
 /// chart.set_next(&series, 40);
+///
+/// // Streaming: one ring write and one redraw per batch
+/// chart.append(&series, &[55, 60, 58, 62]);
 /// ```
 #[derive(Clone, Copy)]
 pub struct Chart<'a> {
@@ -174,7 +244,104 @@ impl<'a> Chart<'a> {
         }
     }
 
+    /// Append values to a series, one redraw for the whole batch
+    ///
+    /// Same result as calling [`set_next`](Self::set_next) for every value,
+    /// but written straight into the series' ring buffer. Only the last
+    /// `point_count` values of `values` are kept.
+    pub fn append(&self, series: &ChartSeries, values: &[i32]) {
+        let count = self.point_count() as usize;
+        let skip = values.len().saturating_sub(count);
+        self.write_points(series, values[skip..].iter().copied());
+    }
+
+    /// Append values to a series through a min/max decimator
+    pub fn append_decimated(
+        &self,
+        series: &ChartSeries,
+        decimator: &mut MinMaxDecimator,
+        values: &[i32],
+    ) {
+        self.write_points(
+            series,
+            values.iter().filter_map(|&v| decimator.push(v)).flatten(),
+        );
+    }
+
+    fn write_points(&self, series: &ChartSeries, values: impl Iterator<Item = i32>) {
+        let count = self.point_count();
+        if count == 0 {
+            return;
+        }
+        unsafe {
+            let obj = self.obj.raw();
+            let ys = neo_lvgl_sys::lv_chart_get_series_y_array(obj, series.raw());
+            if ys.is_null() {
+                return;
+            }
+            let start = neo_lvgl_sys::lv_chart_get_x_start_point(obj, series.raw());
+            let mut next = start;
+            let mut written = false;
+            for value in values {
+                *ys.add(next as usize) = value;
+                next += 1;
+                if next == count {
+                    next = 0;
+                }
+                written = true;
+            }
+            if written {
+                neo_lvgl_sys::lv_chart_set_x_start_point(obj, series.raw(), next);
+                neo_lvgl_sys::lv_chart_refresh(obj);
+            }
+        }
+    }
+
+    /// Draw a series from a caller-owned buffer instead of copying into it
+    ///
+    /// The buffer is used as a ring of `point_count` values; write the new
+    /// samples at the positions following [`start_point`](Self::start_point)
+    /// and publish them with [`advance`](Self::advance). Convert a plain
+    /// `&mut [i32]` with `Cell::from_mut(buf).as_slice_of_cells()`.
+    ///
+    /// Returns `false` (and leaves the series alone) if `buffer` holds fewer
+    /// than `point_count` values.
+    pub fn bind_y_buffer(&self, series: &ChartSeries, buffer: &'a [Cell<i32>]) -> bool {
+        if buffer.len() < self.point_count() as usize {
+            return false;
+        }
+        unsafe {
+            // Cell<i32> has the layout of i32
+            neo_lvgl_sys::lv_chart_set_ext_y_array(
+                self.obj.raw(),
+                series.raw(),
+                buffer.as_ptr() as *mut i32,
+            );
+        }
+        true
+    }
+
+    /// Index where the next value of a series will be written
+    pub fn start_point(&self, series: &ChartSeries) -> u32 {
+        unsafe { neo_lvgl_sys::lv_chart_get_x_start_point(self.obj.raw(), series.raw()) }
+    }
+
+    /// Mark `count` values written after the start point as new and redraw
+    pub fn advance(&self, series: &ChartSeries, count: u32) {
+        let points = self.point_count();
+        if points == 0 || count == 0 {
+            return;
+        }
+        let next = (self.start_point(series) + count % points) % points;
+        unsafe {
+            neo_lvgl_sys::lv_chart_set_x_start_point(self.obj.raw(), series.raw(), next);
+            neo_lvgl_sys::lv_chart_refresh(self.obj.raw());
+        }
+    }
+
     /// Get a pointer to the Y values array
+    ///
+    /// The array holds [`point_count`](Self::point_count) values.
     pub fn get_y_array(&self, series: &ChartSeries) -> *mut i32 {
         unsafe { neo_lvgl_sys::lv_chart_get_series_y_array(self.obj.raw(), series.raw()) }
     }
@@ -1,66 +1,67 @@
 //! Extra widgets (feature-gated)
 //!
 //! These widgets provide additional functionality beyond the core widget set.
-//! Enable them via Cargo features like `widgets-extra` or individual `widget-*` features.
+//! Enable them all with `widgets-extra`, or individually with `widget-*`
+//! features; LVGL only compiles the widgets that are enabled.
 
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-calendar")]
 mod calendar;
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-chart")]
 mod chart;
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-keyboard")]
 mod keyboard;
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-led")]
 mod led;
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-list")]
 mod list;
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-menu")]
 mod menu;
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-msgbox")]
 mod msgbox;
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-scale")]
 mod scale;
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-span")]
 mod span;
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-spinbox")]
 mod spinbox;
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-spinner")]
 mod spinner;
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-table")]
 mod table;
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-tabview")]
 mod tabview;
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-tileview")]
 mod tileview;
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-window")]
 mod window;
 
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-calendar")]
 pub use calendar::{Calendar, CalendarDate};
-#[cfg(feature = "widgets-extra")]
-pub use chart::{Chart, ChartAxis, ChartSeries, ChartType};
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-chart")]
+pub use chart::{Chart, ChartAxis, ChartSeries, ChartType, MinMaxDecimator};
+#[cfg(feature = "widget-keyboard")]
 pub use keyboard::{Keyboard, KeyboardMode};
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-led")]
 pub use led::Led;
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-list")]
 pub use list::{List, ListButton, ListText};
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-menu")]
 pub use menu::{Menu, MenuPage, MenuSection, MenuSeparator};
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-msgbox")]
 pub use msgbox::MsgBox;
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-scale")]
 pub use scale::{Scale, ScaleMode, ScaleSectionDescr};
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-span")]
 pub use span::{Span, SpanGroup, SpanMode, SpanOverflow};
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-spinbox")]
 pub use spinbox::Spinbox;
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-spinner")]
 pub use spinner::Spinner;
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-table")]
 pub use table::{Table, TableCellCtrl};
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-tabview")]
 pub use tabview::{TabView, TabViewPos};
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-tileview")]
 pub use tileview::{TileView, TileViewTile};
-#[cfg(feature = "widgets-extra")]
+#[cfg(feature = "widget-window")]
 pub use window::Window;
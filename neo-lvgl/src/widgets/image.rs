@@ -173,6 +173,13 @@ impl<'a> Image<'a> {
         neo_lvgl_sys::lv_image_set_src(self.obj.raw(), src);
     }
 
+    /// Set the image source from a `'static` descriptor, path or asset
+    pub fn set_src_static(&self, src: crate::image_cache::ImageSrc) {
+        unsafe {
+            neo_lvgl_sys::lv_image_set_src(self.obj.raw(), src.raw());
+        }
+    }
+
     /// Set the image offset
     pub fn set_offset(&self, x: i32, y: i32) {
         unsafe {
@@ -6,6 +6,7 @@
 //! - `Widget` - Trait implemented by all widgets
 //! - `Screen` - The root widget for a display
 //! - Specific widget types: `Button`, `Label`, etc.
+//! - `VirtualList` - Table/list over large data sets (requires `alloc`)
 
 mod arc;
 mod bar;
@@ -22,8 +23,9 @@ mod roller;
 mod slider;
 mod switch;
 mod textarea;
+#[cfg(feature = "alloc")]
+mod virtual_list;
 
-#[cfg(feature = "widgets-extra")]
 pub mod extra;
 
 pub use arc::{Arc, ArcMode};
@@ -41,14 +43,32 @@ pub use roller::{Roller, RollerMode};
 pub use slider::{Slider, SliderMode, SliderOrientation};
 pub use switch::{Switch, SwitchOrientation};
 pub use textarea::{CursorPos, TextArea};
+#[cfg(feature = "alloc")]
+pub use virtual_list::{RowSource, VirtualList};
 
 use crate::event::EventHandler;
-use crate::style::{Style, StyleSelector};
+use crate::style::{ConstStyle, Style, StyleBatch, StyleSelector};
 use core::marker::PhantomData;
 use core::ptr::NonNull;
 
 /// Special size value that makes the widget fit its content
-pub const SIZE_CONTENT: i32 = neo_lvgl_sys::LV_COORD_MAX as i32 | (1 << 29);
+pub const SIZE_CONTENT: i32 =
+    neo_lvgl_sys::LV_COORD_MAX as i32 | neo_lvgl_sys::LV_COORD_TYPE_SPEC as i32;
+
+/// Size or position as a percentage of the parent, like `lv_pct`
+pub const fn pct(v: i32) -> i32 {
+    const POS_MAX: i32 = (neo_lvgl_sys::LV_COORD_MAX as i32 - 1) / 2;
+    let v = if v < -POS_MAX {
+        2 * POS_MAX
+    } else if v < 0 {
+        POS_MAX - v
+    } else if v > POS_MAX {
+        POS_MAX
+    } else {
+        v
+    };
+    v | neo_lvgl_sys::LV_COORD_TYPE_SPEC as i32
+}
 
 /// Base widget type
 ///
@@ -244,6 +264,13 @@ pub trait Widget<'a>: EventHandler {
         }
     }
 
+    /// Add a compile-time constant style to this widget
+    fn add_const_style(&self, style: &'static ConstStyle, selector: StyleSelector) {
+        unsafe {
+            neo_lvgl_sys::lv_obj_add_style(self.raw(), style.raw() as *mut _, selector.bits());
+        }
+    }
+
     /// Remove all styles from this widget
     fn remove_all_styles(&self) {
         unsafe {
@@ -251,6 +278,34 @@ pub trait Widget<'a>: EventHandler {
         }
     }
 
+    /// Start a style transaction on this widget and its children.
+    ///
+    /// Style changes are applied without refreshing until the returned
+    /// batch is dropped, which refreshes the whole subtree once.
+    ///
+    /// # Example
+    ///
+    /// ```ignore
+    /// {
+    ///     let _batch = screen.style_batch();
+    ///     for row in &rows {
+    ///         row.remove_all_styles();
+    ///         row.add_style(&dark_row, StyleSelector::MAIN);
+    ///     }
+    /// } // one refresh here
+    /// ```
+    fn style_batch(&self) -> StyleBatch<'_> {
+        unsafe { StyleBatch::begin(self.raw()) }
+    }
+
+    /// Apply the style changes in `f` as one transaction on this subtree.
+    ///
+    /// See [`style_batch`](Self::style_batch).
+    fn batch_styles<R>(&self, f: impl FnOnce() -> R) -> R {
+        let _batch = self.style_batch();
+        f()
+    }
+
     /// Refresh the style (call after modifying a shared style)
     fn refresh_style(&self) {
         unsafe {
@@ -346,6 +401,16 @@ pub trait Widget<'a>: EventHandler {
         }
     }
 
+    /// Render this widget and its children once and draw them from a cached
+    /// buffer until they change (see [`snapshot`](crate::snapshot))
+    #[cfg(feature = "snapshot")]
+    fn cache_layer(
+        &self,
+        format: crate::snapshot::LayerFormat,
+    ) -> Option<crate::snapshot::CachedLayer<'a>> {
+        crate::snapshot::CachedLayer::new(self.obj(), format)
+    }
+
     /// Delete the widget
     ///
     /// # Safety
@@ -0,0 +1,411 @@
+//! Virtualized list widget
+
+use crate::event::EventHandler;
+use crate::widgets::{pct, Obj, Widget};
+use alloc::boxed::Box;
+use alloc::vec::Vec;
+use core::ffi::{c_void, CStr};
+use core::ptr::NonNull;
+
+/// Rows and cells shown by a [`VirtualList`]
+pub trait RowSource {
+    /// Number of rows
+    fn row_count(&self) -> usize;
+
+    /// Number of columns (1 for a plain list)
+    fn column_count(&self) -> usize {
+        1
+    }
+
+    /// Text of a cell
+    ///
+    /// The text is displayed in place, without copying, until the row is
+    /// scrolled out or the list is refreshed, so it must stay unchanged
+    /// until then. Change data through [`VirtualList::update_source`].
+    fn cell(&self, row: usize, col: usize) -> &CStr;
+}
+
+/// Hidden slot
+const UNBOUND: usize = usize::MAX;
+/// Shown slot whose row has to be bound again
+const STALE: usize = usize::MAX - 1;
+
+struct RowSlot {
+    obj: *mut neo_lvgl_sys::lv_obj_t,
+    row: usize,
+}
+
+struct State<S> {
+    source: S,
+    row_height: i32,
+    overscan: usize,
+    column_widths: Vec<i32>,
+    /// Position and width of each column, as applied to the row objects
+    columns: Vec<(i32, i32)>,
+    slots: Vec<RowSlot>,
+}
+
+/// Scrollable list or table that only creates objects for visible rows
+///
+/// Rows are fixed-height objects with one label per column. Only the rows
+/// in view plus `overscan` rows above and below exist; while scrolling,
+/// rows leaving the view are rebound to rows entering it. Memory and setup
+/// cost depend on the viewport height, not on the row count.
+///
+/// Row objects report their data row as a delegate key, so one handler on
+/// the list covers all rows:
+///
+/// # Example
+///
+/// ```ignore
+/// struct Log(Vec<CString>);
+///
+/// impl RowSource for Log {
+///     fn row_count(&self) -> usize {
+///         self.0.len()
+///     }
+///     fn cell(&self, row: usize, _col: usize) -> &CStr {
+///         &self.0[row]
+///     }
+/// }
+///
+/// let list = VirtualList::new(&screen, Log(entries), 24).unwrap();
+/// list.set_size(320, 200);
+/// list.on_child_key(EventCode::Clicked, |_, row| show_entry(row));
+///
+/// list.update_source(|log| log.0.push(c"new entry".into()));
+/// ```
+pub struct VirtualList<'a, S: RowSource + 'static> {
+    obj: Obj<'a>,
+    state: NonNull<State<S>>,
+}
+
+impl<S: RowSource + 'static> Clone for VirtualList<'_, S> {
+    fn clone(&self) -> Self {
+        *self
+    }
+}
+
+impl<S: RowSource + 'static> Copy for VirtualList<'_, S> {}
+
+impl<'a, S: RowSource + 'static> VirtualList<'a, S> {
+    /// Create a virtualized list showing `source` in rows of `row_height`
+    /// pixels.
+    ///
+    /// The list owns the source; it is dropped with the list object.
+    pub fn new(parent: &'a impl Widget<'a>, source: S, row_height: i32) -> Option<Self> {
+        let obj = Obj::new(parent)?;
+        let state = Box::into_raw(Box::new(State {
+            source,
+            row_height: row_height.max(1),
+            overscan: 2,
+            column_widths: Vec::new(),
+            columns: Vec::new(),
+            slots: Vec::new(),
+        }));
+        unsafe {
+            let raw = obj.raw();
+            let data = state as *mut c_void;
+            for code in [
+                neo_lvgl_sys::lv_event_code_t_LV_EVENT_SCROLL,
+                neo_lvgl_sys::lv_event_code_t_LV_EVENT_SIZE_CHANGED,
+                neo_lvgl_sys::lv_event_code_t_LV_EVENT_GET_SELF_SIZE,
+                neo_lvgl_sys::lv_event_code_t_LV_EVENT_DELETE,
+            ] {
+                neo_lvgl_sys::lv_obj_add_event_cb(raw, Some(list_event_cb::<S>), code, data);
+            }
+            neo_lvgl_sys::lv_obj_set_scroll_dir(raw, neo_lvgl_sys::lv_dir_t_LV_DIR_VER);
+        }
+        let list = Self {
+            obj,
+            state: unsafe { NonNull::new_unchecked(state) },
+        };
+        list.refresh();
+        Some(list)
+    }
+
+    /// Set how many rows to keep ready above and below the view (default 2)
+    pub fn set_overscan(&self, rows: usize) {
+        unsafe { (*self.state.as_ptr()).overscan = rows };
+        self.refresh();
+    }
+
+    /// Set the width of a column in pixels
+    ///
+    /// Columns without a width share the remaining space equally.
+    pub fn set_column_width(&self, col: usize, width: i32) {
+        unsafe {
+            let widths = &mut (*self.state.as_ptr()).column_widths;
+            if widths.len() <= col {
+                widths.resize(col + 1, 0);
+            }
+            widths[col] = width;
+        }
+        self.refresh();
+    }
+
+    /// Access the source
+    pub fn source(&self) -> &S {
+        unsafe { &(*self.state.as_ptr()).source }
+    }
+
+    /// Change the source and show the result.
+    pub fn update_source<R>(&self, f: impl FnOnce(&mut S) -> R) -> R {
+        let result = f(unsafe { &mut (*self.state.as_ptr()).source });
+        self.refresh();
+        result
+    }
+
+    /// Rebind all visible rows, e.g. after the data changed in place
+    pub fn refresh(&self) {
+        unsafe {
+            let state = &mut *self.state.as_ptr();
+            neo_lvgl_sys::lv_obj_refresh_self_size(self.obj.raw());
+            relayout(self.obj.raw(), state);
+            mark_stale(state);
+            update(self.obj.raw(), state);
+        }
+    }
+
+    /// Scroll so that `row` is at the top of the view
+    pub fn scroll_to_row(&self, row: usize, anim: bool) {
+        let y = row as i32 * unsafe { (*self.state.as_ptr()).row_height };
+        unsafe {
+            neo_lvgl_sys::lv_obj_scroll_to_y(self.obj.raw(), y, anim);
+        }
+    }
+
+    /// Number of row objects currently allocated
+    pub fn pool_size(&self) -> usize {
+        unsafe { (*self.state.as_ptr()).slots.len() }
+    }
+}
+
+impl<'a, S: RowSource + 'static> Widget<'a> for VirtualList<'a, S> {
+    fn obj(&self) -> &Obj<'a> {
+        &self.obj
+    }
+}
+
+impl<S: RowSource + 'static> EventHandler for VirtualList<'_, S> {
+    fn obj_raw(&self) -> *mut neo_lvgl_sys::lv_obj_t {
+        self.obj.raw()
+    }
+}
+
+unsafe extern "C" fn list_event_cb<S: RowSource>(e: *mut neo_lvgl_sys::lv_event_t) {
+    let state = neo_lvgl_sys::lv_event_get_user_data(e) as *mut State<S>;
+    let obj = neo_lvgl_sys::lv_event_get_current_target(e) as *mut neo_lvgl_sys::lv_obj_t;
+    match neo_lvgl_sys::lv_event_get_code(e) {
+        neo_lvgl_sys::lv_event_code_t_LV_EVENT_GET_SELF_SIZE => {
+            let size = neo_lvgl_sys::lv_event_get_param(e) as *mut neo_lvgl_sys::lv_point_t;
+            let state = &*state;
+            let height = (state.source.row_count() as i64 * state.row_height as i64)
+                .min(neo_lvgl_sys::LV_COORD_MAX as i64) as i32;
+            (*size).y = (*size).y.max(height);
+        }
+        neo_lvgl_sys::lv_event_code_t_LV_EVENT_DELETE => {
+            // The row objects are children and deleted by LVGL
+            drop(Box::from_raw(state));
+        }
+        neo_lvgl_sys::lv_event_code_t_LV_EVENT_SIZE_CHANGED => {
+            let state = &mut *state;
+            relayout(obj, state);
+            update(obj, state);
+        }
+        _ => update(obj, &mut *state),
+    }
+}
+
+/// Mark every shown slot for rebinding
+fn mark_stale<S>(state: &mut State<S>) {
+    for slot in &mut state.slots {
+        if slot.row != UNBOUND {
+            slot.row = STALE;
+        }
+    }
+}
+
+/// Fit the row pool and columns to the size of the list
+///
+/// Row objects are kept: labels are only added, removed or moved when the
+/// column layout changes, and only rows beyond what the view can show at
+/// any scroll position are deleted. Missing rows are created by [`update`].
+unsafe fn relayout<S: RowSource>(obj: *mut neo_lvgl_sys::lv_obj_t, state: &mut State<S>) {
+    let columns = column_layout(obj, state);
+    let mut remap = false;
+    if columns != state.columns {
+        for slot in &state.slots {
+            // Resizing a label measures its text, which may be gone by now
+            clear_row(slot.obj);
+            layout_row(slot.obj, &columns);
+        }
+        state.columns = columns;
+        remap = true;
+    }
+
+    // Rows of the view, one partly visible row at each edge and the overscan
+    let view = neo_lvgl_sys::lv_obj_get_content_height(obj).max(0);
+    let pool =
+        ((view / state.row_height) as usize + 2 + 2 * state.overscan).min(state.source.row_count());
+    if state.slots.len() > pool {
+        for slot in state.slots.drain(pool..) {
+            clear_row(slot.obj);
+            neo_lvgl_sys::lv_obj_delete(slot.obj);
+        }
+        remap = true;
+    }
+
+    if remap {
+        mark_stale(state);
+    }
+}
+
+/// Bind the rows in view (plus overscan) to row objects
+unsafe fn update<S: RowSource>(obj: *mut neo_lvgl_sys::lv_obj_t, state: &mut State<S>) {
+    let count = state.source.row_count();
+    let height = state.row_height;
+    let scroll = neo_lvgl_sys::lv_obj_get_scroll_y(obj).max(0);
+    let view = neo_lvgl_sys::lv_obj_get_content_height(obj).max(0);
+
+    let first = ((scroll / height) as usize).saturating_sub(state.overscan);
+    let last = (((scroll + view) / height) as usize + 1 + state.overscan).min(count);
+    let needed = last.saturating_sub(first);
+
+    if needed > state.slots.len() {
+        // Growing changes the row-to-slot mapping
+        mark_stale(state);
+        while state.slots.len() < needed {
+            let row = create_row(obj, state);
+            if row.is_null() {
+                break;
+            }
+            state.slots.push(RowSlot {
+                obj: row,
+                row: UNBOUND,
+            });
+        }
+    }
+    let pool = state.slots.len();
+    if pool == 0 {
+        return;
+    }
+
+    for row in first..last {
+        let slot = &mut state.slots[row % pool];
+        if slot.row != row {
+            bind_row(slot, row, height, &state.source);
+        }
+    }
+    for slot in &mut state.slots {
+        if slot.row != UNBOUND && !(first..last).contains(&slot.row) {
+            neo_lvgl_sys::lv_obj_add_flag(slot.obj, neo_lvgl_sys::lv_obj_flag_t_LV_OBJ_FLAG_HIDDEN);
+            clear_row(slot.obj);
+            slot.row = UNBOUND;
+        }
+    }
+}
+
+unsafe fn create_row<S: RowSource>(
+    parent: *mut neo_lvgl_sys::lv_obj_t,
+    state: &State<S>,
+) -> *mut neo_lvgl_sys::lv_obj_t {
+    let row = neo_lvgl_sys::lv_obj_create(parent);
+    if row.is_null() {
+        return row;
+    }
+    neo_lvgl_sys::lv_obj_remove_style_all(row);
+    neo_lvgl_sys::lv_obj_set_size(row, pct(100), state.row_height);
+    neo_lvgl_sys::lv_obj_remove_flag(
+        row,
+        neo_lvgl_sys::lv_obj_flag_t_LV_OBJ_FLAG_SCROLLABLE
+            | neo_lvgl_sys::lv_obj_flag_t_LV_OBJ_FLAG_CLICK_FOCUSABLE,
+    );
+    neo_lvgl_sys::lv_obj_add_flag(
+        row,
+        neo_lvgl_sys::lv_obj_flag_t_LV_OBJ_FLAG_EVENT_BUBBLE
+            | neo_lvgl_sys::lv_obj_flag_t_LV_OBJ_FLAG_HIDDEN,
+    );
+
+    layout_row(row, &state.columns);
+    row
+}
+
+/// Position and width of each column within a row
+unsafe fn column_layout<S: RowSource>(
+    obj: *mut neo_lvgl_sys::lv_obj_t,
+    state: &State<S>,
+) -> Vec<(i32, i32)> {
+    let columns = state.source.column_count().max(1);
+    let total = neo_lvgl_sys::lv_obj_get_content_width(obj);
+    let fixed: i32 = state.column_widths.iter().take(columns).sum();
+    let flexible = (0..columns)
+        .filter(|&c| state.column_widths.get(c).copied().unwrap_or(0) == 0)
+        .count() as i32;
+    let share = if flexible > 0 {
+        (total - fixed).max(0) / flexible
+    } else {
+        0
+    };
+
+    let mut x = 0;
+    (0..columns)
+        .map(|col| {
+            let width = match state.column_widths.get(col) {
+                Some(&w) if w > 0 => w,
+                _ => share,
+            };
+            x += width;
+            (x - width, width)
+        })
+        .collect()
+}
+
+/// Give a row object one label per column and place the labels
+unsafe fn layout_row(row: *mut neo_lvgl_sys::lv_obj_t, columns: &[(i32, i32)]) {
+    let labels = neo_lvgl_sys::lv_obj_get_child_count(row) as usize;
+    for _ in labels..columns.len() {
+        let label = neo_lvgl_sys::lv_label_create(row);
+        if !label.is_null() {
+            neo_lvgl_sys::lv_label_set_long_mode(
+                label,
+                neo_lvgl_sys::lv_label_long_mode_t_LV_LABEL_LONG_MODE_CLIP,
+            );
+        }
+    }
+    for col in (columns.len()..labels).rev() {
+        neo_lvgl_sys::lv_obj_delete(neo_lvgl_sys::lv_obj_get_child(row, col as i32));
+    }
+    for (col, &(x, width)) in columns.iter().enumerate() {
+        let label = neo_lvgl_sys::lv_obj_get_child(row, col as i32);
+        if !label.is_null() {
+            neo_lvgl_sys::lv_obj_set_pos(label, x, 0);
+            neo_lvgl_sys::lv_obj_set_width(label, width);
+        }
+    }
+}
+
+unsafe fn bind_row<S: RowSource>(slot: &mut RowSlot, row: usize, height: i32, source: &S) {
+    slot.row = row;
+    neo_lvgl_sys::lv_obj_set_y(slot.obj, row as i32 * height);
+    // The pool is small, so finding the row's index is cheap
+    let index = neo_lvgl_sys::lv_obj_get_index(slot.obj) as usize;
+    crate::event::delegate_keys::set(neo_lvgl_sys::lv_obj_get_parent(slot.obj), index, row);
+    let labels = neo_lvgl_sys::lv_obj_get_child_count(slot.obj);
+    for col in 0..labels {
+        let label = neo_lvgl_sys::lv_obj_get_child(slot.obj, col as i32);
+        let text = source.cell(row, col as usize);
+        neo_lvgl_sys::lv_label_set_text_static(label, text.as_ptr());
+    }
+    neo_lvgl_sys::lv_obj_remove_flag(slot.obj, neo_lvgl_sys::lv_obj_flag_t_LV_OBJ_FLAG_HIDDEN);
+}
+
+/// Point the labels of a row at static text, so a row that is not bound
+/// keeps no reference into the source
+unsafe fn clear_row(row: *mut neo_lvgl_sys::lv_obj_t) {
+    let labels = neo_lvgl_sys::lv_obj_get_child_count(row);
+    for col in 0..labels {
+        let label = neo_lvgl_sys::lv_obj_get_child(row, col as i32);
+        neo_lvgl_sys::lv_label_set_text_static(label, c"".as_ptr());
+    }
+}
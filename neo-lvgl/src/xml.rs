@@ -29,12 +29,35 @@
 //!     (c"y", c"20"),
 //! ]).unwrap();
 //! ```
+//!
+//! # Precompiled components
+//!
+//! Parsing XML at boot costs time and keeps the parsed component trees on
+//! the heap. With the `assets` feature, [`include_ui!`](crate::include_ui)
+//! compiles a directory of components into static node tables instead:
+//! constants and `$props` are resolved at compile time, and [`create`],
+//! [`create_simple`] and [`create_screen`] build the widget tree from flash
+//! without running the parser.
+//!
+//! ```ignore
+//! static UI: &xml::CompiledUi = lvgl::include_ui!("ui", globals = "ui/globals.xml");
+//!
+//! xml::init();
+//! xml::register_compiled(UI).unwrap();
+//! for name in UI.fonts() {
+//!     // Register every font the components refer to
+//! }
+//! let obj = xml::create_simple(&screen, c"my_button").unwrap();
+//! ```
+//!
+//! Components with sections that need LVGL's own scope (`<styles>`,
+//! `<gradients>`, ...) and a `globals.xml` with more than `<consts>` are kept
+//! as XML and registered by [`register_compiled`].
 
 use crate::widgets::{Obj, Widget};
-use core::ffi::CStr;
-
-#[cfg(feature = "alloc")]
-use core::ffi::c_char;
+use core::ffi::{c_char, CStr};
+use core::ptr;
+use core::sync::atomic::{AtomicBool, AtomicPtr, Ordering};
 
 /// XML loading error
 #[derive(Clone, Copy, Debug, PartialEq, Eq)]
@@ -150,6 +173,9 @@ pub fn load_all_from_path(path: &CStr) -> Result<(), XmlError> {
 
 /// Create an instance of a registered XML component with attributes
 ///
+/// Components registered with [`register_compiled`] are built without
+/// the XML parser.
+///
 /// # Arguments
 ///
 /// * `parent` - The parent widget
@@ -188,13 +214,9 @@ pub fn create<'a>(
         attr_ptrs.push(core::ptr::null());
         attr_ptrs.push(core::ptr::null());
 
-        let ptr = neo_lvgl_sys::lv_xml_create(
-            parent.raw(),
-            name.as_ptr().cast(),
-            attr_ptrs.as_mut_ptr().cast(),
-        );
+        let ptr = create_raw(parent.raw(), name, attr_ptrs.as_mut_ptr());
 
-        Obj::from_raw(ptr as *mut neo_lvgl_sys::lv_obj_t)
+        Obj::from_raw(ptr)
     }
 }
 
@@ -208,8 +230,8 @@ pub fn create<'a>(
 /// * `name` - The name of the registered component
 pub fn create_simple<'a>(parent: &'a impl Widget<'a>, name: &CStr) -> Option<Obj<'a>> {
     unsafe {
-        let ptr = neo_lvgl_sys::lv_xml_create(parent.raw(), name.as_ptr().cast(), core::ptr::null_mut());
-        Obj::from_raw(ptr as *mut neo_lvgl_sys::lv_obj_t)
+        let ptr = create_raw(parent.raw(), name, ptr::null_mut());
+        Obj::from_raw(ptr)
     }
 }
 
@@ -222,7 +244,10 @@ pub fn create_simple<'a>(parent: &'a impl Widget<'a>, name: &CStr) -> Option<Obj
 /// * `name` - The name of the registered screen component
 pub fn create_screen(name: &CStr) -> Option<Obj<'static>> {
     unsafe {
-        let ptr = neo_lvgl_sys::lv_xml_create_screen(name.as_ptr().cast());
+        let ptr = match find_compiled(name) {
+            Some((ui, component)) => instantiate(ui, component, ptr::null_mut(), ptr::null()),
+            None => neo_lvgl_sys::lv_xml_create_screen(name.as_ptr().cast()),
+        };
         Obj::from_raw(ptr)
     }
 }
@@ -281,6 +306,262 @@ pub fn register_const(name: &CStr, value: &CStr) {
     }
 }
 
+// === Precompiled components ===
+
+/// Most attributes on one element of a compiled component, including the
+/// ones passed to [`create`]; creating an element with more fails
+#[doc(hidden)]
+pub const __MAX_ATTRS: usize = 24;
+
+/// Most `<api>` props of one compiled component
+#[doc(hidden)]
+pub const __MAX_PROPS: usize = 16;
+
+/// What a [`CompiledNode`] creates
+#[doc(hidden)]
+#[derive(Clone, Copy, Debug)]
+pub enum CompiledTag {
+    /// A widget (or a component registered at runtime), via `lv_xml_create`
+    Xml(&'static CStr),
+    /// A component of the same [`CompiledUi`], by index
+    Component(u16),
+}
+
+/// An attribute value of a [`CompiledNode`]
+#[doc(hidden)]
+#[derive(Clone, Copy, Debug)]
+pub enum CompiledValue {
+    /// Literal, with constants already substituted
+    Lit(&'static CStr),
+    /// `$prop` of the enclosing component, by index
+    Prop(u16),
+}
+
+/// One element of a compiled view, in preorder
+#[doc(hidden)]
+#[derive(Debug)]
+pub struct CompiledNode {
+    pub tag: CompiledTag,
+    pub attrs: &'static [(&'static CStr, CompiledValue)],
+    /// Index one past the last node of this element's subtree
+    pub end: u16,
+}
+
+/// A compiled component: `<api>` props and the `<view>` tree
+#[doc(hidden)]
+#[derive(Debug)]
+pub struct CompiledComponent {
+    pub name: &'static CStr,
+    /// Prop names with their default values
+    pub props: &'static [(&'static CStr, Option<&'static CStr>)],
+    /// Root first
+    pub nodes: &'static [CompiledNode],
+}
+
+/// A set of components compiled by [`include_ui!`](crate::include_ui)
+///
+/// Registered with [`register_compiled`]; lookups then go through a sorted
+/// name table and instantiation walks the static node arrays.
+pub struct CompiledUi {
+    components: &'static [CompiledComponent],
+    sources: &'static [(&'static CStr, &'static CStr)],
+    fonts: &'static [&'static CStr],
+    subjects: &'static [&'static CStr],
+    registered: AtomicBool,
+    next: AtomicPtr<CompiledUi>,
+}
+
+impl CompiledUi {
+    /// Used by [`include_ui!`](crate::include_ui); `components` must be
+    /// sorted by name
+    #[doc(hidden)]
+    pub const fn new(
+        components: &'static [CompiledComponent],
+        sources: &'static [(&'static CStr, &'static CStr)],
+        fonts: &'static [&'static CStr],
+        subjects: &'static [&'static CStr],
+    ) -> Self {
+        Self {
+            components,
+            sources,
+            fonts,
+            subjects,
+            registered: AtomicBool::new(false),
+            next: AtomicPtr::new(ptr::null_mut()),
+        }
+    }
+
+    /// Names of the compiled components
+    pub fn components(&self) -> impl Iterator<Item = &'static CStr> {
+        self.components.iter().map(|c| c.name)
+    }
+
+    /// Components kept as XML (registered through the parser)
+    pub fn sources(&self) -> impl Iterator<Item = &'static CStr> {
+        self.sources.iter().map(|(name, _)| *name)
+    }
+
+    /// Fonts referenced by name; register them with [`register_font`]
+    pub fn fonts(&self) -> &'static [&'static CStr] {
+        self.fonts
+    }
+
+    /// Subjects bound by name; register them with [`register_subject`]
+    pub fn subjects(&self) -> &'static [&'static CStr] {
+        self.subjects
+    }
+
+    fn find(&self, name: &CStr) -> Option<&'static CompiledComponent> {
+        let components = self.components;
+        let index = components.binary_search_by(|c| c.name.cmp(name)).ok()?;
+        Some(&components[index])
+    }
+}
+
+static COMPILED: AtomicPtr<CompiledUi> = AtomicPtr::new(ptr::null_mut());
+
+/// Make the components of `ui` available to [`create`]
+///
+/// Components that were kept as XML are registered with the parser here.
+/// Registering the same set again does nothing.
+pub fn register_compiled(ui: &'static CompiledUi) -> Result<(), XmlError> {
+    if ui.registered.swap(true, Ordering::AcqRel) {
+        return Ok(());
+    }
+    for (name, data) in ui.sources {
+        register_component_from_data(name, data)?;
+    }
+    let ui_ptr = ui as *const CompiledUi as *mut CompiledUi;
+    let mut head = COMPILED.load(Ordering::Acquire);
+    loop {
+        ui.next.store(head, Ordering::Relaxed);
+        match COMPILED.compare_exchange_weak(head, ui_ptr, Ordering::AcqRel, Ordering::Acquire) {
+            Ok(_) => return Ok(()),
+            Err(current) => head = current,
+        }
+    }
+}
+
+fn find_compiled(name: &CStr) -> Option<(&'static CompiledUi, &'static CompiledComponent)> {
+    let mut ui = COMPILED.load(Ordering::Acquire);
+    // SAFETY: only `&'static CompiledUi`s are linked into the list
+    while let Some(set) = unsafe { ui.as_ref() } {
+        if let Some(component) = set.find(name) {
+            return Some((set, component));
+        }
+        ui = set.next.load(Ordering::Acquire);
+    }
+    None
+}
+
+/// Create `name` from a compiled component if there is one, otherwise
+/// through `lv_xml_create`
+unsafe fn create_raw(
+    parent: *mut neo_lvgl_sys::lv_obj_t,
+    name: &CStr,
+    attrs: *mut *const c_char,
+) -> *mut neo_lvgl_sys::lv_obj_t {
+    match find_compiled(name) {
+        Some((ui, component)) => instantiate(ui, component, parent, attrs),
+        None => neo_lvgl_sys::lv_xml_create(parent, name.as_ptr().cast(), attrs.cast()).cast(),
+    }
+}
+
+/// Bind `args` (NULL-terminated name/value pairs) to the props of
+/// `component` and build its view; other arguments go to the root element
+///
+/// Returns null, creating nothing, if the root element would get more than
+/// [`__MAX_ATTRS`] attributes.
+unsafe fn instantiate(
+    ui: &'static CompiledUi,
+    component: &'static CompiledComponent,
+    parent: *mut neo_lvgl_sys::lv_obj_t,
+    args: *const *const c_char,
+) -> *mut neo_lvgl_sys::lv_obj_t {
+    let mut env = [ptr::null(); __MAX_PROPS];
+    for (slot, (_, default)) in env.iter_mut().zip(component.props) {
+        *slot = default.map_or(ptr::null(), CStr::as_ptr);
+    }
+
+    let mut extra = [ptr::null(); 2 * __MAX_ATTRS];
+    let mut extra_len = 0;
+    let mut arg = args;
+    while !arg.is_null() && !(*arg).is_null() {
+        let (key, value) = (*arg, *arg.add(1));
+        let key_str = CStr::from_ptr(key);
+        match component.props.iter().position(|(name, _)| *name == key_str) {
+            Some(index) => env[index] = value,
+            None if extra_len < extra.len() => {
+                extra[extra_len] = key;
+                extra[extra_len + 1] = value;
+                extra_len += 2;
+            }
+            None => return ptr::null_mut(),
+        }
+        arg = arg.add(2);
+    }
+
+    let mut next = 0;
+    build(ui, component, &env, &mut next, parent, &extra[..extra_len])
+}
+
+/// Create the node at `*next` under `parent`, then its subtree
+unsafe fn build(
+    ui: &'static CompiledUi,
+    component: &'static CompiledComponent,
+    env: &[*const c_char; __MAX_PROPS],
+    next: &mut usize,
+    parent: *mut neo_lvgl_sys::lv_obj_t,
+    extra: &[*const c_char],
+) -> *mut neo_lvgl_sys::lv_obj_t {
+    let node = &component.nodes[*next];
+    *next += 1;
+
+    // Name/value pairs plus the NULL, NULL terminator
+    let mut attrs = [ptr::null(); 2 * __MAX_ATTRS + 2];
+    let mut len = 0;
+    let values = node.attrs.iter().map(|(name, value)| {
+        let value = match *value {
+            CompiledValue::Lit(lit) => lit.as_ptr(),
+            CompiledValue::Prop(index) => env[index as usize],
+        };
+        (name.as_ptr(), value)
+    });
+    let extra = extra.chunks_exact(2).map(|pair| (pair[0], pair[1]));
+    for (name, value) in values.chain(extra) {
+        // Props without a value or default leave the attribute unset
+        if value.is_null() {
+            continue;
+        }
+        if len == 2 * __MAX_ATTRS {
+            // Failing is better than a widget missing attributes
+            *next = node.end as usize;
+            return ptr::null_mut();
+        }
+        attrs[len] = name;
+        attrs[len + 1] = value;
+        len += 2;
+    }
+
+    let item = match node.tag {
+        CompiledTag::Xml(tag) => {
+            neo_lvgl_sys::lv_xml_create(parent, tag.as_ptr().cast(), attrs.as_mut_ptr().cast()).cast()
+        }
+        CompiledTag::Component(index) => {
+            instantiate(ui, &ui.components[index as usize], parent, attrs.as_ptr())
+        }
+    };
+
+    let end = node.end as usize;
+    if item.is_null() {
+        *next = end;
+    }
+    while *next < end {
+        build(ui, component, env, next, item, &[]);
+    }
+    item
+}
+
 // === Widget name support ===
 
 /// Extension trait for widget naming (used by XML)